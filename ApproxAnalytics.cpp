@@ -0,0 +1,301 @@
+#include "ApproxAnalytics.h"
+#include "CrimeModule.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+using namespace std;
+
+static uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t sketchHash(const string& key, uint64_t seed) {
+    uint64_t h = 1469598103934665603ULL ^ seed;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return mix64(h);
+}
+
+// ------------------------ COUNT-MIN SKETCH ------------------------
+CountMinSketch::CountMinSketch(size_t w, size_t d, size_t topK)
+    : width(w > 0 ? w : 1), depth(d > 0 ? d : 1), table(width * depth, 0),
+      totalCount(0), maxCandidates(topK) {}
+
+void CountMinSketch::add(const string& key, int64_t count) {
+    // Two hashes combined give the d row indexes (Kirsch-Mitzenmacher)
+    uint64_t h1 = sketchHash(key);
+    uint64_t h2 = mix64(h1) | 1;
+    for (size_t row = 0; row < depth; row++) {
+        uint32_t& cell = table[row * width + (h1 + row * h2) % width];
+        if (count < 0 && cell < static_cast<uint32_t>(-count)) cell = 0;
+        else cell = static_cast<uint32_t>(cell + count);
+    }
+    if (count < 0 && totalCount < static_cast<uint64_t>(-count)) totalCount = 0;
+    else totalCount += count;
+
+    if (maxCandidates == 0) return;
+    uint64_t est = estimate(key);
+    auto it = candidates.find(key);
+    if (it != candidates.end()) {
+        it->second = est;
+        if (est == 0) candidates.erase(it);
+        return;
+    }
+    if (est == 0) return;
+    if (candidates.size() < maxCandidates) {
+        candidates[key] = est;
+        return;
+    }
+    auto minIt = candidates.begin();
+    for (auto c = candidates.begin(); c != candidates.end(); ++c) {
+        if (c->second < minIt->second) minIt = c;
+    }
+    if (est > minIt->second) {
+        candidates.erase(minIt);
+        candidates[key] = est;
+    }
+}
+
+uint64_t CountMinSketch::estimate(const string& key) const {
+    uint64_t h1 = sketchHash(key);
+    uint64_t h2 = mix64(h1) | 1;
+    uint64_t best = numeric_limits<uint64_t>::max();
+    for (size_t row = 0; row < depth; row++) {
+        best = min<uint64_t>(best, table[row * width + (h1 + row * h2) % width]);
+    }
+    return best;
+}
+
+double CountMinSketch::getErrorBound() const {
+    return exp(1.0) / width * totalCount;
+}
+
+vector<pair<string, uint64_t>> CountMinSketch::heavyHitters(size_t k) const {
+    vector<pair<string, uint64_t>> result;
+    for (const auto& c : candidates) {
+        result.push_back(make_pair(c.first, estimate(c.first)));
+    }
+    sort(result.begin(), result.end(),
+        [](const pair<string, uint64_t>& a, const pair<string, uint64_t>& b) { return a.second > b.second; });
+    if (result.size() > k) result.resize(k);
+    return result;
+}
+
+void CountMinSketch::clear() {
+    fill(table.begin(), table.end(), 0);
+    totalCount = 0;
+    candidates.clear();
+}
+
+// ------------------------ HYPERLOGLOG ------------------------
+HyperLogLog::HyperLogLog(int p) : precision(max(4, min(p, 18))), registers(static_cast<size_t>(1) << precision, 0) {}
+
+void HyperLogLog::add(const string& key) {
+    uint64_t h = sketchHash(key, 0x5bd1e995ULL);
+    size_t index = h >> (64 - precision);
+    uint64_t rest = (h << precision) | (static_cast<uint64_t>(1) << (precision - 1));
+    uint8_t rank = 1;
+    while ((rest & 0x8000000000000000ULL) == 0) {
+        rank++;
+        rest <<= 1;
+    }
+    if (rank > registers[index]) registers[index] = rank;
+}
+
+double HyperLogLog::estimate() const {
+    double m = static_cast<double>(registers.size());
+    double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t r : registers) {
+        sum += ldexp(1.0, -r);
+        if (r == 0) zeros++;
+    }
+    double raw = alpha * m * m / sum;
+    // Small cardinalities: linear counting is much more accurate
+    if (raw <= 2.5 * m && zeros > 0) {
+        return m * log(m / zeros);
+    }
+    return raw;
+}
+
+double HyperLogLog::getStandardError() const {
+    return 1.04 / sqrt(static_cast<double>(registers.size()));
+}
+
+void HyperLogLog::clear() {
+    fill(registers.begin(), registers.end(), 0);
+}
+
+// ------------------------ T-DIGEST ------------------------
+TDigest::TDigest(double c)
+    : compression(c > 10 ? c : 10), totalWeight(0.0),
+      minValue(numeric_limits<double>::max()), maxValue(-numeric_limits<double>::max()) {}
+
+void TDigest::add(double value) {
+    buffer.push_back(value);
+    minValue = min(minValue, value);
+    maxValue = max(maxValue, value);
+    if (buffer.size() >= static_cast<size_t>(compression * 5)) compress();
+}
+
+// Merge the buffer into the centroids using the arcsine scale function
+// k(q) = compression / 2pi * asin(2q - 1): a centroid may span at most one unit
+// of k, which keeps tail centroids tiny and caps the total near `compression`.
+static double scaleK(double q, double compression) {
+    q = min(1.0, max(0.0, q));
+    return compression / (2.0 * 3.14159265358979323846) * asin(2.0 * q - 1.0);
+}
+
+void TDigest::compress() {
+    if (buffer.empty()) return;
+
+    vector<Centroid> all;
+    all.reserve(centroids.size() + buffer.size());
+    all.insert(all.end(), centroids.begin(), centroids.end());
+    for (double v : buffer) {
+        Centroid c;
+        c.mean = v;
+        c.weight = 1.0;
+        all.push_back(c);
+    }
+    totalWeight += buffer.size();
+    buffer.clear();
+    sort(all.begin(), all.end(), [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+    vector<Centroid> merged;
+    merged.reserve(static_cast<size_t>(compression) + 1);
+    Centroid current = all[0];
+    double weightSoFar = 0.0;
+    double kLeft = scaleK(0.0, compression);
+    for (size_t i = 1; i < all.size(); i++) {
+        double proposed = current.weight + all[i].weight;
+        double qRight = (weightSoFar + proposed) / totalWeight;
+        if (scaleK(qRight, compression) - kLeft <= 1.0) {
+            current.mean += (all[i].mean - current.mean) * all[i].weight / proposed;
+            current.weight = proposed;
+        } else {
+            weightSoFar += current.weight;
+            kLeft = scaleK(weightSoFar / totalWeight, compression);
+            merged.push_back(current);
+            current = all[i];
+        }
+    }
+    merged.push_back(current);
+    centroids.swap(merged);
+}
+
+double TDigest::quantile(double q) {
+    compress();
+    if (centroids.empty()) return 0.0;
+    if (q <= 0.0) return minValue;
+    if (q >= 1.0) return maxValue;
+    if (centroids.size() == 1) return centroids[0].mean;
+
+    // Interpolate between centroid midpoints
+    double target = q * totalWeight;
+    double cumulative = 0.0;
+    for (size_t i = 0; i < centroids.size(); i++) {
+        double mid = cumulative + centroids[i].weight / 2.0;
+        if (target < mid) {
+            if (i == 0) {
+                double t = target / mid;
+                return minValue + t * (centroids[0].mean - minValue);
+            }
+            double prevMid = cumulative - centroids[i - 1].weight / 2.0;
+            double t = (target - prevMid) / (mid - prevMid);
+            return centroids[i - 1].mean + t * (centroids[i].mean - centroids[i - 1].mean);
+        }
+        cumulative += centroids[i].weight;
+    }
+    double lastMid = totalWeight - centroids.back().weight / 2.0;
+    double t = (target - lastMid) / (totalWeight - lastMid);
+    return centroids.back().mean + t * (maxValue - centroids.back().mean);
+}
+
+void TDigest::clear() {
+    centroids.clear();
+    buffer.clear();
+    totalWeight = 0.0;
+    minValue = numeric_limits<double>::max();
+    maxValue = -numeric_limits<double>::max();
+}
+
+// ------------------------ CRIME SKETCHES ------------------------
+void CrimeSketches::addCase(const Case* c) {
+    if (!c) return;
+    casesSeen++;
+    if (c->getLocation() && !c->getLocation()->getCity().empty()) {
+        cityCounts.add(c->getLocation()->getCity());
+    }
+    if (!c->getReportedBy().empty()) {
+        reporters.add(c->getReportedBy());
+    }
+    if (const Theft* theft = dynamic_cast<const Theft*>(c)) {
+        if (!theft->getItemStolen().empty()) itemsStolen.add(theft->getItemStolen());
+        stolenValues.add(theft->getStolenValue());
+    } else if (const Vandalism* vandalism = dynamic_cast<const Vandalism*>(c)) {
+        damageValues.add(vandalism->getDamageValue());
+    }
+}
+
+void CrimeSketches::clear() {
+    cityCounts.clear();
+    itemsStolen.clear();
+    reporters.clear();
+    stolenValues.clear();
+    damageValues.clear();
+    casesSeen = 0;
+}
+
+static void printHeavyHitters(ostream& os, const CountMinSketch& sketch, size_t topK) {
+    vector<pair<string, uint64_t>> top = sketch.heavyHitters(topK);
+    if (top.empty()) {
+        os << "  (no data)\n";
+        return;
+    }
+    for (const auto& entry : top) {
+        os << "  " << entry.first << ": ~" << entry.second << "\n";
+    }
+    os << "  (estimates may overcount by up to " << static_cast<uint64_t>(ceil(sketch.getErrorBound()))
+       << " with 99% confidence)\n";
+}
+
+static void printQuantiles(ostream& os, TDigest& digest) {
+    if (digest.getCount() == 0) {
+        os << "  (no data)\n";
+        return;
+    }
+    os << "  p50: $" << digest.quantile(0.5)
+       << " | p90: $" << digest.quantile(0.9)
+       << " | p99: $" << digest.quantile(0.99)
+       << " (" << static_cast<uint64_t>(digest.getCount()) << " values, "
+       << digest.getCentroidCount() << " centroids)\n";
+}
+
+void CrimeSketches::print(ostream& os, size_t topK) {
+    os << "\n===== APPROXIMATE CRIME STATISTICS =====\n";
+    os << "Cases sketched: " << casesSeen << "\n";
+
+    os << "\nTop cities:\n";
+    printHeavyHitters(os, cityCounts, topK);
+
+    os << "\nMost stolen items:\n";
+    printHeavyHitters(os, itemsStolen, topK);
+
+    os << "\nDistinct reporters: ~" << static_cast<uint64_t>(reporters.estimate() + 0.5)
+       << " (+/- " << reporters.getStandardError() * 100.0 << "% std. error)\n";
+
+    os << "\nStolen value quantiles:\n";
+    printQuantiles(os, stolenValues);
+    os << "\nDamage value quantiles:\n";
+    printQuantiles(os, damageValues);
+
+    os << "\nNote: sketches only see added cases; edits and deletions show up after a rebuild (crime menu option 18).\n";
+    os << "========================================\n";
+}
@@ -0,0 +1,269 @@
+#include "BatchMode.h"
+#include "OfficerModule.h"
+#include "CrimeModule.h"
+#include "ForensicsModule.h"
+#include "PatrolVehiclesModule.h"
+#include "JailModule.h"
+#include "PersistenceCoordinator.h"
+#include "NullStream.h"
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <chrono>
+#include <iomanip>
+using namespace std;
+
+// One batch operation; throws with a message when it can't be applied
+typedef function<void(const json&)> BatchOp;
+
+static void registerOfficerOps(map<string, BatchOp>& ops) {
+    ops["add_officer"] = [](const json& j) {
+        Officer* officer = Officer::create(j.at("role").get<string>(), j.at("name").get<string>());
+        if (!officer) throw runtime_error("role must be SHO, CO, Prosecutor, Head Constable or Constable");
+        OfficerRegistry::getInstance()->getManager().addOfficer(officer);
+    };
+    ops["add_officer_task"] = [](const json& j) {
+        OfficerManager& officers = OfficerRegistry::getInstance()->getManager();
+        string task = j.at("task").get<string>();
+        if (!officers.updateOfficer(j.at("officerId").get<int>(), [&task](Officer& o) { o.addTask(task); })) {
+            throw runtime_error("officer not found");
+        }
+        officers.getState().markDirty();
+    };
+}
+
+static void registerCaseOps(map<string, BatchOp>& ops) {
+    ops["add_case"] = [](const json& j) {
+        // Prosecutor links are resolved once per group, not per case
+        if (!CrimeRegistry::getInstance()->getManager().addCaseFromJson(j)) {
+            throw runtime_error("a case with that ID already exists");
+        }
+    };
+    ops["delete_case"] = [](const json& j) {
+        if (!CrimeRegistry::getInstance()->getManager().deleteCase(j.at("id").get<int>())) {
+            throw runtime_error("case not found");
+        }
+    };
+    ops["add_evidence"] = [](const json& j) {
+        if (!ForensicLabRegistry::getInstance()->getLab().assignEvidence(
+                j.at("techId").get<int>(), j.at("caseId").get<int>(), j.at("description").get<string>())) {
+            throw runtime_error("case or lab technician not found");
+        }
+    };
+    ops["evidence_processed"] = [](const json& j) {
+        ForensicLab& lab = ForensicLabRegistry::getInstance()->getLab();
+        Evidence ev;
+        if (!lab.findEvidence(j.at("id").get<int>(), ev)) throw runtime_error("evidence not found");
+        if (j.contains("findings")) {
+            ev.addFinding(j["findings"].get<string>());
+        }
+        ev.markProcessed();
+        lab.applyAnalysisResult(ev);
+    };
+}
+
+static void registerFleetOps(map<string, BatchOp>& ops) {
+    ops["add_vehicle"] = [](const json& j) {
+        string type = j.value("type", "");
+        Vehicle* v = nullptr;
+        if (type == "Car") v = new Car();
+        else if (type == "Bike") v = new Bike();
+        else throw runtime_error("type must be Car or Bike");
+        json fields = j;
+        fields.erase("op");
+        fields["vehicleId"] = v->getId();  // New vehicles always get the next ID
+        v->fromJson(fields);
+        FleetRegistry::getInstance()->getFleet().addVehicle(*v);
+        delete v;
+    };
+    ops["vehicle_status"] = [](const json& j) {
+        if (!FleetRegistry::getInstance()->getFleet().updateVehicleStatus(j.at("id").get<int>(), j.at("status").get<string>())) {
+            throw runtime_error("vehicle not found");
+        }
+    };
+    ops["create_patrol"] = [](const json& j) {
+        vector<Constable> available = OfficerRegistry::getInstance()->getManager().getAvailableConstables();
+        vector<Constable> selected;
+        for (const auto& id : j.at("constableIds")) {
+            bool found = false;
+            for (const auto& c : available) {
+                if (c.getId() == id.get<int>()) {
+                    selected.push_back(c);
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) throw runtime_error("constable " + id.dump() + " is unknown or already on patrol");
+        }
+        if (selected.empty()) throw runtime_error("a patrol needs at least one constable");
+        if (startPatrol(j.at("vehicleId").get<int>(), j.at("area").get<string>(), selected).empty()) {
+            throw runtime_error("vehicle not found or not available");
+        }
+    };
+    ops["patrol_log"] = [](const json& j) {
+        if (!FleetRegistry::getInstance()->getFleet().addPatrolLog(j.at("patrolId").get<string>(), j.at("entry").get<string>())) {
+            throw runtime_error("patrol not found");
+        }
+    };
+    ops["end_patrol"] = [](const json& j) {
+        if (!FleetRegistry::getInstance()->getFleet().endPatrol(j.at("patrolId").get<string>())) {
+            throw runtime_error("patrol not found");
+        }
+    };
+}
+
+// "facility": "<name>" picks a facility for cell-level ops; the first one by default
+static Jail& facilityOf(const json& j) {
+    JailRegistry* jails = JailRegistry::getInstance();
+    if (!j.contains("facility")) return jails->getJail();
+    int facility = jails->findFacility(j["facility"].get<string>());
+    if (facility < 0) throw runtime_error("facility not found");
+    return jails->getJail(facility);
+}
+
+static void registerJailOps(map<string, BatchOp>& ops) {
+    ops["add_prisoner"] = [](const json& j) {
+        Jail& jail = facilityOf(j);
+        Prisoner prisoner(j.at("id").get<int>(), j.at("name").get<string>(),
+                          j.at("crime").get<string>(), j.at("sentenceYears").get<int>());
+        prisoner.setDates(dayFromDate(j.value("intakeDate", "")), dayFromDate(j.value("releaseDate", "")));
+        prisoner.setCaseIds(j.value("caseIds", vector<int>()));
+        for (int caseId : prisoner.getCaseIds()) {
+            if (!CrimeRegistry::getInstance()->getManager().hasCase(caseId)) {
+                throw runtime_error("case " + to_string(caseId) + " not found");
+            }
+        }
+        if (!jail.addPrisoner(prisoner)) throw runtime_error("a prisoner with that ID already exists");
+        if (j.contains("cellId") && !jail.assignPrisonerToCell(prisoner.getId(), j["cellId"].get<int>())) {
+            throw runtime_error("added, but the cell is full or doesn't exist");
+        }
+    };
+    ops["move_prisoner"] = [](const json& j) {
+        if (!JailRegistry::getInstance()->changePrisonerCell(j.at("id").get<int>(), j.at("cellId").get<int>())) {
+            throw runtime_error("prisoner not found, or the cell is full or doesn't exist");
+        }
+    };
+    ops["remove_prisoner"] = [](const json& j) {
+        if (!JailRegistry::getInstance()->removePrisoner(j.at("id").get<int>())) {
+            throw runtime_error("prisoner not found");
+        }
+    };
+    ops["process_releases"] = [](const json& j) {
+        int today = j.contains("date") ? dayFromDate(j["date"].get<string>()) : currentDay();
+        if (today == NO_DAY) throw runtime_error("date must be YYYY-MM-DD");
+        JailRegistry::getInstance()->processReleases(today);
+    };
+    ops["transfer_prisoner"] = [](const json& j) {
+        JailRegistry* jails = JailRegistry::getInstance();
+        int to = jails->findFacility(j.at("facility").get<string>());
+        if (to < 0) throw runtime_error("facility not found");
+        if (!jails->transferPrisoner(j.at("id").get<int>(), to, j.value("cellId", -1))) {
+            throw runtime_error("prisoner not found or already there, or the cell is full or doesn't exist");
+        }
+    };
+    ops["link_case"] = [](const json& j) {
+        if (!JailRegistry::getInstance()->linkCase(j.at("prisonerId").get<int>(), j.at("caseId").get<int>())) {
+            throw runtime_error("prisoner or case not found, or already linked");
+        }
+    };
+    ops["unlink_case"] = [](const json& j) {
+        if (!JailRegistry::getInstance()->unlinkCase(j.at("prisonerId").get<int>(), j.at("caseId").get<int>())) {
+            throw runtime_error("prisoner not linked to that case");
+        }
+    };
+    ops["assign_cell_officer"] = [](const json& j) {
+        if (!facilityOf(j).assignOfficerToCell(j.at("officerId").get<int>(), j.at("cellId").get<int>())) {
+            throw runtime_error("cell or officer not found, or the officer is not a CO");
+        }
+    };
+}
+
+// Links new cases to their prosecutors and queues changed modules for the flusher
+static void finishGroup(BatchResult& result) {
+    CrimeRegistry::getInstance()->getManager().resolveProsecutors();
+    persistChanges();
+    result.saves++;
+}
+
+BatchResult runBatch(istream& in, size_t groupSize) {
+    map<string, BatchOp> ops;
+    registerOfficerOps(ops);
+    registerCaseOps(ops);
+    registerFleetOps(ops);
+    registerJailOps(ops);
+
+    BatchResult result;
+    NullBuffer sink;
+    streambuf* console = cout.rdbuf(&sink);
+    auto start = chrono::steady_clock::now();
+
+    string line;
+    size_t lineNumber = 0;
+    size_t inGroup = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#') continue;
+        result.lines++;
+        try {
+            json j = json::parse(line);
+            string op = j.at("op").get<string>();
+            auto it = ops.find(op);
+            if (it == ops.end()) throw runtime_error("unknown op \"" + op + "\"");
+            it->second(j);
+            result.succeeded++;
+            result.perOp[op]++;
+        } catch (const exception& e) {
+            result.failed++;
+            result.errors.push_back("Line " + to_string(lineNumber) + ": " + e.what());
+        }
+        if (++inGroup >= groupSize) {
+            finishGroup(result);
+            inGroup = 0;
+        }
+    }
+    if (inGroup > 0) {
+        finishGroup(result);
+    }
+
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.rdbuf(console);
+    return result;
+}
+
+void printBatchResult(const BatchResult& result, ostream& os, size_t maxErrors) {
+    for (size_t i = 0; i < result.errors.size() && i < maxErrors; i++) {
+        os << result.errors[i] << "\n";
+    }
+    if (result.errors.size() > maxErrors) {
+        os << "... and " << result.errors.size() - maxErrors << " more failed line(s)\n";
+    }
+    os << "\n=== Batch Summary ===\n";
+    os << "Operations:  " << result.lines << " (" << result.succeeded << " succeeded, " << result.failed << " failed)\n";
+    for (const auto& pair : result.perOp) {
+        os << "  " << left << setw(20) << pair.first << right << pair.second << "\n";
+    }
+    os << "Saves:       " << result.saves << " (changed modules queued once per group)\n";
+    os << fixed << setprecision(3);
+    os << "Time:        " << result.seconds << " s\n";
+    os << setprecision(0);
+    os << "Throughput:  " << (result.seconds > 0 ? result.lines / result.seconds : 0.0) << " ops/s\n";
+    os.unsetf(ios::floatfield);
+}
+
+int runBatchMode(const string& filename, size_t groupSize) {
+    ifstream file;
+    if (filename != "-") {
+        file.open(filename);
+        if (!file.is_open()) {
+            cout << "Error: cannot open batch file " << filename << endl;
+            return 1;
+        }
+    }
+    istream& in = filename == "-" ? cin : file;
+    cout << "\nBatch: running " << (filename == "-" ? string("stdin") : filename)
+         << ", saving every " << groupSize << " operation(s)\n";
+    BatchResult result = runBatch(in, groupSize);
+    printBatchResult(result, cout);
+    return result.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <map>
+#include <vector>
+#include <iostream>
+using namespace std;
+
+struct BatchResult {
+    size_t lines;      // Non-blank, non-comment lines read
+    size_t succeeded;
+    size_t failed;
+    size_t saves;      // Times changed modules were queued for the flusher
+    double seconds;
+    map<string, size_t> perOp;  // Successful operations by name
+    vector<string> errors;      // "Line N: message" for each failed line
+
+    BatchResult() : lines(0), succeeded(0), failed(0), saves(0), seconds(0.0) {}
+};
+
+// Runs one JSON object per line against the managers, without the menus:
+//   {"op": "add_officer", "name": "...", "role": "Constable"}
+//   {"op": "add_officer_task", "officerId": 3, "task": "..."}
+//   {"op": "add_case", ...crimes.json entry...}       {"op": "delete_case", "id": 7}
+//   {"op": "add_evidence", "techId": 1, "caseId": 7, "description": "..."}
+//   {"op": "evidence_processed", "id": 2[, "findings": "..."]}
+//   {"op": "add_vehicle", "type": "Car", "model": "...", ...vehicles.json fields...}
+//   {"op": "vehicle_status", "id": 1, "status": "Available"}
+//   {"op": "create_patrol", "vehicleId": 1, "area": "...", "constableIds": [4, 5]}
+//   {"op": "patrol_log", "patrolId": "P1", "entry": "..."}  {"op": "end_patrol", "patrolId": "P1"}
+//   {"op": "add_prisoner", "id": 9, "name": "...", "crime": "...", "sentenceYears": 2[, "facility": "North", "cellId": 3,
+//    "intakeDate": "2024-01-31", "releaseDate": "2026-01-31", "caseIds": [7]]}  (intake defaults to today, release to intake + sentence, none if sentenceYears is 0)
+//   {"op": "move_prisoner", "id": 9, "cellId": 4}       {"op": "remove_prisoner", "id": 9}  (wherever the prisoner is held)
+//   {"op": "process_releases"[, "date": "2026-01-31"]}  releases everyone due by then (default today), in every facility
+//   {"op": "transfer_prisoner", "id": 9, "facility": "North"[, "cellId": 2]}
+//   {"op": "link_case", "prisonerId": 9, "caseId": 7}   {"op": "unlink_case", "prisonerId": 9, "caseId": 7}
+//   {"op": "assign_cell_officer", "cellId": 3, "officerId": 1[, "facility": "North"]}
+// "facility" names where a new prisoner or a cell is; the first facility if left out.
+// Blank lines and lines starting with # are skipped. A failing line is
+// recorded with its line number and the rest still run. Changed modules are
+// handed to the flusher once every `groupSize` operations instead of after
+// each one.
+BatchResult runBatch(istream& in, size_t groupSize);
+void printBatchResult(const BatchResult& result, ostream& os, size_t maxErrors = 20);
+
+int runBatchMode(const string& filename, size_t groupSize);  // "-" reads stdin
@@ -0,0 +1,321 @@
+#include "CaseColumnStore.h"
+#include "CrimeModule.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+int32_t CaseColumnStore::tagFor(const string& type) {
+    if (type == "Theft") return TAG_THEFT;
+    if (type == "Assault") return TAG_ASSAULT;
+    if (type == "Vandalism") return TAG_VANDALISM;
+    return TAG_OTHER;
+}
+
+const char* CaseColumnStore::simdLevel() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+int32_t CaseColumnStore::internCity(const string& city) {
+    auto it = cityLookup.find(city);
+    if (it != cityLookup.end()) return it->second;
+    int32_t code = static_cast<int32_t>(cityDictionary.size());
+    cityDictionary.push_back(city);
+    cityLookup[city] = code;
+    return code;
+}
+
+int32_t CaseColumnStore::cityCode(const string& city) const {
+    auto it = cityLookup.find(city);
+    return it != cityLookup.end() ? it->second : -1;
+}
+
+void CaseColumnStore::upsert(Case* c) {
+    if (!c) return;
+
+    int32_t tag = tagFor(c->getType());
+    double value = 0.0;
+    if (tag == TAG_THEFT) {
+        if (Theft* theft = dynamic_cast<Theft*>(c)) value = theft->getStolenValue();
+    } else if (tag == TAG_VANDALISM) {
+        if (Vandalism* vandalism = dynamic_cast<Vandalism*>(c)) value = vandalism->getDamageValue();
+    }
+    int32_t city = c->getLocation() ? internCity(c->getLocation()->getCity()) : -1;
+
+    auto it = rowOf.find(c->getId());
+    if (it != rowOf.end()) {
+        size_t row = it->second;
+        typeTags[row] = tag;
+        severities[row] = c->getSeverity();
+        priorities[row] = c->getPriority();
+        values[row] = value;
+        cityCodes[row] = city;
+        rowCases[row] = c;
+        return;
+    }
+
+    rowOf[c->getId()] = ids.size();
+    ids.push_back(c->getId());
+    typeTags.push_back(tag);
+    severities.push_back(c->getSeverity());
+    priorities.push_back(c->getPriority());
+    values.push_back(value);
+    cityCodes.push_back(city);
+    rowCases.push_back(c);
+}
+
+void CaseColumnStore::remove(int caseId) {
+    auto it = rowOf.find(caseId);
+    if (it == rowOf.end()) return;
+    size_t row = it->second;
+    size_t last = ids.size() - 1;
+    if (row != last) {
+        ids[row] = ids[last];
+        typeTags[row] = typeTags[last];
+        severities[row] = severities[last];
+        priorities[row] = priorities[last];
+        values[row] = values[last];
+        cityCodes[row] = cityCodes[last];
+        rowCases[row] = rowCases[last];
+        rowOf[ids[row]] = row;
+    }
+    ids.pop_back();
+    typeTags.pop_back();
+    severities.pop_back();
+    priorities.pop_back();
+    values.pop_back();
+    cityCodes.pop_back();
+    rowCases.pop_back();
+    rowOf.erase(it);
+}
+
+void CaseColumnStore::clear() {
+    ids.clear();
+    typeTags.clear();
+    severities.clear();
+    priorities.clear();
+    values.clear();
+    cityCodes.clear();
+    rowCases.clear();
+    cityDictionary.clear();
+    cityLookup.clear();
+    rowOf.clear();
+}
+
+void CaseColumnStore::reserve(size_t n) {
+    ids.reserve(n);
+    typeTags.reserve(n);
+    severities.reserve(n);
+    priorities.reserve(n);
+    values.reserve(n);
+    cityCodes.reserve(n);
+    rowCases.reserve(n);
+    rowOf.reserve(n);
+}
+
+// Row numbers where column[row] == key
+static vector<size_t> filterEqual(const vector<int32_t>& column, int32_t key) {
+    vector<size_t> rows;
+    const int32_t* data = column.data();
+    size_t n = column.size();
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i needle = _mm256_set1_epi32(key);
+    for (; i + 8 <= n; i += 8) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, needle)));
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            rows.push_back(i + bit);
+            mask &= mask - 1;
+        }
+    }
+#elif defined(__SSE2__)
+    __m128i needle = _mm_set1_epi32(key);
+    for (; i + 4 <= n; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            rows.push_back(i + bit);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (data[i] == key) rows.push_back(i);
+    }
+    return rows;
+}
+
+vector<size_t> CaseColumnStore::filterByType(int32_t tag) const {
+    return filterEqual(typeTags, tag);
+}
+
+vector<size_t> CaseColumnStore::filterByCity(int32_t code) const {
+    if (code < 0) return vector<size_t>();
+    return filterEqual(cityCodes, code);
+}
+
+size_t CaseColumnStore::countPriorityAbove(double threshold) const {
+    const double* data = priorities.data();
+    size_t n = priorities.size();
+    size_t i = 0;
+    size_t count = 0;
+#if defined(__AVX2__)
+    __m256d limit = _mm256_set1_pd(threshold);
+    for (; i + 4 <= n; i += 4) {
+        __m256d block = _mm256_loadu_pd(data + i);
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(block, limit, _CMP_GT_OQ)));
+    }
+#elif defined(__SSE2__)
+    __m128d limit = _mm_set1_pd(threshold);
+    for (; i + 2 <= n; i += 2) {
+        __m128d block = _mm_loadu_pd(data + i);
+        count += __builtin_popcount(_mm_movemask_pd(_mm_cmpgt_pd(block, limit)));
+    }
+#endif
+    for (; i < n; i++) {
+        if (data[i] > threshold) count++;
+    }
+    return count;
+}
+
+double CaseColumnStore::sumValueByType(int32_t tag) const {
+    const double* vals = values.data();
+    const int32_t* tags = typeTags.data();
+    size_t n = values.size();
+    size_t i = 0;
+    double total = 0.0;
+#if defined(__AVX2__)
+    __m256d acc = _mm256_setzero_pd();
+    __m128i needle = _mm_set1_epi32(tag);
+    for (; i + 4 <= n; i += 4) {
+        __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags + i));
+        __m256i wide = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(t, needle));
+        acc = _mm256_add_pd(acc, _mm256_and_pd(_mm256_loadu_pd(vals + i), _mm256_castsi256_pd(wide)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__)
+    __m128d acc = _mm_setzero_pd();
+    __m128i needle = _mm_set1_epi32(tag);
+    for (; i + 2 <= n; i += 2) {
+        // Widen two int32 compare results into two 64-bit lane masks
+        __m128i t = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tags + i));
+        __m128i eq = _mm_cmpeq_epi32(t, needle);
+        __m128i wide = _mm_unpacklo_epi32(eq, eq);
+        acc = _mm_add_pd(acc, _mm_and_pd(_mm_loadu_pd(vals + i), _mm_castsi128_pd(wide)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) {
+        if (tags[i] == tag) total += vals[i];
+    }
+    return total;
+}
+
+double CaseColumnStore::sumSeverity() const {
+    const double* data = severities.data();
+    size_t n = severities.size();
+    size_t i = 0;
+    double total = 0.0;
+#if defined(__AVX2__)
+    __m256d acc = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) acc = _mm256_add_pd(acc, _mm256_loadu_pd(data + i));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__)
+    __m128d acc = _mm_setzero_pd();
+    for (; i + 2 <= n; i += 2) acc = _mm_add_pd(acc, _mm_loadu_pd(data + i));
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) total += data[i];
+    return total;
+}
+
+vector<size_t> CaseColumnStore::countByCity() const {
+    vector<size_t> counts(cityDictionary.size(), 0);
+    for (int32_t code : cityCodes) {
+        if (code >= 0) counts[code]++;
+    }
+    return counts;
+}
+
+void benchmarkColumnarAggregation(size_t caseCount) {
+    cout << "\nBuilding " << caseCount << " synthetic cases...\n";
+    vector<Case*> objects;
+    objects.reserve(caseCount);
+    Location city1("1 Mall Road", "Lahore", "Punjab");
+    Location city2("2 Blue Area", "Islamabad", "ICT");
+    CaseColumnStore columns;
+    columns.reserve(caseCount);
+    for (size_t i = 0; i < caseCount; i++) {
+        Case* c = nullptr;
+        int id = static_cast<int>(i + 1);
+        switch (i % 4) {
+            case 0: c = new Theft(id, static_cast<double>(i % 5000)); break;
+            case 1: c = new Assault(id, i % 3 == 0, "", static_cast<int>(i % 10)); break;
+            case 2: c = new Vandalism(id, static_cast<double>(i % 8000), "", i % 2 == 0); break;
+            default: c = new Case("Fraud", id, static_cast<double>(i % 10)); break;
+        }
+        c->setLocation(i % 3 == 0 ? &city1 : &city2);
+        objects.push_back(c);
+        columns.upsert(c);
+    }
+
+    const int repeats = 5;
+    typedef chrono::steady_clock clock;
+
+    // Object walk: the same aggregates the old code computed with virtual calls
+    double objStolen = 0.0, objSeverity = 0.0;
+    size_t objHigh = 0;
+    auto start = clock::now();
+    for (int r = 0; r < repeats; r++) {
+        objStolen = 0.0;
+        objSeverity = 0.0;
+        objHigh = 0;
+        for (auto* c : objects) {
+            if (c->getType() == "Theft") objStolen += static_cast<Theft*>(c)->getStolenValue();
+            objSeverity += c->getSeverity();
+            if (c->getPriority() > 7.0) objHigh++;
+        }
+    }
+    double objectMs = chrono::duration<double, milli>(clock::now() - start).count() / repeats;
+
+    double colStolen = 0.0, colSeverity = 0.0;
+    size_t colHigh = 0;
+    start = clock::now();
+    for (int r = 0; r < repeats; r++) {
+        colStolen = columns.sumValueByType(TAG_THEFT);
+        colSeverity = columns.sumSeverity();
+        colHigh = columns.countPriorityAbove(7.0);
+    }
+    double columnMs = chrono::duration<double, milli>(clock::now() - start).count() / repeats;
+
+    cout << fixed << setprecision(2);
+    cout << "Kernels: " << CaseColumnStore::simdLevel() << "\n";
+    cout << "Object walk:  " << objectMs << " ms (stolen $" << objStolen << ", high priority " << objHigh << ")\n";
+    cout << "Columnar:     " << columnMs << " ms (stolen $" << colStolen << ", high priority " << colHigh << ")\n";
+    cout << "Speedup:      " << (columnMs > 0 ? objectMs / columnMs : 0.0) << "x\n";
+    cout << "Severity sums match: " << (objSeverity == colSeverity ? "yes" : "within rounding") << "\n";
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+
+    for (auto* c : objects) delete c;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+using namespace std;
+
+class Case;
+
+// Type tags stored in the columnar store
+enum CaseTypeTag : int32_t { TAG_OTHER = 0, TAG_THEFT = 1, TAG_ASSAULT = 2, TAG_VANDALISM = 3 };
+
+// Columnar shadow copy of the hot numeric fields of every case, kept in sync
+// by CrimeManager. Aggregates and filters walk a few dense arrays instead of
+// chasing Case* and making virtual calls. Rows are unordered: removal moves the
+// last row into the hole.
+//
+// The kernels use AVX2 when compiled with -mavx2 (or -march=native), SSE2 on
+// any other x86-64 build, and plain loops everywhere else.
+class CaseColumnStore {
+private:
+    vector<int32_t> ids;
+    vector<int32_t> typeTags;
+    vector<double> severities;
+    vector<double> priorities;   // Cached getPriority()
+    vector<double> values;       // Stolen value for Theft, damage value for Vandalism, else 0
+    vector<int32_t> cityCodes;   // Index into cityDictionary, -1 when there is no location
+    vector<Case*> rowCases;      // Back-pointers for display
+
+    vector<string> cityDictionary;
+    unordered_map<string, int32_t> cityLookup;
+    unordered_map<int, size_t> rowOf;  // caseId -> row
+
+    int32_t internCity(const string& city);
+
+public:
+    static int32_t tagFor(const string& type);
+    static const char* simdLevel();
+
+    // Adds the case or refreshes its row after an edit
+    void upsert(Case* c);
+    void remove(int caseId);
+    void clear();
+    void reserve(size_t n);
+
+    size_t size() const { return ids.size(); }
+    Case* caseAt(size_t row) const { return rowCases[row]; }
+    double priorityAt(size_t row) const { return priorities[row]; }
+    int32_t cityCode(const string& city) const;  // -1 if no case uses the city
+    const vector<string>& getCityDictionary() const { return cityDictionary; }
+
+    // Filter kernels: row numbers of matching cases
+    vector<size_t> filterByType(int32_t tag) const;
+    vector<size_t> filterByCity(int32_t code) const;
+
+    // Aggregation kernels; loading crimes.json checks its saved statistics with them
+    size_t countPriorityAbove(double threshold) const;
+    double sumValueByType(int32_t tag) const;
+    double sumSeverity() const;
+    vector<size_t> countByCity() const;  // Indexed by city code
+};
+
+// Compares an object walk with the columnar kernels over synthetic cases
+void benchmarkColumnarAggregation(size_t caseCount = 1000000);
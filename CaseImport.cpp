@@ -0,0 +1,498 @@
+#include "CaseImport.h"
+#include "CrimeModule.h"
+#include "SearchIndex.h"
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+#include <stdexcept>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+using namespace std;
+
+// Chunks smaller than this cost more to schedule than to parse
+static const size_t MIN_CHUNK_BYTES = 64 * 1024;
+
+// One parsed row, before it becomes a Case
+struct CaseRow {
+    size_t line;  // Within its chunk until the chunks are numbered
+    int id;
+    string type;
+    double severity;
+    string description, reportedBy, date;
+    bool hasLocation;
+    string address, city, state, zipCode;
+    double stolenValue;
+    string itemStolen;
+    bool recovered;
+    bool weaponUsed;
+    string victimName;
+    int injurySeverity;
+    double damageValue;
+    string propertyType;
+    bool publicProperty;
+    int prosecutorId;     // -1 for none
+    bool skip;            // Duplicate ID
+    const Location* location;  // Shared with every row at the same place
+
+    CaseRow() : line(0), id(0), severity(0), hasLocation(false), stolenValue(0), recovered(false),
+        weaponUsed(false), injurySeverity(0), damageValue(0), publicProperty(false),
+        prosecutorId(-1), skip(false), location(nullptr) {}
+};
+
+// A run of whole lines, parsed and built by one task
+struct ImportChunk {
+    const char* begin;
+    const char* end;
+    size_t firstLine;   // File line number of `begin`
+    size_t lineCount;
+    vector<CaseRow> rows;
+    vector<pair<size_t, string>> errors;  // (line within chunk, message)
+    vector<CaseRecord> cases;  // One allocation for the chunk
+    vector<vector<string>> terms;
+    CrimeStatistics statistics;
+
+    ImportChunk() : begin(nullptr), end(nullptr), firstLine(0), lineCount(0) {}
+};
+
+// CSV column positions; -1 when the header doesn't have it
+struct CsvColumns {
+    int id, type, severity, description, reportedBy, date;
+    int address, city, state, zipCode;
+    int stolenValue, itemStolen, recovered, weaponUsed, victimName, injurySeverity;
+    int damageValue, propertyType, publicProperty, prosecutorId;
+    size_t count;
+};
+
+static double elapsedMs(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+}
+
+static bool isBlankOrComment(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\r')) begin++;
+    return begin == end || *begin == '#';
+}
+
+// Splits one CSV line; "" inside quotes is a literal quote
+static void splitCsvLine(const char* begin, const char* end, vector<string>& fields) {
+    fields.clear();
+    string field;
+    bool quoted = false;
+    for (const char* p = begin; p < end; p++) {
+        char ch = *p;
+        if (quoted) {
+            if (ch == '"') {
+                if (p + 1 < end && p[1] == '"') {
+                    field += '"';
+                    p++;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                field += ch;
+            }
+        } else if (ch == '"') {
+            quoted = true;
+        } else if (ch == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else if (ch != '\r') {
+            field += ch;
+        }
+    }
+    if (quoted) throw runtime_error("unterminated quote");
+    fields.push_back(field);
+}
+
+static double toDouble(const string& text, const char* column) {
+    char* end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0') throw runtime_error(string(column) + " is not a number: \"" + text + "\"");
+    return value;
+}
+
+static int toInt(const string& text, const char* column) {
+    char* end = nullptr;
+    long value = strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0') throw runtime_error(string(column) + " is not a whole number: \"" + text + "\"");
+    return static_cast<int>(value);
+}
+
+static bool toBool(const string& text, const char* column) {
+    if (text == "true" || text == "1" || text == "yes") return true;
+    if (text == "false" || text == "0" || text == "no") return false;
+    throw runtime_error(string(column) + " must be true or false: \"" + text + "\"");
+}
+
+static CsvColumns readCsvHeader(const char* begin, const char* end) {
+    // Spreadsheet exports often start with a UTF-8 byte order mark
+    if (end - begin >= 3 && memcmp(begin, "\xEF\xBB\xBF", 3) == 0) begin += 3;
+    vector<string> names;
+    splitCsvLine(begin, end, names);
+    map<string, int> position;
+    for (size_t i = 0; i < names.size(); i++) {
+        position[names[i]] = static_cast<int>(i);
+    }
+    auto column = [&position](const char* name) {
+        auto it = position.find(name);
+        return it == position.end() ? -1 : it->second;
+    };
+
+    CsvColumns cols;
+    cols.id = column("id");
+    cols.type = column("type");
+    cols.severity = column("severity");
+    if (cols.id < 0 || cols.type < 0 || cols.severity < 0) {
+        throw runtime_error("the CSV header needs id, type and severity columns");
+    }
+    cols.description = column("description");
+    cols.reportedBy = column("reportedBy");
+    cols.date = column("date");
+    cols.address = column("address");
+    cols.city = column("city");
+    cols.state = column("state");
+    cols.zipCode = column("zipCode");
+    cols.stolenValue = column("stolenValue");
+    cols.itemStolen = column("itemStolen");
+    cols.recovered = column("recovered");
+    cols.weaponUsed = column("weaponUsed");
+    cols.victimName = column("victimName");
+    cols.injurySeverity = column("injurySeverity");
+    cols.damageValue = column("damageValue");
+    cols.propertyType = column("propertyType");
+    cols.publicProperty = column("publicProperty");
+    cols.prosecutorId = column("prosecutorId");
+    cols.count = names.size();
+    return cols;
+}
+
+static CaseRow parseCsvRow(const vector<string>& fields, const CsvColumns& cols) {
+    if (fields.size() != cols.count) {
+        throw runtime_error("expected " + to_string(cols.count) + " fields, found " + to_string(fields.size()));
+    }
+    // Empty optional fields are treated as missing
+    auto has = [&fields](int col) { return col >= 0 && !fields[col].empty(); };
+
+    CaseRow row;
+    row.id = toInt(fields[cols.id], "id");
+    row.type = fields[cols.type];
+    if (row.type.empty()) throw runtime_error("type is empty");
+    row.severity = toDouble(fields[cols.severity], "severity");
+    if (has(cols.description)) row.description = fields[cols.description];
+    if (has(cols.reportedBy)) row.reportedBy = fields[cols.reportedBy];
+    if (has(cols.date)) row.date = fields[cols.date];
+
+    if (has(cols.address) || has(cols.city) || has(cols.state)) {
+        if (!has(cols.address) || !has(cols.city) || !has(cols.state)) {
+            throw runtime_error("location needs address, city and state");
+        }
+        row.hasLocation = true;
+        row.address = fields[cols.address];
+        row.city = fields[cols.city];
+        row.state = fields[cols.state];
+        if (has(cols.zipCode)) row.zipCode = fields[cols.zipCode];
+    }
+
+    if (has(cols.stolenValue)) row.stolenValue = toDouble(fields[cols.stolenValue], "stolenValue");
+    if (has(cols.itemStolen)) row.itemStolen = fields[cols.itemStolen];
+    if (has(cols.recovered)) row.recovered = toBool(fields[cols.recovered], "recovered");
+    if (has(cols.weaponUsed)) row.weaponUsed = toBool(fields[cols.weaponUsed], "weaponUsed");
+    if (has(cols.victimName)) row.victimName = fields[cols.victimName];
+    if (has(cols.injurySeverity)) row.injurySeverity = toInt(fields[cols.injurySeverity], "injurySeverity");
+    if (has(cols.damageValue)) row.damageValue = toDouble(fields[cols.damageValue], "damageValue");
+    if (has(cols.propertyType)) row.propertyType = fields[cols.propertyType];
+    if (has(cols.publicProperty)) row.publicProperty = toBool(fields[cols.publicProperty], "publicProperty");
+    if (has(cols.prosecutorId)) row.prosecutorId = toInt(fields[cols.prosecutorId], "prosecutorId");
+    return row;
+}
+
+// Same fields and checks as a crimes.json entry / the add_case batch operation
+static CaseRow parseJsonRow(const char* begin, const char* end) {
+    json j = json::parse(begin, end);
+    if (!j.is_object() || !j.contains("id") || !j.contains("type") || !j.contains("severity")) {
+        throw runtime_error("id, type and severity are required");
+    }
+    CaseRow row;
+    row.id = j["id"].get<int>();
+    row.type = j["type"].get<string>();
+    row.severity = j["severity"].get<double>();
+    row.description = j.value("description", "");
+    row.reportedBy = j.value("reportedBy", "");
+    row.date = j.value("date", "");
+    if (j.contains("location")) {
+        const json& loc = j["location"];
+        if (!loc.is_object() || !loc.contains("address") || !loc.contains("city") || !loc.contains("state")) {
+            throw runtime_error("location needs address, city and state");
+        }
+        row.hasLocation = true;
+        row.address = loc["address"].get<string>();
+        row.city = loc["city"].get<string>();
+        row.state = loc["state"].get<string>();
+        row.zipCode = loc.value("zipCode", "");
+    }
+    row.stolenValue = j.value("stolenValue", 0.0);
+    row.itemStolen = j.value("itemStolen", "");
+    row.recovered = j.value("recovered", false);
+    row.weaponUsed = j.value("weaponUsed", false);
+    row.victimName = j.value("victimName", "");
+    row.injurySeverity = j.value("injurySeverity", 0);
+    row.damageValue = j.value("damageValue", 0.0);
+    row.propertyType = j.value("propertyType", "");
+    row.publicProperty = j.value("publicProperty", false);
+    if (j.contains("assignedProsecutor")) {
+        row.prosecutorId = j["assignedProsecutor"].at("id").get<int>();
+    }
+    return row;
+}
+
+static void parseChunk(ImportChunk& chunk, bool csv, const CsvColumns& cols) {
+    vector<string> fields;
+    const char* p = chunk.begin;
+    size_t line = 0;
+    while (p < chunk.end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', chunk.end - p));
+        if (!eol) eol = chunk.end;
+        if (!isBlankOrComment(p, eol)) {
+            try {
+                CaseRow row;
+                if (csv) {
+                    splitCsvLine(p, eol, fields);
+                    row = parseCsvRow(fields, cols);
+                } else {
+                    row = parseJsonRow(p, eol);
+                }
+                row.line = line;
+                chunk.rows.push_back(move(row));
+            } catch (const exception& e) {
+                chunk.errors.push_back(make_pair(line, string(e.what())));
+            }
+        }
+        line++;
+        p = eol + 1;
+    }
+    chunk.lineCount = line;
+}
+
+// Mirrors CrimeManager::addCaseFromJsonLocked()
+static void buildCase(const CaseRow& row, CaseRecord& record) {
+    if (row.type == "Theft") {
+        record.emplace<Theft>(row.id, row.stolenValue, row.itemStolen, row.recovered);
+    } else if (row.type == "Assault") {
+        record.emplace<Assault>(row.id, row.weaponUsed, row.victimName, row.injurySeverity);
+    } else if (row.type == "Vandalism") {
+        record.emplace<Vandalism>(row.id, row.damageValue, row.propertyType, row.publicProperty);
+    } else {
+        record.emplace<Case>(row.type, row.id, row.severity);
+    }
+    Case* c = caseView(record);
+    c->setSeverity(row.severity);
+    c->setDescription(row.description);
+    c->setReportedBy(row.reportedBy);
+    c->setDate(row.date);
+    if (row.location) {
+        c->setLocation(row.location);
+    }
+}
+
+static void buildChunk(ImportChunk& chunk) {
+    chunk.cases.reserve(chunk.rows.size());
+    chunk.terms.reserve(chunk.rows.size());
+    for (const CaseRow& row : chunk.rows) {
+        if (row.skip) continue;
+        chunk.cases.emplace_back();
+        buildCase(row, chunk.cases.back());
+        chunk.terms.push_back(InvertedIndex::documentTerms(row.description));
+        chunk.statistics.addCase(caseView(chunk.cases.back()));
+    }
+    // Strings were copied into the cases; the rows aren't needed anymore
+    vector<CaseRow>().swap(chunk.rows);
+}
+
+// Cuts [begin, end) into about `target`-byte pieces, each ending after a newline
+static vector<ImportChunk> makeChunks(const char* begin, const char* end, size_t target) {
+    vector<ImportChunk> chunks;
+    const char* p = begin;
+    while (p < end) {
+        const char* stop = p + target < end ? p + target : end;
+        if (stop < end) {
+            const char* eol = static_cast<const char*>(memchr(stop, '\n', end - stop));
+            stop = eol ? eol + 1 : end;
+        }
+        ImportChunk chunk;
+        chunk.begin = p;
+        chunk.end = stop;
+        chunks.push_back(move(chunk));
+        p = stop;
+    }
+    return chunks;
+}
+
+static string lowercaseExtension(const string& filename) {
+    size_t dot = filename.rfind('.');
+    if (dot == string::npos) return "";
+    string ext = filename.substr(dot + 1);
+    for (char& ch : ext) ch = static_cast<char>(tolower(static_cast<unsigned char>(ch)));
+    return ext;
+}
+
+CaseImportReport importCases(const string& filename, size_t numThreads) {
+    CaseImportReport report;
+    report.filename = filename;
+    report.threads = numThreads > 0 ? numThreads : 1;
+    auto start = chrono::steady_clock::now();
+
+    // Read
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("cannot open " + filename);
+    }
+    ostringstream buffer;
+    buffer << file.rdbuf();
+    string content = buffer.str();
+    report.readMs = elapsedMs(start);
+
+    const char* begin = content.data();
+    const char* end = begin + content.size();
+    string ext = lowercaseExtension(filename);
+    bool csv;
+    if (ext == "csv") csv = true;
+    else if (ext == "jsonl" || ext == "ndjson" || ext == "json") csv = false;
+    else {
+        size_t first = content.find_first_not_of(" \t\r\n");
+        csv = first == string::npos || content[first] != '{';
+    }
+    report.format = csv ? "csv" : "jsonl";
+
+    // The CSV header is the first line that isn't blank or a comment
+    CsvColumns cols = CsvColumns();
+    size_t firstDataLine = 1;
+    if (csv) {
+        while (begin < end) {
+            const char* eol = static_cast<const char*>(memchr(begin, '\n', end - begin));
+            if (!eol) eol = end;
+            bool skip = isBlankOrComment(begin, eol);
+            if (!skip) cols = readCsvHeader(begin, eol);
+            begin = eol < end ? eol + 1 : end;
+            firstDataLine++;
+            if (!skip) break;
+        }
+        if (cols.count == 0) {
+            throw runtime_error(filename + " has no CSV header");
+        }
+    }
+
+    // Parse
+    auto phase = chrono::steady_clock::now();
+    size_t target = static_cast<size_t>(end - begin) / (report.threads * 4);
+    vector<ImportChunk> chunks = makeChunks(begin, end, target > MIN_CHUNK_BYTES ? target : MIN_CHUNK_BYTES);
+    report.chunks = chunks.size();
+    ThreadPool pool(report.threads);
+    {
+        vector<future<void>> done;
+        for (ImportChunk& chunk : chunks) {
+            ImportChunk* c = &chunk;
+            done.push_back(pool.enqueue([c, csv, &cols]() { parseChunk(*c, csv, cols); }));
+        }
+        for (auto& f : done) f.get();
+    }
+    size_t line = firstDataLine;
+    for (ImportChunk& chunk : chunks) {
+        chunk.firstLine = line;
+        line += chunk.lineCount;
+        report.rows += chunk.rows.size() + chunk.errors.size();
+        report.failed += chunk.errors.size();
+        for (const auto& error : chunk.errors) {
+            report.errors.push_back("Line " + to_string(chunk.firstLine + error.first) + ": " + error.second);
+        }
+    }
+    report.parseMs = elapsedMs(phase);
+
+    // Duplicate IDs and shared locations, in file order so the first row wins
+    phase = chrono::steady_clock::now();
+    CrimeManager& crimes = CrimeRegistry::getInstance()->getManager();
+    vector<int> existing = crimes.getCaseIds();
+    unordered_set<int> seen(existing.begin(), existing.end());
+    seen.reserve(existing.size() + report.rows);
+    CaseBulkLoad load;
+    for (ImportChunk& chunk : chunks) {
+        for (CaseRow& row : chunk.rows) {
+            if (!seen.insert(row.id).second) {
+                row.skip = true;
+                report.duplicates++;
+                continue;
+            }
+            if (row.prosecutorId >= 0) {
+                load.prosecutorLinks[row.id] = row.prosecutorId;
+            }
+            if (row.hasLocation) {
+                row.location = load.locations.intern(row.address, row.city, row.state, row.zipCode);
+            }
+        }
+    }
+    report.locations = load.locations.size();
+
+    // Build
+    {
+        vector<future<void>> done;
+        for (ImportChunk& chunk : chunks) {
+            ImportChunk* c = &chunk;
+            done.push_back(pool.enqueue([c]() { buildChunk(*c); }));
+        }
+        for (auto& f : done) f.get();
+    }
+    size_t built = 0;
+    for (const ImportChunk& chunk : chunks) built += chunk.cases.size();
+    load.cases.reserve(built);
+    load.searchTerms.reserve(built);
+    for (ImportChunk& chunk : chunks) {
+        for (auto& record : chunk.cases) load.cases.push_back(move(record));
+        for (auto& terms : chunk.terms) load.searchTerms.push_back(move(terms));
+        load.statistics.merge(chunk.statistics);
+    }
+    chunks.clear();
+    report.buildMs = elapsedMs(phase);
+
+    // Merge
+    phase = chrono::steady_clock::now();
+    report.imported = crimes.addCasesBulk(load);
+    report.duplicates += built - report.imported;  // Added by someone else meanwhile
+    crimes.resolveProsecutors();
+    report.mergeMs = elapsedMs(phase);
+
+    report.totalMs = elapsedMs(start);
+    return report;
+}
+
+void printImportReport(const CaseImportReport& report, ostream& os, size_t maxErrors) {
+    for (size_t i = 0; i < report.errors.size() && i < maxErrors; i++) {
+        os << report.errors[i] << "\n";
+    }
+    if (report.errors.size() > maxErrors) {
+        os << "... and " << report.errors.size() - maxErrors << " more bad row(s)\n";
+    }
+    os << "\n=== Import Summary ===\n";
+    os << "File:        " << report.filename << " (" << report.format << ", " << report.chunks
+       << " chunk(s) on " << report.threads << " thread(s))\n";
+    os << "Rows:        " << report.rows << " (" << report.imported << " imported, "
+       << report.duplicates << " duplicate, " << report.failed << " failed)\n";
+    os << "Locations:   " << report.locations << " distinct\n";
+    os << fixed << setprecision(1);
+    os << "Time:        " << report.totalMs << " ms (read " << report.readMs << ", parse " << report.parseMs
+       << ", build " << report.buildMs << ", merge " << report.mergeMs << ")\n";
+    os << setprecision(0);
+    os << "Throughput:  " << (report.totalMs > 0 ? report.rows * 60000.0 / report.totalMs : 0.0) << " rows/min\n";
+    os.unsetf(ios::floatfield);
+}
+
+int runImportMode(const string& filename, size_t numThreads) {
+    cout << "\nImport: loading cases from " << filename << "\n";
+    try {
+        CaseImportReport report = importCases(filename, numThreads);
+        printImportReport(report, cout);
+        return report.failed == 0 ? 0 : 1;
+    } catch (const exception& e) {
+        cout << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <iostream>
+#include "ThreadPool.h"
+using namespace std;
+
+struct CaseImportReport {
+    string filename;
+    string format;       // "csv" or "jsonl"
+    size_t threads;
+    size_t chunks;
+    size_t rows;         // Data rows read (no header, blank or # lines)
+    size_t imported;
+    size_t duplicates;   // ID already loaded or earlier in the file
+    size_t failed;       // Rows that couldn't be parsed
+    size_t locations;    // Distinct locations among the imported rows
+    double readMs, parseMs, buildMs, mergeMs, totalMs;
+    vector<string> errors;  // "Line N: message"
+
+    CaseImportReport() : threads(0), chunks(0), rows(0), imported(0), duplicates(0), failed(0),
+        locations(0), readMs(0), parseMs(0), buildMs(0), mergeMs(0), totalMs(0) {}
+};
+
+// Bulk import of historical cases into the crime module.
+//
+// CSV needs a header row naming its columns; id, type and severity are
+// required. The rest are optional: description, reportedBy, date, address,
+// city, state, zipCode, stolenValue, itemStolen, recovered, weaponUsed,
+// victimName, injurySeverity, damageValue, propertyType, publicProperty,
+// prosecutorId. Fields may be quoted ("" for a quote), but they can't span lines.
+// JSONL has one crimes.json case entry per line.
+//
+// The file is cut into chunks at line breaks. The chunks are parsed on a thread
+// pool, rows are checked for duplicate IDs and their locations shared, and the
+// chunks are built into cases (with statistics and search terms) in parallel.
+// Everything is then added under a single crime-module lock.
+CaseImportReport importCases(const string& filename, size_t numThreads = ThreadPool::defaultThreadCount());
+void printImportReport(const CaseImportReport& report, ostream& os, size_t maxErrors = 20);
+
+int runImportMode(const string& filename, size_t numThreads);
@@ -0,0 +1,224 @@
+#include "CaseLinkBackfill.h"
+#include "CrimeModule.h"
+#include "JailModule.h"
+#include "SearchIndex.h"
+#include "TrigramIndex.h"
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <cctype>
+using namespace std;
+
+static const double MIN_TYPE_SCORE = 0.5;  // TrigramIndex score of a crime word against a case type
+
+static double elapsedMs(chrono::steady_clock::time_point since) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+}
+
+// Read-only once built, so the workers share it without locking
+struct CaseLookup {
+    vector<int> ids;                                   // case number -> caseId
+    vector<uint32_t> typeOf;                           // case number -> type number
+    FlatHashMap<int, uint32_t> byId;
+    TrigramIndex types;                                // type number -> type name
+    unordered_map<string, vector<uint32_t>> byWord;    // description/reporter word -> sorted case numbers
+};
+
+struct BackfillChunk {
+    size_t begin, end;  // Into the prisoner copies
+    vector<pair<int, int>> links;
+    size_t byCaseNumber = 0, byTypeAndName = 0, noMatchingType = 0, noNamedCase = 0;
+    vector<string> unresolved;
+};
+
+// "case 4411", "case no. 4411", "case #4411" and "#4411"
+static vector<int> caseNumbersIn(const string& text) {
+    vector<int> numbers;
+    string lower;
+    for (char ch : text) lower += static_cast<char>(tolower(static_cast<unsigned char>(ch)));
+    auto isSeparator = [&lower](size_t j) {
+        return j < lower.size() && (lower[j] == ' ' || lower[j] == '#' || lower[j] == ':' || lower[j] == '.' || lower[j] == '-');
+    };
+    for (size_t i = 0; i < lower.size(); i++) {
+        size_t j;
+        if (lower[i] == '#') {
+            j = i + 1;
+        } else if (lower.compare(i, 4, "case") == 0 && (i == 0 || !isalnum(static_cast<unsigned char>(lower[i - 1])))) {
+            j = i + 4;
+            while (isSeparator(j)) j++;
+            if (lower.compare(j, 2, "no") == 0) {
+                j += 2;
+                while (isSeparator(j)) j++;
+            }
+        } else {
+            continue;
+        }
+        size_t start = j;
+        while (j < lower.size() && isdigit(static_cast<unsigned char>(lower[j]))) j++;
+        if (j > start && j - start <= 9) numbers.push_back(stoi(lower.substr(start, j - start)));
+    }
+    return numbers;
+}
+
+static void buildLookup(CaseLookup& lookup) {
+    unordered_map<string, uint32_t> typeNumbers;
+    CrimeRegistry::getInstance()->getManager().forEachCase([&](const Case& c) {
+        uint32_t number = static_cast<uint32_t>(lookup.ids.size());
+        string type = c.getType();
+        string key;
+        for (char ch : type) key += static_cast<char>(tolower(static_cast<unsigned char>(ch)));
+        auto typeIt = typeNumbers.find(key);
+        if (typeIt == typeNumbers.end()) {
+            typeIt = typeNumbers.emplace(key, static_cast<uint32_t>(typeNumbers.size())).first;
+            lookup.types.add(typeIt->second, type);
+        }
+        lookup.ids.push_back(c.getId());
+        lookup.typeOf.push_back(typeIt->second);
+        lookup.byId[c.getId()] = number;
+        for (const string& word : InvertedIndex::documentTerms(c.getDescription() + " " + c.getReportedBy())) {
+            lookup.byWord[word].push_back(number);
+        }
+    });
+}
+
+static void resolveChunk(BackfillChunk& chunk, const vector<Prisoner>& prisoners, const CaseLookup& lookup) {
+    for (size_t i = chunk.begin; i < chunk.end; i++) {
+        const Prisoner& p = prisoners[i];
+        size_t before = chunk.links.size();
+        for (int caseId : caseNumbersIn(p.getCrime())) {
+            if (lookup.byId.find(caseId) != lookup.byId.end()) chunk.links.push_back(make_pair(p.getId(), caseId));
+        }
+        if (chunk.links.size() > before) {
+            chunk.byCaseNumber++;
+            continue;
+        }
+
+        // Word by word, so "car theft and assault" finds both Theft and Assault
+        vector<uint32_t> types;
+        for (const string& word : InvertedIndex::documentTerms(p.getCrime())) {
+            for (const TrigramIndex::Match& m : lookup.types.search(word, 3, MIN_TYPE_SCORE)) {
+                if (find(types.begin(), types.end(), static_cast<uint32_t>(m.id)) == types.end()) types.push_back(m.id);
+            }
+        }
+        if (types.empty()) {
+            chunk.noMatchingType++;
+            chunk.unresolved.push_back("Prisoner " + to_string(p.getId()) + " (" + p.getCrime() + "): no case type like it");
+            continue;
+        }
+
+        // Cases of a matching type mentioning every word of the name, walked
+        // from the name's rarest word
+        vector<const vector<uint32_t>*> lists;
+        for (const string& word : InvertedIndex::documentTerms(p.getName())) {
+            auto it = lookup.byWord.find(word);
+            lists.push_back(it != lookup.byWord.end() ? &it->second : nullptr);
+        }
+        if (!lists.empty() && find(lists.begin(), lists.end(), nullptr) == lists.end()) {
+            sort(lists.begin(), lists.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) {
+                return a->size() < b->size();
+            });
+            for (uint32_t number : *lists[0]) {
+                bool named = find(types.begin(), types.end(), lookup.typeOf[number]) != types.end();
+                for (size_t k = 1; named && k < lists.size(); k++) {
+                    named = binary_search(lists[k]->begin(), lists[k]->end(), number);
+                }
+                if (named) chunk.links.push_back(make_pair(p.getId(), lookup.ids[number]));
+            }
+        }
+        if (chunk.links.size() > before) {
+            chunk.byTypeAndName++;
+        } else {
+            chunk.noNamedCase++;
+            chunk.unresolved.push_back("Prisoner " + to_string(p.getId()) + " (" + p.getCrime() +
+                                       "): no case of that type names " + p.getName());
+        }
+    }
+}
+
+CaseLinkBackfillReport backfillCaseLinks(size_t numThreads) {
+    CaseLinkBackfillReport report;
+    report.threads = numThreads > 0 ? numThreads : 1;
+    auto start = chrono::steady_clock::now();
+
+    // Snapshot: cases into lookups, unlinked prisoners into copies
+    CaseLookup lookup;
+    buildLookup(lookup);
+    report.cases = lookup.ids.size();
+    JailRegistry* jails = JailRegistry::getInstance();
+    vector<Prisoner> prisoners;
+    for (size_t f = 0; f < jails->getFacilityCount(); f++) {
+        for (Prisoner& p : jails->getJail(f).getPrisoners()) {
+            report.prisoners++;
+            if (!p.getCaseIds().empty()) {
+                report.alreadyLinked++;
+            } else {
+                prisoners.push_back(std::move(p));
+            }
+        }
+    }
+    report.snapshotMs = elapsedMs(start);
+
+    // Resolve
+    auto phase = chrono::steady_clock::now();
+    size_t chunkSize = prisoners.size() / (report.threads * 4) + 1;
+    vector<BackfillChunk> chunks;
+    for (size_t begin = 0; begin < prisoners.size(); begin += chunkSize) {
+        BackfillChunk chunk;
+        chunk.begin = begin;
+        chunk.end = min(begin + chunkSize, prisoners.size());
+        chunks.push_back(std::move(chunk));
+    }
+    {
+        ThreadPool pool(report.threads);
+        vector<future<void>> done;
+        for (BackfillChunk& chunk : chunks) {
+            BackfillChunk* c = &chunk;
+            done.push_back(pool.enqueue([c, &prisoners, &lookup]() { resolveChunk(*c, prisoners, lookup); }));
+        }
+        for (auto& f : done) f.get();
+    }
+    vector<pair<int, int>> links;
+    for (BackfillChunk& chunk : chunks) {
+        report.byCaseNumber += chunk.byCaseNumber;
+        report.byTypeAndName += chunk.byTypeAndName;
+        report.noMatchingType += chunk.noMatchingType;
+        report.noNamedCase += chunk.noNamedCase;
+        links.insert(links.end(), chunk.links.begin(), chunk.links.end());
+        report.unresolved.insert(report.unresolved.end(), chunk.unresolved.begin(), chunk.unresolved.end());
+    }
+    report.resolveMs = elapsedMs(phase);
+
+    // Apply; prisoners released or linked meanwhile are skipped
+    phase = chrono::steady_clock::now();
+    report.linksAdded = jails->linkCases(links);
+    report.applyMs = elapsedMs(phase);
+    report.totalMs = elapsedMs(start);
+    return report;
+}
+
+void printBackfillReport(const CaseLinkBackfillReport& report, ostream& os, size_t maxUnresolved) {
+    for (size_t i = 0; i < report.unresolved.size() && i < maxUnresolved; i++) {
+        os << report.unresolved[i] << "\n";
+    }
+    if (report.unresolved.size() > maxUnresolved) {
+        os << "... and " << report.unresolved.size() - maxUnresolved << " more unresolved prisoner(s)\n";
+    }
+    os << "\n=== Case Link Backfill ===\n";
+    os << "Prisoners:   " << report.prisoners << " (" << report.alreadyLinked << " already linked) against "
+       << report.cases << " case(s) on " << report.threads << " thread(s)\n";
+    os << "Resolved:    " << report.byCaseNumber << " by case number, " << report.byTypeAndName << " by type and name\n";
+    os << "Unresolved:  " << report.noMatchingType << " with no matching case type, "
+       << report.noNamedCase << " with no case naming them\n";
+    os << "Links added: " << report.linksAdded << "\n";
+    os << fixed << setprecision(1);
+    os << "Time:        " << report.totalMs << " ms (snapshot " << report.snapshotMs << ", resolve "
+       << report.resolveMs << ", apply " << report.applyMs << ")\n";
+    os.unsetf(ios::floatfield);
+}
+
+int runCaseLinkBackfillMode(size_t numThreads) {
+    cout << "\nBackfill: linking prisoners to crime cases from their crime text\n";
+    printBackfillReport(backfillCaseLinks(numThreads), cout);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <iostream>
+#include "ThreadPool.h"
+using namespace std;
+
+struct CaseLinkBackfillReport {
+    size_t threads;
+    size_t cases;           // Cases in the crime module
+    size_t prisoners;       // Across all facilities
+    size_t alreadyLinked;   // Skipped: they have case IDs already
+    size_t byCaseNumber;    // Crime text names an existing case, e.g. "theft (case 4411)" or "#4411"
+    size_t byTypeAndName;   // Crime text matches a case type and a case of that type names the prisoner
+    size_t noMatchingType;  // Unresolved: the crime text is like no case type
+    size_t noNamedCase;     // Unresolved: no case of the matching type names the prisoner
+    size_t linksAdded;
+    double snapshotMs, resolveMs, applyMs, totalMs;
+    vector<string> unresolved;  // "Prisoner N (crime): reason"
+
+    CaseLinkBackfillReport() : threads(0), cases(0), prisoners(0), alreadyLinked(0), byCaseNumber(0),
+        byTypeAndName(0), noMatchingType(0), noNamedCase(0), linksAdded(0),
+        snapshotMs(0), resolveMs(0), applyMs(0), totalMs(0) {}
+};
+
+// Links prisoners from before case links existed to crime cases, from their
+// free-text crime field. For each prisoner without case IDs:
+//   1. Case numbers in the text ("case 4411", "#4411") that exist are linked.
+//   2. Otherwise each word of the text is matched against the case types,
+//      misspellings included (TrigramIndex), and every case of a matching type
+//      whose description or reporter mentions all of the prisoner's name is linked.
+// Anything else is left unlinked and reported; a type alone can't say which
+// of its cases is the prisoner's.
+//
+// Cases and prisoners are copied out first, the prisoners are resolved in
+// chunks on a thread pool against read-only lookups, and the links are then
+// added with one lock hold per facility.
+CaseLinkBackfillReport backfillCaseLinks(size_t numThreads = ThreadPool::defaultThreadCount());
+void printBackfillReport(const CaseLinkBackfillReport& report, ostream& os, size_t maxUnresolved = 20);
+
+int runCaseLinkBackfillMode(size_t numThreads);
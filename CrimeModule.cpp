@@ -1,8 +1,16 @@
 #include "CrimeModule.h"
+#include "SearchIndex.h"
+#include "DataLoader.h"
+#include "PersistenceCoordinator.h"
+#include "CaseImport.h"
+#include "JailModule.h"
 #include <algorithm> // Added for sort
+#include <cmath>
 #include <fstream>
 #include <stdexcept>
 #include <sstream> // For string stream operations
+#include <functional>
+#include <mutex>
 using json = nlohmann::json;
 
 using namespace std;
@@ -116,346 +124,780 @@ void Vandalism::displayDetails() const {
     cout << "----------------------------------------" << endl;
 }
 
-void CrimeManager::addCase(Case* c) {
-    cases.push_back(c);
-    caseMap[c->getId()] = c;
-
-    // Update statistics
-    caseTypeCount[c->getType()]++;
+CaseRecord toRecord(const Case& c) {
+    if (const Theft* theft = dynamic_cast<const Theft*>(&c)) return *theft;
+    if (const Assault* assault = dynamic_cast<const Assault*>(&c)) return *assault;
+    if (const Vandalism* vandalism = dynamic_cast<const Vandalism*>(&c)) return *vandalism;
+    return c;
+}
 
-    if (c->getType() == "Theft") {
-        Theft* theft = dynamic_cast<Theft*>(c);
-        if (theft) {
-            totalStolenValue += theft->getStolenValue();
+Case* CaseRecordStore::add(CaseRecord&& record) {
+    size_t i;
+    if (!freeSlots.empty()) {
+        i = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        if (used == blocks.size() * BLOCK_SIZE) {
+            blocks.push_back(unique_ptr<CaseRecord[]>(new CaseRecord[BLOCK_SIZE]));
         }
+        i = used++;
     }
+    slot(i) = move(record);
+    live++;
+    return caseView(slot(i));
+}
+
+bool CaseRecordStore::remove(const Case* c) {
+    // Deletes are rare; finding the block by address saves an ID -> slot table
+    const char* address = reinterpret_cast<const char*>(c);
+    for (size_t b = 0; b < blocks.size(); b++) {
+        const char* first = reinterpret_cast<const char*>(blocks[b].get());
+        const char* last = first + BLOCK_SIZE * sizeof(CaseRecord);
+        if (less<const char*>()(address, first) || !less<const char*>()(address, last)) continue;
+        size_t i = b * BLOCK_SIZE + (address - first) / sizeof(CaseRecord);
+        if (caseView(slot(i)) != c) return false;
+        slot(i) = monostate();  // Frees the strings now
+        freeSlots.push_back(i);
+        live--;
+        return true;
+    }
+    return false;
+}
+
+void CaseRecordStore::reserve(size_t n) {
+    size_t needed = used + (n > freeSlots.size() ? n - freeSlots.size() : 0);
+    while (blocks.size() * BLOCK_SIZE < needed) {
+        blocks.push_back(unique_ptr<CaseRecord[]>(new CaseRecord[BLOCK_SIZE]));
+    }
+}
+
+void CaseRecordStore::clear() {
+    blocks.clear();
+    freeSlots.clear();
+    used = 0;
+    live = 0;
+}
+
+void CrimeManager::addCaseLocked(CaseRecord&& record) {
+    Case* c = records.add(move(record));
+    caseMap[c->getId()] = c;
+    columns.upsert(c);
+    state.markDirty();
+    SearchRegistry::getInstance()->getIndex().indexDocument(DocKind::Case, c->getId(), c->getDescription());
 
-    if (c->getPriority() > 7.0) {
-        highPriorityCaseCount++;
+    // Update statistics
+    if (trackStatistics) {
+        statistics.addCase(c);
+    }
+    if (approximateMode) {
+        sketches.addCase(c);
     }
 }
 
+void CrimeManager::addCase(Case* c) {
+    CaseRecord record = toRecord(*c);
+    delete c;
+    unique_lock<shared_mutex> lock(casesMutex);
+    addCaseLocked(move(record));
+}
+
 // Function overloading: simpler version
 void CrimeManager::addCase(int id, string type) {
-    Case* newCase = nullptr;
+    CaseRecord record;
 
     if (type == "Theft")
-        newCase = new Theft(id);
+        record = Theft(id);
     else if (type == "Assault")
-        newCase = new Assault(id);
+        record = Assault(id);
     else if (type == "Vandalism") 
-        newCase = new Vandalism(id);
+        record = Vandalism(id);
     else
-        newCase = new Case(type, id);
+        record = Case(type, id);
 
-    addCase(newCase);
+    unique_lock<shared_mutex> lock(casesMutex);
+    addCaseLocked(move(record));
 }
 
 // Function overloading: version with extra info
 void CrimeManager::addCase(int id, string type, double extraInfo) {
-    Case* newCase = nullptr;
+    CaseRecord record;
 
     if (type == "Theft")
-        newCase = new Theft(id, extraInfo);  // extraInfo is stolenValue
+        record = Theft(id, extraInfo);  // extraInfo is stolenValue
     else if (type == "Assault")
-        newCase = new Assault(id, extraInfo > 0);  // extraInfo > 0 means weapon was used
+        record = Assault(id, extraInfo > 0);  // extraInfo > 0 means weapon was used
     else if (type == "Vandalism")
-        newCase = new Vandalism(id, extraInfo); // extraInfo is damage value
+        record = Vandalism(id, extraInfo); // extraInfo is damage value
     else
-        newCase = new Case(type, id, extraInfo);  // extraInfo is severity
+        record = Case(type, id, extraInfo);  // extraInfo is severity
 
-    addCase(newCase);
+    unique_lock<shared_mutex> lock(casesMutex);
+    addCaseLocked(move(record));
+}
+
+static string trimmed(const string& text) {
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == string::npos) return "";
+    return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+// Lowercase, without leading/trailing spaces and with inner runs collapsed
+static void appendNormalized(string& out, const string& text) {
+    bool space = false;
+    bool started = false;
+    for (char ch : text) {
+        if (isspace(static_cast<unsigned char>(ch))) {
+            space = started;
+            continue;
+        }
+        if (space) out += ' ';
+        space = false;
+        started = true;
+        out += static_cast<char>(tolower(static_cast<unsigned char>(ch)));
+    }
+}
+
+string LocationPool::normalize(const string& text) {
+    string out;
+    out.reserve(text.size());
+    appendNormalized(out, text);
+    return out;
+}
+
+const Location* LocationPool::intern(const string& address, const string& city, const string& state, const string& zipCode) {
+    // One key for the lookup; most calls are for places already pooled
+    string key;
+    key.reserve(address.size() + city.size() + state.size() + zipCode.size() + 3);
+    appendNormalized(key, address);
+    key += '\x1f';
+    size_t cityStart = key.size();
+    appendNormalized(key, city);
+    size_t cityEnd = key.size();
+    key += '\x1f';
+    appendNormalized(key, state);
+    key += '\x1f';
+    appendNormalized(key, zipCode);
+    auto it = idByKey.find(key);
+    if (it != idByKey.end()) {
+        return &entries[it->second];
+    }
+
+    string cityKey = key.substr(cityStart, cityEnd - cityStart);
+    auto cityIt = cityIdByKey.find(cityKey);
+    if (cityIt == cityIdByKey.end()) {
+        cityIt = cityIdByKey.emplace(cityKey, static_cast<int>(cityNames.size())).first;
+        cityNames.push_back(trimmed(city));
+    }
+    entries.push_back(Location(trimmed(address), cityNames[cityIt->second], trimmed(state), trimmed(zipCode)));
+    Location& loc = entries.back();
+    loc.id = static_cast<int>(entries.size()) - 1;
+    loc.cityId = cityIt->second;
+    idByKey.emplace(move(key), loc.id);
+    return &loc;
+}
+
+const Location* LocationPool::intern(const Location& loc) {
+    return intern(loc.address, loc.city, loc.state, loc.zipCode);
+}
+
+const Location* LocationPool::get(int id) const {
+    return id >= 0 && id < static_cast<int>(entries.size()) ? &entries[id] : nullptr;
+}
+
+int LocationPool::findCity(const string& city) const {
+    auto it = cityIdByKey.find(normalize(city));
+    return it != cityIdByKey.end() ? it->second : -1;
+}
+
+void LocationPool::clear() {
+    entries.clear();
+    idByKey.clear();
+    cityNames.clear();
+    cityIdByKey.clear();
 }
 
 // Location methods (association)
-Location* CrimeManager::addLocation(const string& address, const string& city, const string& state, const string& zipCode) {
-    Location* loc = new Location(address, city, state, zipCode);
-    locations.push_back(loc);
-    return loc;
+const Location* CrimeManager::addLocation(const string& address, const string& city, const string& state, const string& zipCode) {
+    unique_lock<shared_mutex> lock(casesMutex);
+    return locations.intern(address, city, state, zipCode);
 }
 
-Case* CrimeManager::findCase(int id) {
+bool CrimeManager::setCaseLocation(int caseId, const Location* loc) {
+    unique_lock<shared_mutex> lock(casesMutex);
+    Case* c = findCaseLocked(caseId);
+    if (!c) return false;
+    statistics.removeCase(c);  // City buckets depend on the location
+    c->setLocation(loc);
+    statistics.addCase(c);
+    columns.upsert(c);
+    state.markDirty();
+    return true;
+}
+
+Case* CrimeManager::findCaseLocked(int id) const {
     auto it = caseMap.find(id);
     if (it != caseMap.end())
         return it->second;
     return nullptr;
 }
 
+bool CrimeManager::hasCase(int id) const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    return caseMap.count(id) > 0;
+}
+
+size_t CrimeManager::getCaseCount() const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    return records.size();
+}
+
+vector<int> CrimeManager::getCaseIds() const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    return caseMap.sortedKeys();
+}
+
+json CrimeManager::getCaseJson(int id) const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    Case* c = findCaseLocked(id);
+    return c ? caseToJson(c) : json();
+}
+
+json CrimeManager::findCasesJson(const string& type, const string& city) const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    vector<Case*> found;
+    if (!type.empty()) {
+        found = findCasesByType(type);
+    } else if (!city.empty()) {
+        found = findCasesByCity(city);
+    } else {
+        for (int id : caseMap.sortedKeys()) {
+            found.push_back(caseMap.at(id));
+        }
+    }
+    int cityId = city.empty() ? -1 : locations.findCity(city);
+    json list = json::array();
+    for (Case* c : found) {
+        if (!city.empty() && (!c->getLocation() || c->getLocation()->getCityId() != cityId)) continue;
+        list.push_back(caseToJson(c));
+    }
+    return list;
+}
+
+bool CrimeManager::displayCase(int id) const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    Case* c = findCaseLocked(id);
+    if (!c) return false;
+    c->displayDetails();
+    return true;
+}
+
+CrimeStatistics CrimeManager::getStatistics() const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    return statistics;
+}
+
 void CrimeManager::listCases() {
+    shared_lock<shared_mutex> lock(casesMutex);
     std::cout << "Cases:\n";
-    if (cases.size() == 0) {
+    if (records.size() == 0) {
         cout << "No cases found.\n";
         return;
     }
 
-    for (auto& c : cases) {
+    records.forEach([](const Case* c) {
         c->displayDetails();  // Polymorphic call - calls the appropriate version based on object type
-    }
+    });
 
-    cout << "Total cases: " << cases.size() << endl;
+    cout << "Total cases: " << records.size() << endl;
 }
 
 // Function demonstrating polymorphism with getPriority()
 void CrimeManager::listCasesByPriority() {
+    shared_lock<shared_mutex> lock(casesMutex);
     cout << "Cases by Priority (Highest First):\n";
 
-    if (cases.size() == 0) {
+    if (records.size() == 0) {
         cout << "No cases found.\n";
         return;
     }
 
-    // Create a temporary vector to sort
-    vector<Case*> sortedCases;
-    for (auto& c : cases) {
-        sortedCases.push_back(c);
-    }
-
-    // Sort by priority (higher priority first)
-    sort(sortedCases.begin(), sortedCases.end(),
-        [](Case* a, Case* b) {return a->getPriority() > b->getPriority(); });
+    // Sort row numbers on the cached priority column instead of calling getPriority() per comparison
+    vector<size_t> rows(columns.size());
+    for (size_t i = 0; i < rows.size(); i++) rows[i] = i;
+    sort(rows.begin(), rows.end(),
+        [this](size_t a, size_t b) {return columns.priorityAt(a) > columns.priorityAt(b); });
 
     // Display sorted cases
-    for (auto& c : sortedCases) {
-        cout << "Priority: " << c->getPriority() << " - ";
-        c->displayDetails();
+    for (size_t row : rows) {
+        cout << "Priority: " << columns.priorityAt(row) << " - ";
+        columns.caseAt(row)->displayDetails();
     }
 }
 
-void CrimeManager::save() {
-    // Create a JSON array to store cases
-    json casesJson = json::array();
+// One case as stored in crimes.json
+json CrimeManager::caseToJson(const Case* c) const {
+    json caseJson;
+    caseJson["id"] = c->getId();
+    caseJson["type"] = c->getType();
+    caseJson["severity"] = c->getSeverity();
 
-    for (auto& c : cases) {
-        // Create a JSON object for each case
-        json caseJson;
-        caseJson["id"] = c->getId();
-        caseJson["type"] = c->getType();
-        caseJson["severity"] = c->getSeverity();
-
-        // Add common fields
-        if (!c->getDescription().empty()) {
-            caseJson["description"] = c->getDescription();
-        }
-        if (!c->getReportedBy().empty()) {
-            caseJson["reportedBy"] = c->getReportedBy();
-        }
-        if (!c->getDate().empty()) {
-            caseJson["date"] = c->getDate();
-        }
+    // Add common fields
+    if (!c->getDescription().empty()) {
+        caseJson["description"] = c->getDescription();
+    }
+    if (!c->getReportedBy().empty()) {
+        caseJson["reportedBy"] = c->getReportedBy();
+    }
+    if (!c->getDate().empty()) {
+        caseJson["date"] = c->getDate();
+    }
 
-        // Add Prosecutor information if assigned
-        if (c->getAssignedProsecutor()) {
-            caseJson["assignedProsecutor"] = {
-                {"id", c->getAssignedProsecutor()->getId()},
-                {"name", c->getAssignedProsecutor()->getName()},
-                {"rank", c->getAssignedProsecutor()->getRank()}
-            };
-        }
+    // Add Prosecutor information if assigned
+    if (c->getAssignedProsecutor()) {
+        caseJson["assignedProsecutor"] = {
+            {"id", c->getAssignedProsecutor()->getId()},
+            {"name", c->getAssignedProsecutor()->getName()},
+            {"rank", c->getAssignedProsecutor()->getRank()}
+        };
+    }
+    else if (pendingProsecutorLinks.count(c->getId())) {
+        // Officer roster not loaded; keep the link instead of dropping it
+        caseJson["assignedProsecutor"] = { {"id", pendingProsecutorLinks.at(c->getId())} };
+    }
 
-        // Add location information if available
-        if (c->getLocation()) {
-            caseJson["location"] = {
-                {"address", c->getLocation()->getAddress()},
-                {"city", c->getLocation()->getCity()},
-                {"state", c->getLocation()->getState()},
-                {"zipCode", c->getLocation()->getZipCode()}
-            };
-        }
+    // Add location information if available
+    if (c->getLocation()) {
+        caseJson["location"] = {
+            {"address", c->getLocation()->getAddress()},
+            {"city", c->getLocation()->getCity()},
+            {"state", c->getLocation()->getState()},
+            {"zipCode", c->getLocation()->getZipCode()}
+        };
+    }
 
-        // Add type-specific information
-        if (c->getType() == "Theft") {
-            Theft* theft = dynamic_cast<Theft*>(c);
-            if (theft) {
-                caseJson["stolenValue"] = theft->getStolenValue();
-                caseJson["itemStolen"] = theft->getItemStolen();
-                caseJson["recovered"] = theft->isRecovered();
-            }
+    // Add type-specific information
+    if (c->getType() == "Theft") {
+        const Theft* theft = dynamic_cast<const Theft*>(c);
+        if (theft) {
+            caseJson["stolenValue"] = theft->getStolenValue();
+            caseJson["itemStolen"] = theft->getItemStolen();
+            caseJson["recovered"] = theft->isRecovered();
         }
-        else if (c->getType() == "Assault") {
-            Assault* assault = dynamic_cast<Assault*>(c);
-            if (assault) {
-                caseJson["weaponUsed"] = assault->wasWeaponUsed();
-                caseJson["victimName"] = assault->getVictimName();
-                caseJson["injurySeverity"] = assault->getInjurySeverity();
-            }
+    }
+    else if (c->getType() == "Assault") {
+        const Assault* assault = dynamic_cast<const Assault*>(c);
+        if (assault) {
+            caseJson["weaponUsed"] = assault->wasWeaponUsed();
+            caseJson["victimName"] = assault->getVictimName();
+            caseJson["injurySeverity"] = assault->getInjurySeverity();
         }
-        else if (c->getType() == "Vandalism") {
-            Vandalism* vandalism = dynamic_cast<Vandalism*>(c);
-            if (vandalism) {
-                caseJson["damageValue"] = vandalism->getDamageValue();
-                caseJson["propertyType"] = vandalism->getPropertyType();
-                caseJson["publicProperty"] = vandalism->isPublicProperty();
-            }
+    }
+    else if (c->getType() == "Vandalism") {
+        const Vandalism* vandalism = dynamic_cast<const Vandalism*>(c);
+        if (vandalism) {
+            caseJson["damageValue"] = vandalism->getDamageValue();
+            caseJson["propertyType"] = vandalism->getPropertyType();
+            caseJson["publicProperty"] = vandalism->isPublicProperty();
         }
-
-        // Add this case to the array
-        casesJson.push_back(caseJson);
     }
+    return caseJson;
+}
 
-    // Write JSON to file
-    ofstream file("crimes.json");
-    file << casesJson.dump(4); // Indent with 4 spaces for better readability
-    file.close();
+json CrimeManager::toJson() const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    // Create a JSON array to store cases
+    json casesJson = json::array();
 
-    cout << "Saved " << cases.size() << " cases to file." << endl;
-}
+    records.forEach([this, &casesJson](const Case* c) {
+        casesJson.push_back(caseToJson(c));
+    });
 
-void CrimeManager::load() {
-    // Clean up previous data
-    for (auto& pair : caseMap) {
-        delete pair.second;
-    }
-    cases.clear();
-    caseMap.clear();
+    // Statistics are stored next to the cases so load() doesn't have to recompute them
+    json data;
+    data["cases"] = casesJson;
+    data["statistics"] = statistics.toJson();
+    return data;
+}
 
-    // Clean up locations
-    for (auto& loc : locations) {
-        delete loc;
+void CrimeManager::save() {
+    // Write JSON to file, indented with 4 spaces for better readability
+    unsigned long long version = state.getVersion();
+    if (state.writeFile("crimes.json", toJson().dump(4), version)) {
+        cout << "Saved " << getCaseCount() << " cases to file." << endl;
+    } else {
+        cout << "Error saving cases to crimes.json" << endl;
     }
-    locations.clear();
-
-    // Reset statistics
-    caseTypeCount.clear();
-    totalStolenValue = 0.0;
-    highPriorityCaseCount = 0;
+}
 
+void CrimeManager::load() {
     try {
         // Open and read the JSON file
+        FileStamp stamp = FileStamp::of("crimes.json");
         ifstream file("crimes.json");
         if (!file.is_open()) {
             cout << "No saved data found or could not open file." << endl;
             return;
         }
 
-        json casesJson;
-        file >> casesJson;
+        json data;
+        file >> data;
         file.close();
 
-        // Process each case in the JSON array
-        for (const auto& caseJson : casesJson) {
-            int id = caseJson["id"];
-            string type = caseJson["type"];
+        loadFromJson(data);
+        resolveProsecutors();
+        state.markLoaded("crimes.json", stamp);
+        state.clearDirty();
+        cout << "Loaded " << getCaseCount() << " cases from file." << endl;
+    }
+    catch (const exception& e) {
+        cout << "Error loading data: " << e.what() << endl;
+    }
+}
 
-            Case* newCase = nullptr;
+// Builds one case from its crimes.json entry and adds it. The prosecutor is
+// left pending for resolveProsecutors().
+void CrimeManager::addCaseFromJsonLocked(const json& caseJson) {
+    int id = caseJson["id"];
+    string type = caseJson["type"];
 
-            if (type == "Theft") {
-                double stolenValue = caseJson.contains("stolenValue") ? caseJson["stolenValue"].get<double>() : 0.0;
-                string itemStolen = caseJson.contains("itemStolen") ? caseJson["itemStolen"].get<string>() : "";
-                bool recovered = caseJson.contains("recovered") ? caseJson["recovered"].get<bool>() : false;
+    // Built in place, then moved into the record store
+    CaseRecord record;
 
-                Theft* theft = new Theft(id, stolenValue, itemStolen, recovered);
-                theft->setSeverity(caseJson["severity"]);
+    if (type == "Theft") {
+        double stolenValue = caseJson.contains("stolenValue") ? caseJson["stolenValue"].get<double>() : 0.0;
+        string itemStolen = caseJson.contains("itemStolen") ? caseJson["itemStolen"].get<string>() : "";
+        bool recovered = caseJson.contains("recovered") ? caseJson["recovered"].get<bool>() : false;
 
-                if (caseJson.contains("itemStolen")) {
-                    theft->setItemStolen(caseJson["itemStolen"]);
-                }
-                if (caseJson.contains("recovered")) {
-                    theft->setRecovered(caseJson["recovered"]);
-                }
+        Theft* theft = &record.emplace<Theft>(id, stolenValue, itemStolen, recovered);
+        theft->setSeverity(caseJson["severity"]);
 
-                newCase = theft;
-                totalStolenValue += stolenValue;
-            }
-            else if (type == "Assault") {
-                bool weaponUsed = caseJson.contains("weaponUsed") ? caseJson["weaponUsed"].get<bool>() : false;
-                string victimName = caseJson.contains("victimName") ? caseJson["victimName"].get<string>() : "";
-                int injurySeverity = caseJson.contains("injurySeverity") ? caseJson["injurySeverity"].get<int>() : 0;
+        if (caseJson.contains("itemStolen")) {
+            theft->setItemStolen(caseJson["itemStolen"]);
+        }
+        if (caseJson.contains("recovered")) {
+            theft->setRecovered(caseJson["recovered"]);
+        }
 
-                Assault* assault = new Assault(id, weaponUsed, victimName, injurySeverity);
-                assault->setSeverity(caseJson["severity"]);
+    }
+    else if (type == "Assault") {
+        bool weaponUsed = caseJson.contains("weaponUsed") ? caseJson["weaponUsed"].get<bool>() : false;
+        string victimName = caseJson.contains("victimName") ? caseJson["victimName"].get<string>() : "";
+        int injurySeverity = caseJson.contains("injurySeverity") ? caseJson["injurySeverity"].get<int>() : 0;
 
-                if (caseJson.contains("victimName")) {
-                    assault->setVictimName(caseJson["victimName"]);
-                }
-                if (caseJson.contains("injurySeverity")) {
-                    assault->setInjurySeverity(caseJson["injurySeverity"]);
-                }
+        Assault* assault = &record.emplace<Assault>(id, weaponUsed, victimName, injurySeverity);
+        assault->setSeverity(caseJson["severity"]);
 
-                newCase = assault;
-            }
-            else if (type == "Vandalism") {
-                double damageValue = caseJson.contains("damageValue") ? caseJson["damageValue"].get<double>() : 0.0;
-                string propertyType = caseJson.contains("propertyType") ? caseJson["propertyType"].get<string>() : "";
-                bool publicProperty = caseJson.contains("publicProperty") ? caseJson["publicProperty"].get<bool>() : false;
+        if (caseJson.contains("victimName")) {
+            assault->setVictimName(caseJson["victimName"]);
+        }
+        if (caseJson.contains("injurySeverity")) {
+            assault->setInjurySeverity(caseJson["injurySeverity"]);
+        }
 
-                Vandalism* vandalism = new Vandalism(id, damageValue, propertyType, publicProperty);
-                vandalism->setSeverity(caseJson["severity"]);
+    }
+    else if (type == "Vandalism") {
+        double damageValue = caseJson.contains("damageValue") ? caseJson["damageValue"].get<double>() : 0.0;
+        string propertyType = caseJson.contains("propertyType") ? caseJson["propertyType"].get<string>() : "";
+        bool publicProperty = caseJson.contains("publicProperty") ? caseJson["publicProperty"].get<bool>() : false;
 
-                if (caseJson.contains("propertyType")) {
-                    vandalism->setPropertyType(caseJson["propertyType"]);
-                }
-                if (caseJson.contains("publicProperty")) {
-                    vandalism->setPublicProperty(caseJson["publicProperty"]);
-                }
+        Vandalism* vandalism = &record.emplace<Vandalism>(id, damageValue, propertyType, publicProperty);
+        vandalism->setSeverity(caseJson["severity"]);
 
-                newCase = vandalism;
-            }
-            else {
-                newCase = new Case(type, id, caseJson["severity"]);
-            }
+        if (caseJson.contains("propertyType")) {
+            vandalism->setPropertyType(caseJson["propertyType"]);
+        }
+        if (caseJson.contains("publicProperty")) {
+            vandalism->setPublicProperty(caseJson["publicProperty"]);
+        }
 
-            // Set common fields if they exist
-            if (caseJson.contains("description")) {
-                newCase->setDescription(caseJson["description"]);
-            }
-            if (caseJson.contains("reportedBy")) {
-                newCase->setReportedBy(caseJson["reportedBy"]);
-            }
-            if (caseJson.contains("date")) {
-                newCase->setDate(caseJson["date"]);
-            }
+    }
+    else {
+        record.emplace<Case>(type, id, caseJson["severity"].get<double>());
+    }
+    Case* newCase = caseView(record);
 
-            // Restore Prosecutor
-            if (caseJson.contains("assignedProsecutor")) {
-                auto& officerManager = OfficerRegistry::getInstance()->getManager();
-                int prosecutorId = caseJson["assignedProsecutor"]["id"];
-                auto& officerMap = officerManager.getOfficerMap();
-                auto it = officerMap.find(prosecutorId);
-                if (it != officerMap.end()) {
-                    Prosecutor* prosecutor = dynamic_cast<Prosecutor*>(it->second);
-                    if (prosecutor) {
-                        newCase->setAssignedProsecutor(prosecutor);
-                    }
-                }
-            }
+    // Set common fields if they exist
+    if (caseJson.contains("description")) {
+        newCase->setDescription(caseJson["description"]);
+    }
+    if (caseJson.contains("reportedBy")) {
+        newCase->setReportedBy(caseJson["reportedBy"]);
+    }
+    if (caseJson.contains("date")) {
+        newCase->setDate(caseJson["date"]);
+    }
+
+    // Prosecutor is linked by ID in resolveProsecutors()
+    if (caseJson.contains("assignedProsecutor")) {
+        pendingProsecutorLinks[id] = caseJson["assignedProsecutor"]["id"];
+    }
+
+    // Check if location data exists
+    if (caseJson.contains("location")) {
+        string address = caseJson["location"]["address"];
+        string city = caseJson["location"]["city"];
+        string state = caseJson["location"]["state"];
+        string zipCode = caseJson["location"].contains("zipCode") ?
+            caseJson["location"]["zipCode"].get<string>() : "";
+
+        newCase->setLocation(locations.intern(address, city, state, zipCode));
+    }
+
+    // Add the case
+    addCaseLocked(move(record));
+}
+
+bool CrimeManager::addCaseFromJson(const json& caseJson) {
+    // The loader trusts crimes.json and indexes these fields blindly
+    if (!caseJson.contains("id") || !caseJson.contains("type") || !caseJson.contains("severity")) {
+        throw invalid_argument("id, type and severity are required");
+    }
+    if (caseJson.contains("location")) {
+        const json& loc = caseJson["location"];
+        if (!loc.is_object() || !loc.contains("address") || !loc.contains("city") || !loc.contains("state")) {
+            throw invalid_argument("location needs address, city and state");
+        }
+    }
+    if (caseJson.contains("assignedProsecutor") &&
+        (!caseJson["assignedProsecutor"].is_object() || !caseJson["assignedProsecutor"].contains("id"))) {
+        throw invalid_argument("assignedProsecutor needs an id");
+    }
+    unique_lock<shared_mutex> lock(casesMutex);
+    if (findCaseLocked(caseJson.at("id").get<int>())) {
+        return false;
+    }
+    addCaseFromJsonLocked(caseJson);
+    return true;
+}
 
-            // Check if location data exists
-            if (caseJson.contains("location")) {
-                string address = caseJson["location"]["address"];
-                string city = caseJson["location"]["city"];
-                string state = caseJson["location"]["state"];
-                string zipCode = caseJson["location"].contains("zipCode") ?
-                    caseJson["location"]["zipCode"].get<string>() : "";
+size_t CrimeManager::addCasesBulk(CaseBulkLoad& load) {
+    unique_lock<shared_mutex> lock(casesMutex);
+
+    // In ID order, so the imported cases are stored, indexed and listed
+    // in the same order a sorted file would give
+    vector<size_t> order(load.cases.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    sort(order.begin(), order.end(), [&load](size_t a, size_t b) {
+        return caseView(load.cases[a])->getId() < caseView(load.cases[b])->getId();
+    });
+
+    // The import's locations, moved into this pool
+    vector<const Location*> pooled(load.locations.size());
+    vector<bool> cityRenamed(load.locations.size());
+    for (size_t id = 0; id < pooled.size(); id++) {
+        const Location* local = load.locations.get(static_cast<int>(id));
+        pooled[id] = locations.intern(*local);
+        cityRenamed[id] = pooled[id]->getCity() != local->getCity();
+    }
 
-                Location* loc = addLocation(address, city, state, zipCode);
-                newCase->setLocation(loc);
+    vector<pair<int, vector<string>>> docs;
+    docs.reserve(order.size());
+    records.reserve(order.size());
+    caseMap.reserve(caseMap.size() + order.size());
+    columns.reserve(columns.size() + order.size());
+    size_t added = 0;
+    for (size_t i : order) {
+        Case* c = caseView(load.cases[i]);
+        if (caseMap.count(c->getId())) {
+            // Taken since the importer checked, or twice in the input
+            load.statistics.removeCase(c);
+            load.prosecutorLinks.erase(c->getId());
+            continue;
+        }
+        if (c->getLocation()) {
+            int id = c->getLocation()->getId();
+            if (cityRenamed[id]) {
+                // Known here under another spelling; count it under this one
+                load.statistics.removeCase(c);
+                c->setLocation(pooled[id]);
+                load.statistics.addCase(c);
+            } else {
+                c->setLocation(pooled[id]);
             }
+        }
+        c = records.add(move(load.cases[i]));
+        caseMap.emplace(c->getId(), c);
+        columns.upsert(c);
+        if (approximateMode) {
+            sketches.addCase(c);
+        }
+        docs.push_back(make_pair(c->getId(), move(load.searchTerms[i])));
+        added++;
+    }
+
+    for (const auto& link : load.prosecutorLinks) {
+        pendingProsecutorLinks[link.first] = link.second;
+    }
+    if (trackStatistics) {
+        statistics.merge(load.statistics);
+    }
+    SearchRegistry::getInstance()->getIndex().indexDocuments(DocKind::Case, docs);
+    if (added > 0) {
+        state.markDirty();
+    }
+
+    load.cases.clear();
+    load.locations.clear();
+    load.searchTerms.clear();
+    load.prosecutorLinks.clear();
+    return added;
+}
+
+void CrimeManager::loadFromJson(const json& data) {
+    unique_lock<shared_mutex> lock(casesMutex);
+    // Clean up previous data
+    records.clear();
+    caseMap.clear();
+
+    // The cases pointing into the pool are gone
+    locations.clear();
+
+    // Reset statistics
+    statistics.clear();
+    sketches.clear();
+    columns.clear();
+    pendingProsecutorLinks.clear();
+    SearchRegistry::getInstance()->getIndex().clearKind(DocKind::Case);
 
-            // Update statistics
-            caseTypeCount[type]++;
-            if (newCase->getPriority() > 7.0) {
-                highPriorityCaseCount++;
+    try {
+        // Older files are a bare array of cases without statistics
+        bool hasStatistics = data.is_object() && data.contains("statistics");
+        json casesJson = data.is_object() ? data.value("cases", json::array()) : data;
+        trackStatistics = !hasStatistics;
+
+        // Process each case in the JSON array; the store allocates its blocks up front
+        records.reserve(casesJson.size());
+        caseMap.reserve(casesJson.size());
+        for (const auto& caseJson : casesJson) {
+            addCaseFromJsonLocked(caseJson);
+        }
+
+        trackStatistics = true;
+        if (hasStatistics) {
+            statistics.fromJson(data["statistics"]);
+            // A hand-edited or truncated file can disagree with its cases; fall back to a rebuild
+            if (!statisticsMatchColumnsLocked()) {
+                rebuildStatisticsLocked();
             }
+        }
+    }
+    catch (const exception&) {
+        trackStatistics = true;
+        rebuildStatisticsLocked();
+        throw;
+    }
+}
 
-            // Add the case
-            addCase(newCase);
+// Links cases to prosecutors in the officer roster. Links whose officer
+// isn't loaded yet stay pending and are kept on save.
+size_t CrimeManager::resolveProsecutors() {
+    unique_lock<shared_mutex> lock(casesMutex);
+    OfficerManager& officers = OfficerRegistry::getInstance()->getManager();
+    size_t resolved = 0;
+    for (auto it = pendingProsecutorLinks.begin(); it != pendingProsecutorLinks.end();) {
+        Case* c = findCaseLocked(it->first);
+        if (!c || c->getAssignedProsecutor()) {
+            it = pendingProsecutorLinks.erase(it);
+            continue;
+        }
+        auto prosecutor = dynamic_pointer_cast<const Prosecutor>(officers.findOfficer(it->second));
+        if (prosecutor) {
+            c->setAssignedProsecutor(prosecutor);
+            it = pendingProsecutorLinks.erase(it);
+            resolved++;
+        } else {
+            ++it;
         }
+    }
+    return resolved;
+}
 
-        cout << "Loaded " << cases.size() << " cases from file." << endl;
+size_t CrimeManager::getPendingProsecutorLinks() const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    return pendingProsecutorLinks.size();
+}
+
+void CrimeManager::unlinkProsecutors() {
+    unique_lock<shared_mutex> lock(casesMutex);
+    records.forEach([this](Case* c) {
+        if (c->getAssignedProsecutor()) {
+            pendingProsecutorLinks[c->getId()] = c->getAssignedProsecutor()->getId();
+            c->setAssignedProsecutor(nullptr);
+        }
+    });
+}
+
+void CrimeManager::rebuildStatisticsLocked() {
+    statistics.clear();
+    records.forEach([this](const Case* c) {
+        statistics.addCase(c);
+    });
+}
+
+static bool sameTotal(double a, double b) {
+    return fabs(a - b) <= 1e-6 * max(1.0, max(fabs(a), fabs(b)));  // The sums add in a different order
+}
+
+// Checks the persisted statistics against the columns with the aggregate kernels
+bool CrimeManager::statisticsMatchColumnsLocked() const {
+    if (statistics.getTotalCases() != static_cast<int>(columns.size())) return false;
+    if (statistics.getHighPriorityCount() !=
+        static_cast<int>(columns.countPriorityAbove(CrimeStatistics::HIGH_PRIORITY_THRESHOLD))) return false;
+    if (!sameTotal(statistics.getTotals().severitySum, columns.sumSeverity())) return false;
+    if (!sameTotal(statistics.getTotalStolenValue(), columns.sumValueByType(TAG_THEFT))) return false;
+    if (!sameTotal(statistics.getTotalDamageValue(), columns.sumValueByType(TAG_VANDALISM))) return false;
+
+    // The dictionary keeps cities whose cases are gone; they count 0 and have no bucket
+    const map<string, StatBucket>& byCity = statistics.getByCity();
+    const vector<string>& cities = columns.getCityDictionary();
+    vector<size_t> counts = columns.countByCity();
+    size_t usedCities = 0;
+    for (size_t code = 0; code < counts.size(); code++) {
+        if (counts[code] == 0) continue;
+        usedCities++;
+        auto it = byCity.find(cities[code]);
+        if (it == byCity.end() || it->second.count != static_cast<int>(counts[code])) return false;
     }
-    catch (const exception& e) {
-        cout << "Error loading data: " << e.what() << endl;
+    return usedCities == byCity.size();
+}
+
+// Matching rows come back in column order; show them by case ID like the case list
+static vector<Case*> casesForRows(const CaseColumnStore& columns, const vector<size_t>& rows) {
+    vector<Case*> result;
+    result.reserve(rows.size());
+    for (size_t row : rows) {
+        result.push_back(columns.caseAt(row));
+    }
+    sort(result.begin(), result.end(), [](Case* a, Case* b) { return a->getId() < b->getId(); });
+    return result;
+}
+
+vector<Case*> CrimeManager::findCasesByType(const string& type) const {
+    // The type column only distinguishes the built-in types; other names share TAG_OTHER
+    int32_t tag = CaseColumnStore::tagFor(type);
+    vector<Case*> result = casesForRows(columns, columns.filterByType(tag));
+    if (tag == TAG_OTHER) {
+        result.erase(remove_if(result.begin(), result.end(),
+            [&type](Case* c) { return c->getType() != type; }), result.end());
     }
+    return result;
+}
+
+vector<Case*> CrimeManager::findCasesByCity(const string& city) const {
+    // Any spelling of the city finds the pooled one the columns were built from
+    int cityId = locations.findCity(city);
+    if (cityId < 0) return vector<Case*>();
+    return casesForRows(columns, columns.filterByCity(columns.cityCode(locations.getCityName(cityId))));
 }
+
 void CrimeManager::filterCasesByType(const string& type) {
+    shared_lock<shared_mutex> lock(casesMutex);
     cout << "\nCases of type '" << type << "':\n";
     bool found = false;
 
-    for (auto& c : cases) {
-        if (c->getType() == type) {
-            c->displayDetails();
-            found = true;
-        }
+    for (auto* c : findCasesByType(type)) {
+        c->displayDetails();
+        found = true;
     }
 
     if (!found) {
@@ -464,7 +906,8 @@ void CrimeManager::filterCasesByType(const string& type) {
 }
 
 void CrimeManager::showDetailedCaseReport(int id) {
-    Case* c = findCase(id);
+    shared_lock<shared_mutex> lock(casesMutex);
+    Case* c = findCaseLocked(id);
     if (!c) {
         cout << "Case not found with ID: " << id << endl;
         return;
@@ -485,14 +928,28 @@ void CrimeManager::showDetailedCaseReport(int id) {
     }
 
     cout << "Case Priority: " << c->getPriority() << "\n";
+    vector<int> prisoners = JailRegistry::getInstance()->getPrisonersOf(id);
+    if (!prisoners.empty()) {
+        sort(prisoners.begin(), prisoners.end());
+        cout << "Linked Prisoners:";
+        for (int prisonerId : prisoners) cout << " " << prisonerId;
+        cout << "\n";
+    }
     cout << "===================================\n";
 }
 
+// Asks for the change first and applies it under the lock afterwards, so other
+// threads aren't blocked while the user is typing
 void CrimeManager::updateCaseDetails(int id) {
-    Case* c = findCase(id);
-    if (!c) {
-        cout << "Case not found with ID: " << id << endl;
-        return;
+    string type;
+    {
+        shared_lock<shared_mutex> lock(casesMutex);
+        Case* c = findCaseLocked(id);
+        if (!c) {
+            cout << "Case not found with ID: " << id << endl;
+            return;
+        }
+        type = c->getType();
     }
 
     int choice;
@@ -503,17 +960,17 @@ void CrimeManager::updateCaseDetails(int id) {
     cout << "4. Update Date\n";
 
     // Type-specific update options
-    if (c->getType() == "Theft") {
+    if (type == "Theft") {
         cout << "5. Update Stolen Value\n";
         cout << "6. Update Item Stolen\n";
         cout << "7. Update Recovery Status\n";
     }
-    else if (c->getType() == "Assault") {
+    else if (type == "Assault") {
         cout << "5. Update Weapon Used Status\n";
         cout << "6. Update Victim Name\n";
         cout << "7. Update Injury Severity\n";
     }
-    else if (c->getType() == "Vandalism") {
+    else if (type == "Vandalism") {
         cout << "5. Update Damage Value\n";
         cout << "6. Update Property Type\n";
         cout << "7. Update Public Property Status\n";
@@ -524,195 +981,199 @@ void CrimeManager::updateCaseDetails(int id) {
     cin >> choice;
     cin.ignore(); // Clear newline
 
+    if (choice == 0) {
+        return;
+    }
+    if (choice < 1 || choice > 7) {
+        cout << "Invalid choice.\n";
+        return;
+    }
+
     string strInput;
-    double numInput;
-    char charInput;
+    double numInput = 0.0;
+    char charInput = 'n';
+    function<void(Case*)> edit;
 
     switch (choice) {
     case 1: // Description
         cout << "Enter new description: ";
         getline(cin, strInput);
-        c->setDescription(strInput);
+        edit = [&](Case* c) {
+            c->setDescription(strInput);
+            SearchRegistry::getInstance()->getIndex().indexDocument(DocKind::Case, id, strInput);
+        };
         break;
     case 2: // Severity
         cout << "Enter new severity (1-10): ";
         cin >> numInput;
-        c->setSeverity(numInput);
+        edit = [&](Case* c) { c->setSeverity(numInput); };
         break;
     case 3: // Reported By
         cout << "Enter reporter name: ";
         getline(cin, strInput);
-        c->setReportedBy(strInput);
+        edit = [&](Case* c) { c->setReportedBy(strInput); };
         break;
     case 4: // Date
         cout << "Enter date (format YYYY-MM-DD): ";
         getline(cin, strInput);
-        c->setDate(strInput);
+        edit = [&](Case* c) { c->setDate(strInput); };
         break;
     case 5: // Type-specific fields
-        if (c->getType() == "Theft") {
+        if (type == "Theft") {
             cout << "Enter new stolen value: $";
             cin >> numInput;
-            dynamic_cast<Theft*>(c)->setStolenValue(numInput);
+            edit = [&](Case* c) { dynamic_cast<Theft*>(c)->setStolenValue(numInput); };
         }
-        else if (c->getType() == "Assault") {
+        else if (type == "Assault") {
             cout << "Was weapon used? (y/n): ";
             cin >> charInput;
-            dynamic_cast<Assault*>(c)->setWeaponUsed(charInput == 'y' || charInput == 'Y');
+            edit = [&](Case* c) { dynamic_cast<Assault*>(c)->setWeaponUsed(charInput == 'y' || charInput == 'Y'); };
         }
-        else if (c->getType() == "Vandalism") {
+        else if (type == "Vandalism") {
             cout << "Enter new damage value: $";
             cin >> numInput;
-            dynamic_cast<Vandalism*>(c)->setDamageValue(numInput);
+            edit = [&](Case* c) { dynamic_cast<Vandalism*>(c)->setDamageValue(numInput); };
         }
         break;
     case 6:
-        if (c->getType() == "Theft") {
+        if (type == "Theft") {
             cout << "Enter item stolen: ";
             cin.ignore();
             getline(cin, strInput);
-            dynamic_cast<Theft*>(c)->setItemStolen(strInput);
+            edit = [&](Case* c) { dynamic_cast<Theft*>(c)->setItemStolen(strInput); };
         }
-        else if (c->getType() == "Assault") {
+        else if (type == "Assault") {
             cout << "Enter victim name: ";
             getline(cin, strInput);
-            dynamic_cast<Assault*>(c)->setVictimName(strInput);
+            edit = [&](Case* c) { dynamic_cast<Assault*>(c)->setVictimName(strInput); };
         }
-        else if (c->getType() == "Vandalism") {
+        else if (type == "Vandalism") {
             cout << "Enter property type: ";
             getline(cin, strInput);
-            dynamic_cast<Vandalism*>(c)->setPropertyType(strInput);
+            edit = [&](Case* c) { dynamic_cast<Vandalism*>(c)->setPropertyType(strInput); };
         }
         break;
     case 7:
-        if (c->getType() == "Theft") {
+        if (type == "Theft") {
             cout << "Has item been recovered? (y/n): ";
             cin >> charInput;
-            dynamic_cast<Theft*>(c)->setRecovered(charInput == 'y' || charInput == 'Y');
+            edit = [&](Case* c) { dynamic_cast<Theft*>(c)->setRecovered(charInput == 'y' || charInput == 'Y'); };
         }
-        else if (c->getType() == "Assault") {
+        else if (type == "Assault") {
             cout << "Enter injury severity (1-10): ";
             cin >> numInput;
-            dynamic_cast<Assault*>(c)->setInjurySeverity(numInput);
+            edit = [&](Case* c) { dynamic_cast<Assault*>(c)->setInjurySeverity(numInput); };
         }
-        else if (c->getType() == "Vandalism") {
+        else if (type == "Vandalism") {
             cout << "Is it public property? (y/n): ";
             cin >> charInput;
-            dynamic_cast<Vandalism*>(c)->setPublicProperty(charInput == 'y' || charInput == 'Y');
+            edit = [&](Case* c) { dynamic_cast<Vandalism*>(c)->setPublicProperty(charInput == 'y' || charInput == 'Y'); };
         }
         break;
-    case 0:
-        return;
-    default:
-        cout << "Invalid choice.\n";
+    }
+
+    unique_lock<shared_mutex> lock(casesMutex);
+    // The case may have been deleted or reloaded while we were waiting for input
+    Case* c = findCaseLocked(id);
+    if (!c || c->getType() != type) {
+        cout << "Case " << id << " changed in the meantime; nothing updated.\n";
         return;
     }
 
+    // Edits can move the case between buckets, so take the old state out first
+    statistics.removeCase(c);
+    if (edit) {
+        edit(c);
+    }
+    statistics.addCase(c);
+    columns.upsert(c);
+    state.markDirty();
     cout << "Case updated successfully.YAYYYY\n";
 }
 
 void CrimeManager::generateStatistics() {
-    cout << "\n===== CRIME STATISTICS =====\n";
-
-    // Total case count
-    cout << "Total Cases: " << cases.size() << endl;
-
-    // Cases by type
-    cout << "\nCases by Type:\n";
-    for (const auto& pair : caseTypeCount) {
-        cout << pair.first << ": " << pair.second << " cases";
+    shared_lock<shared_mutex> lock(casesMutex);
+    // Reads the maintained buckets only - no pass over the cases
+    statistics.print(cout);
+    cout << "Distinct locations: " << locations.size() << " in " << locations.getCityCount() << " cities\n";
+}
 
-        // Calculate percentage
-        if (cases.size() > 0) {
-            double percentage = (static_cast<double>(pair.second) / cases.size()) * 100.0;
-            cout << " (" << percentage << "%)";
-        }
-        cout << endl;
+void CrimeManager::setApproximateMode(bool enabled) {
+    unique_lock<shared_mutex> lock(casesMutex);
+    if (enabled && !approximateMode) {
+        approximateMode = true;
+        rebuildSketchesLocked();
+    } else if (!enabled) {
+        approximateMode = false;
+        sketches.clear();
     }
+}
 
-    // High priority cases
-    cout << "\nHigh Priority Cases (Priority > 7.0): " << highPriorityCaseCount;
-    if (cases.size() > 0) {
-        double percentage = (static_cast<double>(highPriorityCaseCount) / cases.size()) * 100.0;
-        cout << " (" << percentage << "%)";
-    }
-    cout << endl;
+bool CrimeManager::isApproximateMode() const {
+    shared_lock<shared_mutex> lock(casesMutex);
+    return approximateMode;
+}
 
-    // Total stolen value (from theft cases)
-    cout << "Total Value of Stolen Items: $" << totalStolenValue << endl;
+void CrimeManager::rebuildSketchesLocked() {
+    sketches.clear();
+    records.forEach([this](const Case* c) {
+        sketches.addCase(c);
+    });
+}
 
-    // Location statistics
-    map<string, int> casesByCity;
-    for (auto& c : cases) {
-        if (c->getLocation()) {
-            casesByCity[c->getLocation()->getCity()]++;
-        }
-    }
+void CrimeManager::rebuildSketches() {
+    unique_lock<shared_mutex> lock(casesMutex);
+    rebuildSketchesLocked();
+}
 
-    cout << "\nCases by City:\n";
-    for (const auto& pair : casesByCity) {
-        cout << pair.first << ": " << pair.second << " cases\n";
+void CrimeManager::generateApproximateStatistics() {
+    unique_lock<shared_mutex> lock(casesMutex);  // May switch the sketches on
+    if (!approximateMode) {
+        approximateMode = true;
+        rebuildSketchesLocked();
+        cout << "Approximate mode enabled; sketches built from " << records.size() << " cases.\n";
     }
-
-    cout << "===========================\n";
+    sketches.print(cout);
 }
 
-void CrimeManager::deleteCase(int id) {
+bool CrimeManager::deleteCase(int id) {
+    unique_lock<shared_mutex> lock(casesMutex);
     auto it = caseMap.find(id);
     if (it == caseMap.end()) {
         cout << "Case not found with ID: " << id << endl;
-        return;
+        return false;
     }
 
-    // Find the index in the list to remove
     Case* caseToDelete = it->second;
-    size_t index = 0;
-    bool found = false;
-
-    for (size_t i = 0; i < cases.size(); i++) {
-        if (cases[i] == caseToDelete) {
-            index = i;
-            found = true;
-            break;
-        }
-    }
-
-    if (found) {
-        // Update statistics before deleting
-        caseTypeCount[caseToDelete->getType()]--;
-
-        if (caseToDelete->getType() == "Theft") {
-            Theft* theft = dynamic_cast<Theft*>(caseToDelete);
-            if (theft) {
-                totalStolenValue -= theft->getStolenValue();
-            }
-        }
-
-        if (caseToDelete->getPriority() > 7.0) {
-            highPriorityCaseCount--;
-        }
-
-        // Free memory and remove from containers
-        delete caseToDelete;
-        cases.erase(cases.begin() + index);
-        caseMap.erase(it);
+    // Update statistics before deleting
+    statistics.removeCase(caseToDelete);
+    columns.remove(id);
+    pendingProsecutorLinks.erase(id);
+
+    // Free the record and remove from containers
+    SearchRegistry::getInstance()->getIndex().removeDocument(DocKind::Case, id);
+    caseMap.erase(it);
+    if (records.remove(caseToDelete)) {
+        state.markDirty();
+        lock.unlock();
+        // Jails are never locked inside casesMutex
+        JailRegistry::getInstance()->dropCase(id);
 
         cout << "Case " << id << " deleted successfully.\n";
+        return true;
     }
-    else {
-        cout << "Error finding case in list.\n";
-    }
+    cout << "Error finding case in list.\n";
+    return false;
 }
 
 void CrimeManager::filterCasesByLocation(const string& city) {
+    shared_lock<shared_mutex> lock(casesMutex);
     cout << "\nCases in " << city << ":\n";
     bool found = false;
 
-    for (auto& c : cases) {
-        if (c->getLocation() && c->getLocation()->getCity() == city) {
-            c->displayDetails();
-            found = true;
-        }
+    for (auto* c : findCasesByCity(city)) {
+        c->displayDetails();
+        found = true;
     }
 
     if (!found) {
@@ -720,9 +1181,9 @@ void CrimeManager::filterCasesByLocation(const string& city) {
     }
 }
 
-void CrimeManager::assignProsecutorToCase(Case* c) {
+void CrimeManager::assignProsecutorToCase(int caseId) {
     auto& officerManager = OfficerRegistry::getInstance()->getManager();
-    vector<Prosecutor*> availableProsecutors = officerManager.getProsecutors();
+    vector<shared_ptr<const Prosecutor>> availableProsecutors = officerManager.getProsecutors();
     
     if (!availableProsecutors.empty()) {
         cout << "\nAvailable Prosecutors:\n";
@@ -736,7 +1197,15 @@ void CrimeManager::assignProsecutorToCase(Case* c) {
         cin >> prosecutorChoice;
         
         if (prosecutorChoice > 0 && prosecutorChoice <= static_cast<int>(availableProsecutors.size())) {
+            unique_lock<shared_mutex> lock(casesMutex);
+            Case* c = findCaseLocked(caseId);
+            if (!c) {
+                cout << "Case " << caseId << " no longer exists. No Prosecutor assigned.\n";
+                return;
+            }
             c->setAssignedProsecutor(availableProsecutors[prosecutorChoice - 1]);
+            pendingProsecutorLinks.erase(caseId);
+            state.markDirty();
             cout << "Prosecutor " << availableProsecutors[prosecutorChoice - 1]->getName() 
                  << " assigned to the case.\n";
         } else {
@@ -748,19 +1217,26 @@ void CrimeManager::assignProsecutorToCase(Case* c) {
 }
 
 void CrimeManager::reassignProsecutorToCase(int caseId) {
-    Case* c = findCase(caseId);
-    if (!c) {
-        cout << "Case not found with ID: " << caseId << endl;
-        return;
-    }
+    bool hasProsecutor = false;
+    {
+        shared_lock<shared_mutex> lock(casesMutex);
+        Case* c = findCaseLocked(caseId);
+        if (!c) {
+            cout << "Case not found with ID: " << caseId << endl;
+            return;
+        }
 
-    cout << "\nCurrent case details:\n";
-    c->displayDetails();
+        cout << "\nCurrent case details:\n";
+        c->displayDetails();
 
-    if (c->getAssignedProsecutor()) {
-        cout << "\nCurrently assigned Prosecutor: " << c->getAssignedProsecutor()->getName() 
-             << " (ID: " << c->getAssignedProsecutor()->getId() << ")" << endl;
-        
+        if (c->getAssignedProsecutor()) {
+            hasProsecutor = true;
+            cout << "\nCurrently assigned Prosecutor: " << c->getAssignedProsecutor()->getName() 
+                 << " (ID: " << c->getAssignedProsecutor()->getId() << ")" << endl;
+        }
+    }
+
+    if (hasProsecutor) {
         char choice;
         cout << "Do you want to reassign this case? (y/n): ";
         cin >> choice;
@@ -770,11 +1246,12 @@ void CrimeManager::reassignProsecutorToCase(int caseId) {
         }
     }
 
-    assignProsecutorToCase(c);
+    assignProsecutorToCase(caseId);
 }
 
 CrimeRegistry* CrimeRegistry::getInstance() {
-    if (!instance) instance = new CrimeRegistry();
+    static once_flag created;
+    call_once(created, []() { instance = new CrimeRegistry(); });
     return instance;
 }
 
@@ -782,9 +1259,11 @@ CrimeManager& CrimeRegistry::getManager() { return manager; }
 
 void crimeMenu() {
     CrimeManager& mgr = CrimeRegistry::getInstance()->getManager();
-    mgr.load();
+    // Data is loaded at startup; only pick up edits made to crimes.json since then
+    refreshChangedData();
     int choice;
     do {
+        persistChanges();  // Queue whatever the last option changed for the background flusher
         cout << "\n=== Crime Management System ===\n";
         cout << "1. Add Case\n";
         cout << "2. List Cases\n";
@@ -799,6 +1278,11 @@ void crimeMenu() {
         cout << "11. Delete Case\n";
         cout << "12. Assign/Reassign Prosecutor\n";
         cout << "13. Save\n";
+        cout << "14. Approximate Statistics (large archives)\n";
+        cout << "15. Benchmark Columnar Aggregation\n";
+        cout << "16. Reload from Disk\n";
+        cout << "17. Import Cases (CSV/JSONL)\n";
+        cout << "18. Rebuild or Turn Off Approximate Statistics\n";
         cout << "0. Exit\n";
         cout << "Choice: ";
         cin >> choice;
@@ -811,7 +1295,7 @@ void crimeMenu() {
             cin >> id;
 
             // Check if case ID already exists
-            if (mgr.findCase(id)) {
+            if (mgr.hasCase(id)) {
                 cout << "Error: Case ID " << id << " already exists.\n";
                 break;
             }
@@ -854,7 +1338,7 @@ void crimeMenu() {
                 theft->setDate(date);
 
                 mgr.addCase(theft);
-                mgr.assignProsecutorToCase(theft);
+                mgr.assignProsecutorToCase(id);
             }
             else if (type == "Assault") {
                 char weapon;
@@ -892,7 +1376,7 @@ void crimeMenu() {
 
                 // Assign Prosecutor
                 mgr.addCase(assault);
-                mgr.assignProsecutorToCase(assault);
+                mgr.assignProsecutorToCase(id);
             }
             else if (type == "Vandalism") {
                 double damageValue;
@@ -929,7 +1413,7 @@ void crimeMenu() {
                 vandalism->setDate(date);
 
                 mgr.addCase(vandalism);
-                mgr.assignProsecutorToCase(vandalism);
+                mgr.assignProsecutorToCase(id);
             }
             else {
                 double severity;
@@ -954,7 +1438,7 @@ void crimeMenu() {
                 generalCase->setDate(date);
 
                 mgr.addCase(generalCase);
-                mgr.assignProsecutorToCase(generalCase);
+                mgr.assignProsecutorToCase(id);
             }
             cout << "Case added successfully! You're a legend!\n";
             break;
@@ -970,12 +1454,7 @@ void crimeMenu() {
             cout << "Enter Case ID to find: ";
             cin >> id;
 
-            Case* found = mgr.findCase(id);
-            if (found) {
-                cout << "Found case: ";
-                found->displayDetails();
-            }
-            else {
+            if (!mgr.displayCase(id)) {
                 cout << "Case not found.\n";
             }
             break;
@@ -986,8 +1465,7 @@ void crimeMenu() {
             cout << "Enter Case ID to add location: ";
             cin >> id;
 
-            Case* found = mgr.findCase(id);
-            if (found) {
+            if (mgr.hasCase(id)) {
                 cin.ignore();
                 cout << "Enter address: ";
                 getline(cin, address);
@@ -998,8 +1476,8 @@ void crimeMenu() {
                 cout << "Enter ZIP/postal code: ";
                 getline(cin, zipCode);
 
-                Location* loc = mgr.addLocation(address, city, state, zipCode);
-                found->setLocation(loc);
+                const Location* loc = mgr.addLocation(address, city, state, zipCode);
+                mgr.setCaseLocation(id, loc);
                 cout << "Location added to case.\n";
             }
             else {
@@ -1065,13 +1543,56 @@ void crimeMenu() {
             mgr.reassignProsecutorToCase(id);
             break;
         }
-        case 13: // Save
-            mgr.save();
-            cout << "All data saved.Rest Assure\n";
+        case 13: // Save, in the background
+            persistChanges(true);
+            cout << "All data is being saved.Rest Assure\n";
+            break;
+        case 14: // Approximate statistics
+            mgr.generateApproximateStatistics();
+            break;
+        case 15: { // Columnar benchmark
+            size_t count;
+            cout << "Number of synthetic cases (e.g. 1000000): ";
+            cin >> count;
+            benchmarkColumnarAggregation(count);
+            break;
+        }
+        case 16: // Reload, discarding unsaved changes
+            reloadModuleData("Crimes");
             break;
+        case 17: { // Bulk import
+            string filename;
+            cout << "CSV or JSONL file to import: ";
+            cin >> filename;
+            try {
+                printImportReport(importCases(filename), cout);
+            } catch (const exception& e) {
+                cout << "Error: " << e.what() << endl;
+            }
+            break;
+        }
+        case 18: { // Sketches only follow additions; refresh or drop them
+            int action;
+            cout << "1. Rebuild sketches from all cases\n2. Turn approximate mode off\nChoice: ";
+            cin >> action;
+            if (action == 1) {
+                if (mgr.isApproximateMode()) {
+                    mgr.rebuildSketches();
+                } else {
+                    mgr.setApproximateMode(true);
+                }
+                cout << "Sketches rebuilt from " << mgr.getCaseCount() << " cases.\n";
+            } else if (action == 2) {
+                mgr.setApproximateMode(false);
+                cout << "Approximate mode off; sketches freed.\n";
+            } else {
+                cout << "Invalid choice.\n";
+            }
+            break;
+        }
         case 0: // Exit
             cout << "Be patient.We are saving your changings before exit...\n";
-            mgr.save();
+            persistChanges(true);
             cout << "Exiting program.Byeeeeeee!\n";
             break;
         default:
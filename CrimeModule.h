@@ -7,8 +7,18 @@
 #include <stdexcept>
 #include <algorithm> 
 #include <sstream> // For string stream operations
+#include <shared_mutex>
+#include <deque>
+#include <unordered_map>
+#include <variant>
+#include <memory>
 #include "nlohmann/json.hpp"
 #include "OfficerModule.h"
+#include "CrimeStatistics.h"
+#include "ApproxAnalytics.h"
+#include "CaseColumnStore.h"
+#include "ModuleState.h"
+#include "FlatHashMap.h"
 
 using json = nlohmann::json;
 using namespace std;
@@ -27,16 +37,16 @@ protected:
     string type;
     int caseId;
     double severity;
-    Location* location; // Association
+    const Location* location; // Association; an entry of the manager's LocationPool
     string description; 
     string reportedBy; 
     string date;
-    Prosecutor* assignedProsecutor; // Aggregation
+    shared_ptr<const Prosecutor> assignedProsecutor; // Aggregation; the roster version it was linked to
 
 public:
     Case(string t = "", int id = 0, double sev = 0.0)
         : type(t), caseId(id), severity(sev), location(nullptr),
-        description(""), reportedBy(""), date(""), assignedProsecutor(nullptr) {}
+        description(""), reportedBy(""), date("") {}
 
     // Setters
     void setType(const string& t) {
@@ -48,7 +58,7 @@ public:
     void setSeverity(double sev) {
         severity = sev;
     }
-    void setLocation(Location* loc) {
+    void setLocation(const Location* loc) {
         location = loc;
     }
     void setDescription(const string& desc) {
@@ -60,7 +70,7 @@ public:
     void setDate(const string& d) {
         date = d;
     }
-    void setAssignedProsecutor(Prosecutor* prosecutor) {
+    void setAssignedProsecutor(shared_ptr<const Prosecutor> prosecutor) {
         assignedProsecutor = prosecutor;
     }
 
@@ -72,11 +82,11 @@ public:
         return caseId;
     }
     double getSeverity() const { return severity; }
-    Location* getLocation() const { return location; }
+    const Location* getLocation() const { return location; }
     string getDescription() const { return description; }
     string getReportedBy() const { return reportedBy; }
     string getDate() const { return date; }
-    Prosecutor* getAssignedProsecutor() const { return assignedProsecutor; }
+    shared_ptr<const Prosecutor> getAssignedProsecutor() const { return assignedProsecutor; }
 
     // Polymorphism
     virtual void displayDetails() const override;
@@ -124,10 +134,14 @@ private:
     string city;
     string state;
     string zipCode;
+    int id;      // Set by LocationPool, -1 for a location outside a pool
+    int cityId;
+
+    friend class LocationPool;
 
 public:
     Location(const string& addr = "", const string& c = "", const string& s = "", const string& zip = "")
-        : address(addr), city(c), state(s), zipCode(zip) {}
+        : address(addr), city(c), state(s), zipCode(zip), id(-1), cityId(-1) {}
 
     // Setters
     void setAddress(const string& addr) { address = addr; }
@@ -140,6 +154,8 @@ public:
     string getCity() const { return city; }
     string getState() const { return state; }
     string getZipCode() const { return zipCode; } 
+    int getId() const { return id; }
+    int getCityId() const { return cityId; }
 
     friend ostream& operator<<(ostream& os, const Location& loc) {
         os << "Location: " << loc.address << ", " << loc.city << ", " << loc.state;
@@ -149,6 +165,35 @@ public:
     }
 };
 
+// Hash-consed locations: one shared entry per distinct place, so cases at the
+// same address share it and cases in the same city share a city ID. Entries are
+// matched on address, city, state and zip with case and extra spaces ignored;
+// the first spelling seen is the one kept. Entries are never removed or moved
+// (until clear()), so cases can point at them.
+class LocationPool {
+private:
+    deque<Location> entries;                 // By location ID
+    unordered_map<string, int> idByKey;      // Normalized address/city/state/zip -> location ID
+    vector<string> cityNames;                // By city ID
+    unordered_map<string, int> cityIdByKey;  // Normalized city -> city ID
+
+public:
+    LocationPool() {}
+    LocationPool(const LocationPool&) = delete;
+    LocationPool& operator=(const LocationPool&) = delete;
+
+    static string normalize(const string& text);  // Trimmed, lowercase, single spaces
+
+    const Location* intern(const string& address, const string& city, const string& state, const string& zipCode = "");
+    const Location* intern(const Location& loc);
+    const Location* get(int id) const;        // nullptr if there is no such entry
+    int findCity(const string& city) const;   // -1 if no entry is in that city
+    const string& getCityName(int cityId) const { return cityNames[cityId]; }
+    size_t size() const { return entries.size(); }
+    size_t getCityCount() const { return cityNames.size(); }
+    void clear();
+};
+
 class Theft : public Case {
 private:
     double stolenValue;
@@ -280,48 +325,177 @@ public:
     }
 };
 
-class CrimeManager {
-    vector<Case*> cases; // Aggregation
-    map<int, Case*> caseMap;
-    vector<Location*> locations; //aggregation
+// A case stored by value; the alternative says which kind it is. monostate
+// marks a free slot in a CaseRecordStore.
+typedef variant<monostate, Case, Theft, Assault, Vandalism> CaseRecord;
+
+// The record's case through the usual polymorphic API; nullptr for a free slot
+inline Case* caseView(CaseRecord& record) {
+    switch (record.index()) {
+    case 1: return &std::get<Case>(record);
+    case 2: return &std::get<Theft>(record);
+    case 3: return &std::get<Assault>(record);
+    case 4: return &std::get<Vandalism>(record);
+    default: return nullptr;
+    }
+}
+inline const Case* caseView(const CaseRecord& record) {
+    return caseView(const_cast<CaseRecord&>(record));
+}
+
+// Copies a case of any kind into a record
+CaseRecord toRecord(const Case& c);
+
+// Primary storage for the crime module's cases. Records sit in fixed-size
+// blocks allocated BLOCK_SIZE at a time, so loading n cases takes about
+// n / BLOCK_SIZE allocations, scans walk the blocks in order, and a stored
+// case never moves: the Case* from add() stays valid until remove().
+// Freed slots are reused by later adds.
+class CaseRecordStore {
+private:
+    static const size_t BLOCK_SIZE = 4096;
+    vector<unique_ptr<CaseRecord[]>> blocks;
+    size_t used;               // Slots handed out so far, live or free
+    size_t live;
+    vector<size_t> freeSlots;
 
-    //Statistics tracking
-    map<string, int> caseTypeCount;
-    double totalStolenValue;
-    int highPriorityCaseCount; // Cases with priority > 7.0
+    CaseRecord& slot(size_t i) { return blocks[i / BLOCK_SIZE][i % BLOCK_SIZE]; }
 
 public:
-    CrimeManager() : totalStolenValue(0.0), highPriorityCaseCount(0) {}
-
-    ~CrimeManager() {
-        for (auto& pair : caseMap) {
-            delete pair.second;
-        }
-        for (auto& loc : locations) {
-            delete loc;
+    CaseRecordStore() : used(0), live(0) {}
+    CaseRecordStore(const CaseRecordStore&) = delete;
+    CaseRecordStore& operator=(const CaseRecordStore&) = delete;
+
+    Case* add(CaseRecord&& record);
+    bool remove(const Case* c);    // False if c isn't stored here
+    void reserve(size_t n);        // Room for n cases without further allocation
+    void clear();
+    size_t size() const { return live; }
+
+    // Calls f(Case*) for every stored case, in slot order
+    template <typename F>
+    void forEach(F f) {
+        for (size_t b = 0; b * BLOCK_SIZE < used; b++) {
+            CaseRecord* block = blocks[b].get();
+            size_t end = used - b * BLOCK_SIZE < BLOCK_SIZE ? used - b * BLOCK_SIZE : BLOCK_SIZE;
+            for (size_t i = 0; i < end; i++) {
+                if (Case* c = caseView(block[i])) f(c);
+            }
         }
     }
+    template <typename F>
+    void forEach(F f) const {
+        const_cast<CaseRecordStore*>(this)->forEach([&f](Case* c) { f(static_cast<const Case*>(c)); });
+    }
+};
+
+// Cases built off-lock by a bulk import, plus what the manager would
+// otherwise work out one case at a time while holding its lock
+struct CaseBulkLoad {
+    vector<CaseRecord> cases;            // Moved into the manager's record store
+    LocationPool locations;              // The cases point here; re-interned into the manager's pool
+    vector<vector<string>> searchTerms;  // InvertedIndex::documentTerms() of each case's description
+    map<int, int> prosecutorLinks;       // caseId -> prosecutor ID, linked by resolveProsecutors()
+    CrimeStatistics statistics;          // Totals over `cases`
+};
+
+// Thread-safe: queries take casesMutex shared, changes take it exclusive. The
+// officer roster and the search index are locked after it, never before.
+// Case pointers are not handed out; callers get IDs, copies or JSON instead.
+class CrimeManager {
+    CaseRecordStore records; // Composition; owns every case
+    FlatHashMap<int, Case*> caseMap; // Views into records
+    LocationPool locations; // Aggregation; shared by the cases
+    mutable shared_mutex casesMutex;  // Guards everything below except state
+
+    //Statistics tracking, kept up to date on every add/update/delete
+    CrimeStatistics statistics;
+    bool trackStatistics;  // Off while load() restores persisted statistics
+
+    // Approximate analytics for very large archives (off by default)
+    CrimeSketches sketches;
+    bool approximateMode;
+
+    // Columnar copy of the numeric fields behind filters and priority listing
+    CaseColumnStore columns;
+
+    // caseId -> prosecutor ID read from file but not linked to the officer roster yet
+    map<int, int> pendingProsecutorLinks;
+
+    ModuleState state;  // Loaded/dirty tracking for crimes.json
+
+    // Callers of these hold casesMutex
+    void addCaseLocked(CaseRecord&& record);
+    Case* findCaseLocked(int id) const;
+    void addCaseFromJsonLocked(const json& caseJson);
+    json caseToJson(const Case* c) const;
+    vector<Case*> findCasesByType(const string& type) const;  // Sorted by ID
+    vector<Case*> findCasesByCity(const string& city) const;
+    void rebuildStatisticsLocked();
+    bool statisticsMatchColumnsLocked() const;
+    void rebuildSketchesLocked();
+
+public:
+    CrimeManager() : trackStatistics(true), approximateMode(false) {}
 
     // Function overloading: multiple addCase functions with different parameters
-    void addCase(Case* c);
+    void addCase(Case* c);  // Takes ownership: c is copied into the record store and deleted
     void addCase(int id, string type);  // Simpler version
     void addCase(int id, string type, double extraInfo);  // Version with extra info
 
     // New function to handle Prosecutor assignment
-    void assignProsecutorToCase(Case* c);
+    void assignProsecutorToCase(int caseId);
     void reassignProsecutorToCase(int caseId);
 
-    Location* addLocation(const string& address, const string& city, const string& state, const string& zipCode = "");
+    // Returns the pooled entry; an existing one if the place is already known
+    const Location* addLocation(const string& address, const string& city, const string& state, const string& zipCode = "");
+    bool setCaseLocation(int caseId, const Location* loc);
     void listCases();
     void listCasesByPriority();  // Function to demonstrate polymorphism
+    json toJson() const;  // Cases, prosecutor links and statistics as saved in crimes.json
+    // False if the ID is already taken; throws invalid_argument for an entry
+    // the loader can't take (no id/type/severity, incomplete location or prosecutor)
+    bool addCaseFromJson(const json& caseJson);
+    // Adds a whole import under one lock; cases whose ID is taken are deleted
+    // and left out. Returns how many were added.
+    size_t addCasesBulk(CaseBulkLoad& load);
     void save();
     void load();
-    Case* findCase(int id);      
+    // Builds cases from parsed crimes.json; prosecutors are left pending for resolveProsecutors()
+    void loadFromJson(const json& data);
+    size_t resolveProsecutors();
+    size_t getPendingProsecutorLinks() const;
+    void unlinkProsecutors();  // Back to IDs before the officer roster is replaced
+    ModuleState& getState() { return state; }
+
+    // Lookups
+    bool hasCase(int id) const;
+    size_t getCaseCount() const;
+    vector<int> getCaseIds() const;
+    json getCaseJson(int id) const;  // null when there is no such case
+    json findCasesJson(const string& type = "", const string& city = "") const;  // Sorted by ID; empty filters match all
+    bool displayCase(int id) const;
+    CrimeStatistics getStatistics() const;  // A copy
+    // Calls f(const Case&) for every case under the shared lock, in storage
+    // order; f must not call back into the manager
+    template <typename F>
+    void forEachCase(F f) const {
+        shared_lock<shared_mutex> lock(casesMutex);
+        records.forEach([&f](const Case* c) { f(*c); });
+    }
+
     void filterCasesByType(const string& type);
     void showDetailedCaseReport(int id);
     void updateCaseDetails(int id);
     void generateStatistics();
-    void deleteCase(int id);
+
+    // Approximate mode: bounded-memory sketches fed from addCase(). Edits and
+    // deletions reach them only through rebuildSketches() (crime menu option 18).
+    void setApproximateMode(bool enabled);
+    bool isApproximateMode() const;
+    void rebuildSketches();
+    void generateApproximateStatistics();
+    bool deleteCase(int id);
     void filterCasesByLocation(const string& city);
 };
 
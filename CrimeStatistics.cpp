@@ -0,0 +1,196 @@
+#include "CrimeStatistics.h"
+#include "CrimeModule.h"
+#include <cctype>
+using namespace std;
+
+const double CrimeStatistics::HIGH_PRIORITY_THRESHOLD = 7.0;
+
+json StatBucket::toJson() const {
+    return json{
+        {"count", count},
+        {"severitySum", severitySum},
+        {"stolenValueSum", stolenValueSum},
+        {"damageValueSum", damageValueSum}
+    };
+}
+
+StatBucket StatBucket::fromJson(const json& j) {
+    StatBucket b;
+    b.count = j.value("count", 0);
+    b.severitySum = j.value("severitySum", 0.0);
+    b.stolenValueSum = j.value("stolenValueSum", 0.0);
+    b.damageValueSum = j.value("damageValueSum", 0.0);
+    return b;
+}
+
+string CrimeStatistics::priorityBand(double priority) {
+    if (priority > HIGH_PRIORITY_THRESHOLD) return "High (> 7)";
+    if (priority >= 4.0) return "Medium (4 - 7)";
+    return "Low (< 4)";
+}
+
+string CrimeStatistics::dayKey(const string& date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') return "Unknown";
+    for (size_t i = 0; i < date.size(); i++) {
+        if (i == 4 || i == 7) continue;
+        if (!isdigit(static_cast<unsigned char>(date[i]))) return "Unknown";
+    }
+    return date;
+}
+
+static void addToBucket(map<string, StatBucket>& buckets, const string& key, const StatBucket& delta, int sign) {
+    StatBucket& b = buckets[key];
+    b.count += sign * delta.count;
+    b.severitySum += sign * delta.severitySum;
+    b.stolenValueSum += sign * delta.stolenValueSum;
+    b.damageValueSum += sign * delta.damageValueSum;
+    if (b.count <= 0) buckets.erase(key);  // Keep the maps down to live groups
+}
+
+void CrimeStatistics::apply(const Case* c, int sign) {
+    if (!c) return;
+
+    StatBucket delta;
+    delta.count = 1;
+    delta.severitySum = c->getSeverity();
+    if (const Theft* theft = dynamic_cast<const Theft*>(c)) {
+        delta.stolenValueSum = theft->getStolenValue();
+    } else if (const Vandalism* vandalism = dynamic_cast<const Vandalism*>(c)) {
+        delta.damageValueSum = vandalism->getDamageValue();
+    }
+
+    totals.count += sign * delta.count;
+    totals.severitySum += sign * delta.severitySum;
+    totals.stolenValueSum += sign * delta.stolenValueSum;
+    totals.damageValueSum += sign * delta.damageValueSum;
+
+    double priority = c->getPriority();
+    if (priority > HIGH_PRIORITY_THRESHOLD) {
+        highPriority.count += sign * delta.count;
+        highPriority.severitySum += sign * delta.severitySum;
+        highPriority.stolenValueSum += sign * delta.stolenValueSum;
+        highPriority.damageValueSum += sign * delta.damageValueSum;
+    }
+
+    addToBucket(byType, c->getType(), delta, sign);
+    addToBucket(byDay, dayKey(c->getDate()), delta, sign);
+    addToBucket(byPriorityBand, priorityBand(priority), delta, sign);
+    if (c->getLocation()) {
+        addToBucket(byCity, c->getLocation()->getCity(), delta, sign);
+    }
+}
+
+static void addBucket(StatBucket& into, const StatBucket& from) {
+    into.count += from.count;
+    into.severitySum += from.severitySum;
+    into.stolenValueSum += from.stolenValueSum;
+    into.damageValueSum += from.damageValueSum;
+}
+
+static void mergeBuckets(map<string, StatBucket>& into, const map<string, StatBucket>& from) {
+    for (const auto& pair : from) {
+        addToBucket(into, pair.first, pair.second, 1);
+    }
+}
+
+void CrimeStatistics::merge(const CrimeStatistics& other) {
+    addBucket(totals, other.totals);
+    addBucket(highPriority, other.highPriority);
+    mergeBuckets(byType, other.byType);
+    mergeBuckets(byCity, other.byCity);
+    mergeBuckets(byDay, other.byDay);
+    mergeBuckets(byPriorityBand, other.byPriorityBand);
+}
+
+void CrimeStatistics::clear() {
+    totals = StatBucket();
+    highPriority = StatBucket();
+    byType.clear();
+    byCity.clear();
+    byDay.clear();
+    byPriorityBand.clear();
+}
+
+static json bucketsToJson(const map<string, StatBucket>& buckets) {
+    json j = json::object();
+    for (const auto& pair : buckets) {
+        j[pair.first] = pair.second.toJson();
+    }
+    return j;
+}
+
+static void bucketsFromJson(const json& j, const char* key, map<string, StatBucket>& buckets) {
+    buckets.clear();
+    if (!j.contains(key)) return;
+    for (auto it = j[key].begin(); it != j[key].end(); ++it) {
+        buckets[it.key()] = StatBucket::fromJson(it.value());
+    }
+}
+
+json CrimeStatistics::toJson() const {
+    return json{
+        {"totals", totals.toJson()},
+        {"highPriority", highPriority.toJson()},
+        {"byType", bucketsToJson(byType)},
+        {"byCity", bucketsToJson(byCity)},
+        {"byDay", bucketsToJson(byDay)},
+        {"byPriorityBand", bucketsToJson(byPriorityBand)}
+    };
+}
+
+void CrimeStatistics::fromJson(const json& j) {
+    totals = j.contains("totals") ? StatBucket::fromJson(j["totals"]) : StatBucket();
+    highPriority = j.contains("highPriority") ? StatBucket::fromJson(j["highPriority"]) : StatBucket();
+    bucketsFromJson(j, "byType", byType);
+    bucketsFromJson(j, "byCity", byCity);
+    bucketsFromJson(j, "byDay", byDay);
+    bucketsFromJson(j, "byPriorityBand", byPriorityBand);
+}
+
+static void printBuckets(ostream& os, const map<string, StatBucket>& buckets, int total) {
+    for (const auto& pair : buckets) {
+        os << pair.first << ": " << pair.second.count << " cases";
+        if (total > 0) {
+            os << " (" << (static_cast<double>(pair.second.count) / total) * 100.0 << "%)";
+        }
+        os << endl;
+    }
+}
+
+void CrimeStatistics::print(ostream& os) const {
+    os << "\n===== CRIME STATISTICS =====\n";
+    os << "Total Cases: " << totals.count << endl;
+
+    os << "\nCases by Type:\n";
+    printBuckets(os, byType, totals.count);
+
+    os << "\nHigh Priority Cases (Priority > 7.0): " << highPriority.count;
+    if (totals.count > 0) {
+        os << " (" << (static_cast<double>(highPriority.count) / totals.count) * 100.0 << "%)";
+    }
+    os << endl;
+
+    os << "\nCases by Priority Band:\n";
+    printBuckets(os, byPriorityBand, totals.count);
+
+    os << "\nTotal Value of Stolen Items: $" << totals.stolenValueSum << endl;
+    os << "Total Value of Property Damage: $" << totals.damageValueSum << endl;
+    if (totals.count > 0) {
+        os << "Average Severity: " << totals.severitySum / totals.count << endl;
+    }
+
+    os << "\nCases by City:\n";
+    for (const auto& pair : byCity) {
+        os << pair.first << ": " << pair.second.count << " cases";
+        if (pair.second.stolenValueSum > 0) os << ", $" << pair.second.stolenValueSum << " stolen";
+        if (pair.second.damageValueSum > 0) os << ", $" << pair.second.damageValueSum << " damage";
+        os << "\n";
+    }
+
+    os << "\nCases by Day:\n";
+    for (const auto& pair : byDay) {
+        os << pair.first << ": " << pair.second.count << " cases\n";
+    }
+
+    os << "===========================\n";
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+#include <map>
+#include <iostream>
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+using namespace std;
+
+class Case;
+
+// Running totals for one group of cases
+struct StatBucket {
+    int count = 0;
+    double severitySum = 0.0;
+    double stolenValueSum = 0.0;
+    double damageValueSum = 0.0;
+
+    bool empty() const { return count == 0; }
+    json toJson() const;
+    static StatBucket fromJson(const json& j);
+};
+
+// Incrementally maintained crime statistics. Every change to a case goes
+// through removeCase(old state) / addCase(new state), so reading the numbers
+// never needs a scan over the cases - only over the buckets.
+class CrimeStatistics {
+private:
+    StatBucket totals;
+    StatBucket highPriority;  // Priority > HIGH_PRIORITY_THRESHOLD
+    map<string, StatBucket> byType;
+    map<string, StatBucket> byCity;
+    map<string, StatBucket> byDay;           // "YYYY-MM-DD", or "Unknown"
+    map<string, StatBucket> byPriorityBand;
+
+    void apply(const Case* c, int sign);
+
+public:
+    static const double HIGH_PRIORITY_THRESHOLD;
+
+    static string priorityBand(double priority);
+    static string dayKey(const string& date);
+
+    void addCase(const Case* c) { apply(c, 1); }
+    void removeCase(const Case* c) { apply(c, -1); }
+    void merge(const CrimeStatistics& other);  // Adds another set of cases' totals, e.g. built on another thread
+    void clear();
+
+    int getTotalCases() const { return totals.count; }
+    int getHighPriorityCount() const { return highPriority.count; }
+    double getTotalStolenValue() const { return totals.stolenValueSum; }
+    double getTotalDamageValue() const { return totals.damageValueSum; }
+    const StatBucket& getTotals() const { return totals; }
+    const map<string, StatBucket>& getByType() const { return byType; }
+    const map<string, StatBucket>& getByCity() const { return byCity; }
+    const map<string, StatBucket>& getByDay() const { return byDay; }
+    const map<string, StatBucket>& getByPriorityBand() const { return byPriorityBand; }
+
+    json toJson() const;
+    void fromJson(const json& j);
+    void print(ostream& os) const;
+};
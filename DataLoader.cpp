@@ -0,0 +1,271 @@
+#include "DataLoader.h"
+#include "OfficerModule.h"
+#include "CrimeModule.h"
+#include "ForensicsModule.h"
+#include "PatrolVehiclesModule.h"
+#include "JailModule.h"
+#include "SearchIndex.h"
+#include "PersistenceCoordinator.h"
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iomanip>
+using namespace std;
+
+typedef chrono::steady_clock LoadClock;
+
+static double elapsedMs(LoadClock::time_point start) {
+    return chrono::duration<double, milli>(LoadClock::now() - start).count();
+}
+
+static size_t arraySize(const json& j, const string& key) {
+    return j.is_object() && j.contains(key) && j[key].is_array() ? j[key].size() : 0;
+}
+
+// Modules holding officer pointers, in the order they get linked
+static const char* const LINKED_MODULES[] = { "Crimes", "Jail", "Forensics", "Patrols" };
+
+// Every data file, officers first. Builders only touch their own module
+// (and the search index, which locks internally), so they can run concurrently.
+vector<ModuleSource> DataLoader::sources() {
+    OfficerManager& officers = OfficerRegistry::getInstance()->getManager();
+    CrimeManager& crimes = CrimeRegistry::getInstance()->getManager();
+    ForensicLab& lab = ForensicLabRegistry::getInstance()->getLab();
+    PatrolFleet& fleet = FleetRegistry::getInstance()->getFleet();
+    JailRegistry* jails = JailRegistry::getInstance();
+    SearchRegistry::getInstance();
+
+    vector<ModuleSource> list;
+    list.push_back({ "Officers", "officers.json", &officers.getState(),
+        [&officers](const json& j) {
+            officers.fromJson(j);
+            return officers.getOfficerCount();
+        },
+        [&officers]() { return officers.toJson(); } });
+    list.push_back({ "Crimes", "crimes.json", &crimes.getState(),
+        [&crimes](const json& j) {
+            crimes.loadFromJson(j);
+            return j.is_array() ? j.size() : arraySize(j, "cases");
+        },
+        [&crimes]() { return crimes.toJson(); } });
+    list.push_back({ "Forensics", "forensics_data.json", &lab.getState(),
+        [&lab](const json& j) {
+            lab.loadFromJson(j);
+            return arraySize(j, "evidences") + arraySize(j, "fieldAgents") + arraySize(j, "labTechs");
+        },
+        [&lab]() { return lab.toJson(); } });
+    list.push_back({ "Vehicles", "vehicles.json", &fleet.getVehicleState(),
+        [&fleet](const json& j) {
+            fleet.loadVehiclesFromJson(j);
+            return j.size();
+        },
+        [&fleet]() { return fleet.vehiclesToJson(); } });
+    list.push_back({ "Patrols", "patrolling.json", &fleet.getPatrolState(),
+        [&fleet](const json& j) {
+            fleet.loadPatrolsFromJson(j);
+            return j.size();
+        },
+        [&fleet]() { return fleet.patrolsToJson(); } });
+    // One file per facility, so they load in parallel like the other modules
+    for (size_t i = 0; i < jails->getFacilityCount(); i++) {
+        Jail& jail = jails->getJail(i);
+        list.push_back({ "Jail", jail.getDataFile(), &jail.getState(),
+            [&jail](const json& j) {
+                jail.loadFromJson(j);
+                return arraySize(j, "prisoners");
+            },
+            [&jail]() { return jail.toJson(); } });
+    }
+    return list;
+}
+
+// Reads, parses and builds one module; runs on a pool thread at startup
+ModuleLoadReport DataLoader::loadModule(const ModuleSource& source) {
+    ModuleLoadReport rep(source.module, source.filename);
+    try {
+        auto start = LoadClock::now();
+        FileStamp stamp = FileStamp::of(source.filename);
+        ifstream file(source.filename);
+        if (!file.is_open()) {
+            // Nothing saved yet is not an error; the stamp notices when the file appears
+            source.state->markLoaded(source.filename, stamp);
+            rep.ok = true;
+            return rep;
+        }
+        rep.found = true;
+        json data;
+        file >> data;
+        file.close();
+        rep.parseMs = elapsedMs(start);
+
+        start = LoadClock::now();
+        rep.records = source.build(data);
+        rep.buildMs = elapsedMs(start);
+        source.state->markLoaded(source.filename, stamp);
+        source.state->clearDirty();
+        rep.ok = true;
+    } catch (const exception& e) {
+        rep.error = e.what();
+    }
+    return rep;
+}
+
+ModuleLoadReport* DataLoader::report(const string& module) {
+    for (auto& rep : reports) {
+        if (rep.module == module) return &rep;
+    }
+    return nullptr;
+}
+
+// Resolves one module's officer IDs against the current roster
+void DataLoader::linkModule(const string& module) {
+    auto start = LoadClock::now();
+    size_t unresolved = 0;
+    if (module == "Crimes") {
+        CrimeManager& crimes = CrimeRegistry::getInstance()->getManager();
+        crimes.resolveProsecutors();
+        unresolved = crimes.getPendingProsecutorLinks();
+    } else if (module == "Jail") {
+        JailRegistry* jails = JailRegistry::getInstance();
+        for (size_t i = 0; i < jails->getFacilityCount(); i++) {
+            jails->getJail(i).resolveCellOfficers();
+            unresolved += jails->getJail(i).getPendingOfficerLinks();
+        }
+    } else if (module == "Forensics") {
+        ForensicLab& lab = ForensicLabRegistry::getInstance()->getLab();
+        lab.resolveFieldAgentOfficers();
+        unresolved = lab.getPendingOfficerLinks();
+    } else if (module == "Patrols") {
+        unresolved = FleetRegistry::getInstance()->getFleet().resolvePatrolConstables();
+    } else {
+        return;
+    }
+    ModuleLoadReport* rep = report(module);
+    if (rep) {
+        rep->unresolved = unresolved;
+        rep->linkMs = elapsedMs(start);
+    }
+}
+
+void DataLoader::loadAll(size_t numThreads) {
+    auto start = LoadClock::now();
+    reports.clear();
+    workers = numThreads > 0 ? numThreads : 1;
+    vector<ModuleSource> list = sources();
+
+    // Parse phase: every file at once
+    vector<future<ModuleLoadReport>> pending;
+    {
+        ThreadPool pool(workers);
+        for (const auto& source : list) {
+            pending.push_back(pool.enqueue([source]() { return loadModule(source); }));
+        }
+        for (auto& f : pending) {
+            reports.push_back(f.get());
+        }
+    }
+
+    // Link phase, in dependency order: everything below points into the officer roster
+    for (const char* module : LINKED_MODULES) {
+        linkModule(module);
+    }
+    totalMs = elapsedMs(start);
+}
+
+size_t DataLoader::reload(const string& onlyModule, bool force) {
+    auto start = LoadClock::now();
+    reports.clear();
+    workers = 1;
+
+    vector<ModuleSource> chosen;
+    bool officersReloaded = false;
+    for (const auto& source : sources()) {
+        if (!onlyModule.empty() && source.module != onlyModule) continue;
+        if (!force && source.state->isLoaded() && !source.state->changedOnDisk()) continue;
+        if (!force && source.state->isDirty()) {
+            cout << "Warning: " << source.filename << " changed on disk, but " << source.module
+                 << " has unsaved changes. Keeping the data in memory.\n";
+            continue;
+        }
+        if (source.module == "Officers") officersReloaded = true;
+        chosen.push_back(source);
+    }
+    if (chosen.empty()) return 0;
+
+    if (officersReloaded) {
+        // The roster is about to be replaced; nothing may keep pointing into it
+        CrimeRegistry::getInstance()->getManager().unlinkProsecutors();
+        JailRegistry* jails = JailRegistry::getInstance();
+        for (size_t i = 0; i < jails->getFacilityCount(); i++) {
+            jails->getJail(i).unlinkCellOfficers();
+        }
+        ForensicLabRegistry::getInstance()->getLab().unlinkFieldAgentOfficers();
+    }
+
+    // Officers come first in sources(), so the roster is rebuilt before anything links to it
+    for (const auto& source : chosen) {
+        PersistenceCoordinator::getInstance()->discard(source.filename);
+        reports.push_back(loadModule(source));
+    }
+
+    for (const char* module : LINKED_MODULES) {
+        if (officersReloaded || report(module)) {
+            linkModule(module);
+        }
+    }
+    totalMs = elapsedMs(start);
+    return chosen.size();
+}
+
+void DataLoader::printReport(ostream& os) const {
+    double serialMs = 0.0;
+    os << fixed << setprecision(2);
+    os << left << setw(11) << "Module" << setw(21) << "File" << right
+       << setw(8) << "Records" << setw(10) << "Parse ms" << setw(10) << "Build ms" << setw(9) << "Link ms" << "\n";
+    for (const auto& rep : reports) {
+        os << left << setw(11) << rep.module << setw(21) << rep.filename << right;
+        if (!rep.ok) {
+            os << "  FAILED: " << rep.error << "\n";
+            continue;
+        }
+        if (!rep.found) {
+            os << "  (no saved data)\n";
+            continue;
+        }
+        os << setw(8) << rep.records << setw(10) << rep.parseMs << setw(10) << rep.buildMs
+           << setw(9) << rep.linkMs;
+        if (rep.unresolved > 0) {
+            os << "  " << rep.unresolved << " unresolved officer reference(s)";
+        }
+        os << "\n";
+        serialMs += rep.parseMs + rep.buildMs + rep.linkMs;
+    }
+    os << "Loaded in " << totalMs << " ms on " << workers << " thread(s)"
+       << " (modules took " << serialMs << " ms combined)\n";
+    os.unsetf(ios::floatfield);
+    os << setprecision(6);
+}
+
+void loadAllData() {
+    cout << "\nLoading system data...\n";
+    DataLoader loader;
+    loader.loadAll();
+    loader.printReport(cout);
+}
+
+void refreshChangedData() {
+    DataLoader loader;
+    if (loader.reload() > 0) {
+        cout << "\nData files changed on disk; reloaded:\n";
+        loader.printReport(cout);
+    }
+}
+
+void reloadModuleData(const string& module) {
+    DataLoader loader;
+    if (loader.reload(module, true) > 0) {
+        loader.printReport(cout);
+    } else {
+        cout << "Unknown module: " << module << "\n";
+    }
+}
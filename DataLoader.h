@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <iostream>
+#include <functional>
+#include "ThreadPool.h"
+#include "ModuleState.h"
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+// Outcome and timing for one data file loaded at startup
+struct ModuleLoadReport {
+    string module;
+    string filename;
+    bool found;
+    bool ok;
+    size_t records;
+    double parseMs;  // Reading the file and parsing the JSON
+    double buildMs;  // Building the module's objects from the parsed JSON
+    double linkMs;   // Resolving references into other modules (0 if none)
+    size_t unresolved;
+    string error;
+
+    ModuleLoadReport(const string& m = "", const string& f = "")
+        : module(m), filename(f), found(false), ok(false), records(0),
+          parseMs(0.0), buildMs(0.0), linkMs(0.0), unresolved(0) {}
+};
+
+// One data file, how to build its module from the parsed JSON and how to
+// turn the module back into JSON for saving
+struct ModuleSource {
+    string module;
+    string filename;
+    ModuleState* state;
+    function<size_t(const json&)> build;  // Returns the number of records loaded
+    function<json()> snapshot;            // Called on the autosave thread; takes the manager's shared lock
+};
+
+// Loads every module's data file at startup.
+// Files are read, parsed and built into objects concurrently on a thread pool.
+// References into the officer roster (prosecutors in cases, COs in cells,
+// head constables in field agents, constables in patrols) stay as IDs until a
+// link phase that runs on the calling thread once the officers are built.
+class DataLoader {
+    vector<ModuleLoadReport> reports;
+    double totalMs;
+    size_t workers;
+
+    static ModuleLoadReport loadModule(const ModuleSource& source);
+    ModuleLoadReport* report(const string& module);
+    void linkModule(const string& module);
+
+public:
+    DataLoader() : totalMs(0.0), workers(0) {}
+
+    static vector<ModuleSource> sources();  // Every data file (one per jail facility), officers first
+
+    void loadAll(size_t numThreads = ThreadPool::defaultThreadCount());
+
+    // Reloads modules whose files changed on disk since they were last read or
+    // written; `force` reloads regardless, `onlyModule` limits it to one module.
+    // Modules with unsaved changes are skipped unless forced. Reloading the
+    // officer roster first turns every officer link in other modules back
+    // into an ID, then relinks them, so none keeps pointing at the old roster.
+    // Returns the number of modules reloaded.
+    size_t reload(const string& onlyModule = "", bool force = false);
+    const vector<ModuleLoadReport>& getReports() const { return reports; }
+    double getTotalMs() const { return totalMs; }
+    void printReport(ostream& os) const;
+};
+
+void loadAllData();
+void refreshChangedData();                     // Cheap check on menu entry: one stat() per file
+void reloadModuleData(const string& module);   // Explicit reload; discards unsaved changes
@@ -0,0 +1,237 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <stdexcept>
+#include <algorithm>
+using namespace std;
+
+// Hash for integer IDs. Multiplying by 2^64/phi (Fibonacci hashing) spreads
+// runs of consecutive IDs evenly over the table; FlatHashMap takes the top bits.
+template<typename K>
+struct FlatIdHash {
+    uint64_t operator()(K key) const {
+        return static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+    }
+};
+
+// Open-addressing hash map for the ID indexes of the registries. Entries sit
+// in one flat array with linear probing, so there is no heap node per entry
+// and a lookup usually reads one or two neighbouring slots. Erase shifts the
+// following entries back instead of leaving tombstones, so lookups never slow
+// down after many deletes.
+//
+// Mostly a drop-in for map<K, V> with K an integer ID: find, count, [],
+// emplace, insert_or_assign, erase and iteration, with entries as pair<const K, V>.
+// Differences from map: iteration is in no particular order (use sortedKeys()
+// where the output order matters), and any insert or erase invalidates
+// iterators and references (a rehash moves everything).
+template<typename K, typename V, typename Hash = FlatIdHash<K>>
+class FlatHashMap {
+public:
+    typedef pair<const K, V> value_type;
+
+private:
+    typedef typename aligned_storage<sizeof(value_type), alignof(value_type)>::type Slot;
+
+    unique_ptr<Slot[]> slots;
+    vector<uint8_t> used;  // 1 where slots[i] holds an entry
+    size_t count_;
+    size_t mask;           // capacity - 1; capacity is a power of two
+    int shift;             // 64 - log2(capacity)
+    Hash hasher;
+
+    // Kept below 80% full; linear probing degrades quickly past that
+    static size_t maxEntries(size_t capacity) { return capacity - capacity / 5; }
+
+    value_type* slot(size_t i) const { return reinterpret_cast<value_type*>(&slots[i]); }
+    size_t home(const K& key) const { return static_cast<size_t>(hasher(key) >> shift); }
+    size_t capacity() const { return slots ? mask + 1 : 0; }
+
+    size_t findIndex(const K& key) const {
+        if (count_ == 0) return capacity();
+        for (size_t i = home(key);; i = (i + 1) & mask) {
+            if (!used[i]) return capacity();
+            if (slot(i)->first == key) return i;
+        }
+    }
+
+    // First free slot on key's probe path; the key must not be present
+    size_t freeIndex(const K& key) const {
+        size_t i = home(key);
+        while (used[i]) i = (i + 1) & mask;
+        return i;
+    }
+
+    void rehash(size_t newCapacity) {
+        unique_ptr<Slot[]> oldSlots(move(slots));
+        vector<uint8_t> oldUsed(move(used));
+        size_t oldCapacity = oldUsed.size();
+
+        slots.reset(new Slot[newCapacity]);
+        used.assign(newCapacity, 0);
+        mask = newCapacity - 1;
+        shift = 64;
+        for (size_t c = newCapacity; c > 1; c >>= 1) shift--;
+
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (!oldUsed[i]) continue;
+            value_type* entry = reinterpret_cast<value_type*>(&oldSlots[i]);
+            size_t j = freeIndex(entry->first);
+            new (slot(j)) value_type(move(*entry));
+            used[j] = 1;
+            entry->~value_type();
+        }
+    }
+
+    void growFor(size_t entries) {
+        size_t cap = capacity() ? capacity() : 16;
+        while (maxEntries(cap) < entries) cap *= 2;
+        if (cap != capacity()) rehash(cap);
+    }
+
+    void eraseIndex(size_t hole) {
+        slot(hole)->~value_type();
+        // Pull later entries of the same run back so no probe path has a gap
+        for (size_t j = (hole + 1) & mask; used[j]; j = (j + 1) & mask) {
+            size_t h = home(slot(j)->first);
+            bool canMove = hole <= j ? (h <= hole || h > j) : (h <= hole && h > j);
+            if (!canMove) continue;
+            new (slot(hole)) value_type(move(*slot(j)));
+            slot(j)->~value_type();
+            hole = j;
+        }
+        used[hole] = 0;
+        count_--;
+    }
+
+    void destroyAll() {
+        for (size_t i = 0; i < used.size(); i++) {
+            if (used[i]) slot(i)->~value_type();
+        }
+    }
+
+public:
+    template<typename MapPtr, typename Ref>
+    class Iterator {
+        MapPtr map;
+        size_t index;
+        void skip() { while (index < map->used.size() && !map->used[index]) index++; }
+    public:
+        Iterator(MapPtr m, size_t i) : map(m), index(i) { skip(); }
+        Ref operator*() const { return *map->slot(index); }
+        typename remove_reference<Ref>::type* operator->() const { return map->slot(index); }
+        Iterator& operator++() { index++; skip(); return *this; }
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+        size_t slotIndex() const { return index; }
+    };
+    typedef Iterator<FlatHashMap*, value_type&> iterator;
+    typedef Iterator<const FlatHashMap*, const value_type&> const_iterator;
+
+    FlatHashMap() : count_(0), mask(0), shift(64) {}
+    FlatHashMap(const FlatHashMap& other) : count_(0), mask(0), shift(64), hasher(other.hasher) {
+        reserve(other.count_);
+        for (const value_type& entry : other) emplace(entry.first, entry.second);
+    }
+    FlatHashMap(FlatHashMap&& other) noexcept
+        : slots(move(other.slots)), used(move(other.used)), count_(other.count_),
+          mask(other.mask), shift(other.shift), hasher(other.hasher) {
+        other.count_ = 0;
+        other.mask = 0;
+        other.shift = 64;
+    }
+    FlatHashMap& operator=(FlatHashMap other) {
+        swap(other);
+        return *this;
+    }
+    ~FlatHashMap() { destroyAll(); }
+
+    void swap(FlatHashMap& other) {
+        std::swap(slots, other.slots);
+        std::swap(used, other.used);
+        std::swap(count_, other.count_);
+        std::swap(mask, other.mask);
+        std::swap(shift, other.shift);
+        std::swap(hasher, other.hasher);
+    }
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    void clear() {
+        destroyAll();
+        slots.reset();
+        used.clear();
+        count_ = 0;
+        mask = 0;
+        shift = 64;
+    }
+
+    // Room for n entries without a rehash
+    void reserve(size_t n) { if (n > 0) growFor(n); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, used.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, used.size()); }
+
+    iterator find(const K& key) { return iterator(this, findIndex(key)); }
+    const_iterator find(const K& key) const { return const_iterator(this, findIndex(key)); }
+    size_t count(const K& key) const { return findIndex(key) < capacity() ? 1 : 0; }
+
+    template<typename... Args>
+    pair<iterator, bool> emplace(const K& key, Args&&... args) {
+        size_t i = findIndex(key);
+        if (i < capacity()) return make_pair(iterator(this, i), false);
+        growFor(count_ + 1);
+        i = freeIndex(key);
+        new (slot(i)) value_type(piecewise_construct, forward_as_tuple(key), forward_as_tuple(std::forward<Args>(args)...));
+        used[i] = 1;
+        count_++;
+        return make_pair(iterator(this, i), true);
+    }
+
+    pair<iterator, bool> insert(const value_type& entry) { return emplace(entry.first, entry.second); }
+
+    template<typename M>
+    pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        pair<iterator, bool> result = emplace(key, std::forward<M>(value));
+        if (!result.second) result.first->second = std::forward<M>(value);
+        return result;
+    }
+
+    V& operator[](const K& key) { return emplace(key).first->second; }
+
+    V& at(const K& key) {
+        size_t i = findIndex(key);
+        if (i >= capacity()) throw out_of_range("FlatHashMap::at: key not found");
+        return slot(i)->second;
+    }
+    const V& at(const K& key) const {
+        size_t i = findIndex(key);
+        if (i >= capacity()) throw out_of_range("FlatHashMap::at: key not found");
+        return slot(i)->second;
+    }
+
+    // Keys in ascending order, for listings and saved files
+    vector<K> sortedKeys() const {
+        vector<K> keys;
+        keys.reserve(count_);
+        for (const value_type& entry : *this) keys.push_back(entry.first);
+        sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    size_t erase(const K& key) {
+        size_t i = findIndex(key);
+        if (i >= capacity()) return 0;
+        eraseIndex(i);
+        return 1;
+    }
+    void erase(iterator it) { eraseIndex(it.slotIndex()); }
+};
@@ -1,14 +1,18 @@
 #ifndef FORENSICSMODULE_H
 #define FORENSICSMODULE_H
 
-#include "crimeModule.h" // Needed to access CrimeManager
+#include "CrimeModule.h" // Needed to access CrimeManager
 #include <string>
 #include <fstream>
 #include <iostream>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <shared_mutex>
 #include "nlohmann/json.hpp"
 #include "OfficerModule.h"
+#include "ThreadPool.h"
+#include "ModuleState.h"
 
 using json = nlohmann::json;
 using namespace std;
@@ -26,24 +30,29 @@ private:
     string description;
     bool isProcessed;
     int caseId;  //association with case
+    string findings;  // Filled in by the analysis pipeline
 
 public:
     Evidence(int i = 0, const string& desc = "", bool processed = false, int cid = 0)
-        : evidenceId(i), description(desc), isProcessed(processed), caseId(cid) {}
+        : evidenceId(i), description(desc), isProcessed(processed), caseId(cid), findings("") {}
 
     // Getters
     int getId() const { return evidenceId; }
     string getDescription() const { return description; }
     bool getStatus() const { return isProcessed; }
     int getCaseId() const { return caseId; }
+    string getFindings() const { return findings; }
 
     // Setters
     void setDescription(const string& desc) { description = desc; }
     void setStatus(bool processed) { isProcessed = processed; }
     void setCaseId(int cid) { caseId = cid; }
     void markProcessed() { isProcessed = true; }
+    void setFindings(const string& f) { findings = f; }
+    void addFinding(const string& f) { findings += (findings.empty() ? "" : "; ") + f; }
 
     void displayForensicsInfo() const override;
+    json toJson() const;  // As stored in forensics_data.json
 
     friend ostream& operator<<(ostream& os, const Evidence& ev) {
         os << "Evidence #" << ev.evidenceId << " | Case: " << ev.caseId 
@@ -98,17 +107,26 @@ public:
 
 class FieldAgent : public ForensicExpert {
 private:
-    HeadConstable* assignedOfficer;  // Association with HeadConstable
+    shared_ptr<const HeadConstable> assignedOfficer;  // Association with HeadConstable
+    int headConstableId;             // Kept so the link survives until officers are loaded
 
 public:
-    FieldAgent(HeadConstable* officer, const string& n = "", int i = 0, int cid = -1)
-        : ForensicExpert(n, i), assignedOfficer(officer) {
+    FieldAgent(shared_ptr<const HeadConstable> officer, const string& n = "", int i = 0, int cid = -1)
+        : ForensicExpert(n, i), assignedOfficer(officer), headConstableId(officer ? officer->getId() : -1) {
         setAssignedCaseId(cid);
     }
 
     string getSpecialty() const override { return "Field Agent"; }
-    HeadConstable* getAssignedOfficer() const { return assignedOfficer; }
-    void setAssignedOfficer(HeadConstable* officer) { assignedOfficer = officer; }
+    shared_ptr<const HeadConstable> getAssignedOfficer() const { return assignedOfficer; }
+    void setAssignedOfficer(shared_ptr<const HeadConstable> officer) {
+        assignedOfficer = officer;
+        headConstableId = officer ? officer->getId() : -1;
+    }
+    int getHeadConstableId() const { return headConstableId; }
+    void setHeadConstableId(int id) { headConstableId = id; }
+    // True when a head constable ID was loaded but the officer isn't available yet
+    bool hasPendingOfficer() const { return !assignedOfficer && headConstableId >= 0; }
+    void detachOfficer() { assignedOfficer = nullptr; }  // Keeps the ID for relinking
 
     int getAssignedCase() const { return assignedCaseId; }
     void setCaseId(int cid) { assignedCaseId = cid; }
@@ -128,15 +146,25 @@ class ForensicLab {
     vector<LabTechnician> labTechs;  //composition
     vector<FieldAgent> fieldAgents;
     vector<Evidence> evidences;
+    // Guards the vectors above; shared for listing and lookups, exclusive for changes.
+    // Taken before the officer roster's lock and the search index's, never while
+    // calling into the crime module.
+    mutable shared_mutex labMutex;
+    size_t pendingOfficerLinks = 0;  // Field agents whose head constable is still unresolved
+    ModuleState state;  // Loaded/dirty tracking for forensics_data.json
+
+    size_t resolveFieldAgentOfficersLocked();
 
 public:
     void addLabTech(const LabTechnician& e);  //aggregation
-    void addFieldAgent(HeadConstable* officer);  // Changed to take HeadConstable
+    void addFieldAgent(shared_ptr<const HeadConstable> officer);  // Changed to take HeadConstable
     void listExperts();
+    json toJson() const;  // Evidence, field agents and lab techs as saved in forensics_data.json
     void save();
     void load();
+    void loadFromJson(const json& data);  // Head constables stay pending until resolveFieldAgentOfficers()
 
-    void assignEvidence(int techId, int caseId, const string& desc);
+    bool assignEvidence(int techId, int caseId, const string& desc);  // False if the case or tech is unknown
     void markEvidenceProcessed(int evId);
     void listAllEvidence();
 
@@ -148,21 +176,103 @@ public:
     void checkCaseProgress(int caseId);
     void markCaseResolved(int caseId);
 
+    // Links field agents loaded before the officer roster; cheap when nothing is pending
+    size_t resolveFieldAgentOfficers();
+    size_t getPendingOfficerLinks() const;
+    void unlinkFieldAgentOfficers();  // Back to IDs before the officer roster is replaced
+    ModuleState& getState() { return state; }
+
+    // Pipeline support (thread-safe)
+    vector<Evidence> getPendingEvidence() const;
+    bool findEvidence(int evId, Evidence& out) const;
+    bool applyAnalysisResult(const Evidence& ev);
+    void processPendingEvidence(size_t numWorkers = ThreadPool::defaultThreadCount());
+
     // Get available Head Constables
-    vector<HeadConstable*> getHeadConstables() const {
-        vector<HeadConstable*> headConstables;
-        OfficerManager& om = OfficerRegistry::getInstance()->getManager();
-        const vector<Officer*>& officers = om.getOfficers();
-        
-        for (const auto& officer : officers) {
-            if (HeadConstable* hc = dynamic_cast<HeadConstable*>(officer)) {
-                headConstables.push_back(hc);
-            }
-        }
-        return headConstables;
+    vector<shared_ptr<const HeadConstable>> getHeadConstables() const {
+        return OfficerRegistry::getInstance()->getManager().getHeadConstables();
     }
 };
 
+// ------------------------ ANALYSIS PIPELINE ------------------------
+// One step of evidence processing. Stages must be safe to call from several
+// worker threads at once; return false to drop the evidence from the run.
+class AnalysisStage {
+public:
+    virtual string getName() const = 0;
+    virtual bool process(Evidence& ev) = 0;
+    virtual ~AnalysisStage() = default;
+};
+
+// Intake: rejects evidence that is already processed, empty or not linked to a known case
+class IntakeStage : public AnalysisStage {
+    bool checkCases;
+public:
+    IntakeStage(bool verifyCases = true) : checkCases(verifyCases) {}
+    string getName() const override { return "Intake"; }
+    bool process(Evidence& ev) override;
+};
+
+// Analysis: classifies evidence from keywords in its description
+class KeywordAnalysisStage : public AnalysisStage {
+public:
+    string getName() const override { return "Keyword Analysis"; }
+    bool process(Evidence& ev) override;
+};
+
+// Analysis: burns a fixed amount of CPU per item, used to benchmark the pipeline
+class SyntheticWorkloadStage : public AnalysisStage {
+    int rounds;
+public:
+    SyntheticWorkloadStage(int r = 200000) : rounds(r) {}
+    string getName() const override { return "Synthetic Workload"; }
+    bool process(Evidence& ev) override;
+};
+
+// Report: writes the analysed evidence back into the lab
+class LabReportStage : public AnalysisStage {
+    ForensicLab& lab;
+public:
+    LabReportStage(ForensicLab& l) : lab(l) {}
+    string getName() const override { return "Lab Report"; }
+    bool process(Evidence& ev) override { return lab.applyAnalysisResult(ev); }
+};
+
+struct PipelineResult {
+    size_t submitted = 0;
+    size_t rejected = 0;
+    size_t failed = 0;
+    size_t reported = 0;
+    double seconds = 0.0;
+};
+
+// intake -> analysis -> report. Intake runs on the calling thread, the analysis
+// stages run on a fixed-size ThreadPool and a single reporter thread drains the
+// results, with bounded queues in between so memory stays flat for big batches.
+class EvidencePipeline {
+    AnalysisStage* intake;                 // Owned
+    vector<AnalysisStage*> analysisStages; // Owned, run in order
+    AnalysisStage* report;                 // Owned
+    size_t numWorkers;
+    size_t queueCapacity;
+
+public:
+    EvidencePipeline(size_t workers = ThreadPool::defaultThreadCount(), size_t queueCap = 256)
+        : intake(nullptr), report(nullptr), numWorkers(workers > 0 ? workers : 1), queueCapacity(queueCap) {}
+    ~EvidencePipeline();
+    EvidencePipeline(const EvidencePipeline&) = delete;
+    EvidencePipeline& operator=(const EvidencePipeline&) = delete;
+
+    void setIntakeStage(AnalysisStage* stage);
+    void addAnalysisStage(AnalysisStage* stage);
+    void setReportStage(AnalysisStage* stage);
+    size_t getNumWorkers() const { return numWorkers; }
+
+    PipelineResult run(const vector<Evidence>& batch);
+};
+
+void benchmarkEvidencePipeline(size_t itemCount = 2000, int rounds = 200000);
+
 // ------------------------ SINGLETON ------------------------
 class ForensicLabRegistry {
     static ForensicLabRegistry* instance;
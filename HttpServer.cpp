@@ -0,0 +1,567 @@
+#include "HttpServer.h"
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <iomanip>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+using namespace std;
+
+const size_t HttpServer::MAX_HEADER_BYTES;
+const size_t HttpServer::MAX_BODY_BYTES;
+
+static vector<string> splitPath(const string& path) {
+    vector<string> segments;
+    string current;
+    for (char ch : path) {
+        if (ch == '/') {
+            if (!current.empty()) segments.push_back(current);
+            current.clear();
+        } else {
+            current += ch;
+        }
+    }
+    if (!current.empty()) segments.push_back(current);
+    return segments;
+}
+
+static string urlDecode(const string& text) {
+    string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '+') {
+            out += ' ';
+        } else if (text[i] == '%' && i + 2 < text.size() && isxdigit(text[i + 1]) && isxdigit(text[i + 2])) {
+            out += static_cast<char>(strtol(text.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else {
+            out += text[i];
+        }
+    }
+    return out;
+}
+
+static string toLower(string text) {
+    transform(text.begin(), text.end(), text.begin(), [](unsigned char ch) { return tolower(ch); });
+    return text;
+}
+
+static string trim(const string& text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(start, end - start + 1);
+}
+
+static const char* statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        default: return status >= 500 ? "Internal Server Error" : "Error";
+    }
+}
+
+static string serialize(const HttpResponse& resp, bool keepAlive) {
+    string body = resp.body.dump();
+    ostringstream out;
+    out << "HTTP/1.1 " << resp.status << " " << statusText(resp.status) << "\r\n"
+        << "Content-Type: application/json\r\n"
+        << "Content-Length: " << body.size() << "\r\n"
+        << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n\r\n"
+        << body;
+    return out.str();
+}
+
+// The whole text as an int; false for trailing junk, no digits or out of range
+static bool parseInt(const string& text, int& out) {
+    size_t used = 0;
+    try {
+        out = stoi(text, &used);
+    } catch (const exception&) {
+        return false;
+    }
+    return used > 0 && used == text.size();
+}
+
+int HttpRequest::intParam(const string& name) const {
+    auto it = params.find(name);
+    if (it == params.end()) {
+        throw invalid_argument("missing parameter: " + name);
+    }
+    int value = 0;
+    if (!parseInt(it->second, value)) {
+        throw invalid_argument(name + " must be a number");
+    }
+    return value;
+}
+
+bool HttpRequest::intQuery(const string& name, int fallback, int& out) const {
+    auto it = query.find(name);
+    if (it == query.end()) {
+        out = fallback;
+        return true;
+    }
+    return parseInt(it->second, out);
+}
+
+void HttpServer::route(const string& method, const string& pattern, RouteHandler handler) {
+    Route r;
+    r.method = method;
+    r.segments = splitPath(pattern);
+    r.handler = handler;
+    routes.push_back(r);
+}
+
+// Finds the route for the request; bad input from the client becomes a 400
+HttpResponse HttpServer::dispatch(HttpRequest& req) const {
+    vector<string> segments = splitPath(req.path);
+    bool pathMatched = false;
+    for (const auto& r : routes) {
+        if (r.segments.size() != segments.size()) continue;
+        map<string, string> params;
+        bool match = true;
+        for (size_t i = 0; i < segments.size() && match; i++) {
+            if (!r.segments[i].empty() && r.segments[i][0] == ':') {
+                params[r.segments[i].substr(1)] = urlDecode(segments[i]);
+            } else if (r.segments[i] != segments[i]) {
+                match = false;
+            }
+        }
+        if (!match) continue;
+        pathMatched = true;
+        if (r.method != req.method) continue;
+
+        req.params = params;
+        try {
+            return r.handler(req);
+        } catch (const json::exception& e) {
+            return HttpResponse::error(400, e.what());
+        } catch (const invalid_argument& e) {
+            return HttpResponse::error(400, e.what());
+        } catch (const out_of_range& e) {
+            return HttpResponse::error(400, e.what());
+        } catch (const exception& e) {
+            return HttpResponse::error(500, e.what());
+        }
+    }
+    return pathMatched ? HttpResponse::error(405, "method not allowed") : HttpResponse::error(404, "no such endpoint");
+}
+
+#ifdef __linux__
+
+struct HttpServer::Connection {
+    int fd;
+    string in;
+    string out;
+    size_t outSent;
+    bool wantWrite;        // EPOLLOUT registered
+    bool closeAfterWrite;
+
+    explicit Connection(int f) : fd(f), outSent(0), wantWrite(false), closeAfterWrite(false) {}
+};
+
+HttpServer::HttpServer() : listenFd(-1), epollFd(-1), wakeFd(-1), port(0), stopping(false), requestsServed(0) {}
+
+HttpServer::~HttpServer() {
+    if (listenFd >= 0) close(listenFd);
+    if (epollFd >= 0) close(epollFd);
+    if (wakeFd >= 0) close(wakeFd);
+}
+
+bool HttpServer::listenOn(const string& host, int requestedPort) {
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        cout << "Error creating socket: " << strerror(errno) << endl;
+        return false;
+    }
+    int yes = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(requestedPort));
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        cout << "Error: '" << host << "' is not an IPv4 address" << endl;
+        return false;
+    }
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listenFd, SOMAXCONN) < 0) {
+        cout << "Error listening on " << host << ":" << requestedPort << ": " << strerror(errno) << endl;
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &len);
+    port = ntohs(addr.sin_port);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        cout << "Error setting up epoll: " << strerror(errno) << endl;
+        return false;
+    }
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+    return true;
+}
+
+// Reads what's available and answers every complete request in the buffer.
+// Returns false if the connection is broken.
+bool HttpServer::handleReadable(Connection& conn) {
+    char buffer[16 * 1024];
+    bool peerClosed = false;
+    while (true) {
+        ssize_t n = read(conn.fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            conn.in.append(buffer, n);
+            continue;
+        }
+        if (n == 0) {
+            peerClosed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        break;
+    }
+
+    while (!conn.closeAfterWrite) {
+        size_t headerEnd = conn.in.find("\r\n\r\n");
+        if (headerEnd == string::npos || headerEnd > MAX_HEADER_BYTES) {
+            if (conn.in.size() > MAX_HEADER_BYTES) {
+                conn.out += serialize(HttpResponse::error(431, "headers too large"), false);
+                conn.closeAfterWrite = true;
+            }
+            break;
+        }
+
+        HttpRequest req;
+        istringstream head(conn.in.substr(0, headerEnd));
+        string line, target, version;
+        getline(head, line);
+        istringstream requestLine(line);
+        if (!(requestLine >> req.method >> target >> version) || target.empty() || target[0] != '/') {
+            conn.out += serialize(HttpResponse::error(400, "malformed request line"), false);
+            conn.closeAfterWrite = true;
+            break;
+        }
+        while (getline(head, line)) {
+            size_t colon = line.find(':');
+            if (colon != string::npos) {
+                req.headers[toLower(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+            }
+        }
+
+        size_t queryStart = target.find('?');
+        req.path = urlDecode(target.substr(0, queryStart));
+        if (queryStart != string::npos) {
+            istringstream query(target.substr(queryStart + 1));
+            string pair;
+            while (getline(query, pair, '&')) {
+                size_t eq = pair.find('=');
+                req.query[urlDecode(pair.substr(0, eq))] = eq == string::npos ? "" : urlDecode(pair.substr(eq + 1));
+            }
+        }
+        string connection = toLower(req.headers.count("connection") ? req.headers["connection"] : "");
+        req.keepAlive = version == "HTTP/1.0" ? connection == "keep-alive" : connection != "close";
+
+        size_t bodyLength = 0;
+        if (req.headers.count("content-length")) {
+            bodyLength = strtoul(req.headers["content-length"].c_str(), nullptr, 10);
+        }
+        if (bodyLength > MAX_BODY_BYTES) {
+            conn.out += serialize(HttpResponse::error(413, "body too large"), false);
+            conn.closeAfterWrite = true;
+            break;
+        }
+        if (conn.in.size() < headerEnd + 4 + bodyLength) break;  // Rest of the body hasn't arrived
+
+        req.body = conn.in.substr(headerEnd + 4, bodyLength);
+        conn.in.erase(0, headerEnd + 4 + bodyLength);
+
+        conn.out += serialize(dispatch(req), req.keepAlive);
+        requestsServed++;
+        if (!req.keepAlive) conn.closeAfterWrite = true;
+    }
+
+    if (peerClosed) conn.closeAfterWrite = true;
+    return true;
+}
+
+// Writes as much pending output as the socket takes. Returns false on error.
+bool HttpServer::flush(Connection& conn) {
+    while (conn.outSent < conn.out.size()) {
+        ssize_t n = send(conn.fd, conn.out.data() + conn.outSent, conn.out.size() - conn.outSent, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.outSent += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    if (conn.outSent == conn.out.size()) {
+        conn.out.clear();
+        conn.outSent = 0;
+    }
+
+    // Only ask for EPOLLOUT while there's something left to send
+    bool wantWrite = !conn.out.empty();
+    if (wantWrite != conn.wantWrite) {
+        epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP | (wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        ev.data.fd = conn.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &ev);
+        conn.wantWrite = wantWrite;
+    }
+    return true;
+}
+
+void HttpServer::closeConnection(Connection* conn, map<int, Connection*>& connections) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, nullptr);
+    close(conn->fd);
+    connections.erase(conn->fd);
+    delete conn;
+}
+
+void HttpServer::run() {
+    map<int, Connection*> connections;
+    epoll_event events[64];
+
+    while (!stopping) {
+        int n = epoll_wait(epollFd, events, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            cout << "epoll_wait failed: " << strerror(errno) << endl;
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == wakeFd) {
+                uint64_t count;
+                while (read(wakeFd, &count, sizeof(count)) > 0) {}
+                continue;
+            }
+            if (fd == listenFd) {
+                while (true) {
+                    int client = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (client < 0) break;  // EAGAIN: accepted everything queued
+                    int yes = 1;
+                    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+                    epoll_event ev;
+                    memset(&ev, 0, sizeof(ev));
+                    ev.events = EPOLLIN | EPOLLRDHUP;
+                    ev.data.fd = client;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, client, &ev);
+                    connections[client] = new Connection(client);
+                }
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) continue;
+            Connection* conn = it->second;
+            bool ok = !(events[i].events & EPOLLERR);
+            if (ok && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) {
+                ok = handleReadable(*conn);
+            }
+            if (ok) {
+                ok = flush(*conn);
+            }
+            if (!ok || (conn->closeAfterWrite && conn->out.empty())) {
+                closeConnection(conn, connections);
+            }
+        }
+
+        // Requests from this wakeup are done; e.g. hand changes to the flusher
+        if (afterBatch) afterBatch();
+    }
+
+    while (!connections.empty()) {
+        closeConnection(connections.begin()->second, connections);
+    }
+}
+
+void HttpServer::stop() {
+    stopping = true;
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+// ---------------- Load test client ----------------
+
+static bool sendAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+// Reads one response off a keep-alive connection; leftover bytes stay in `buffer`
+static bool readResponse(int fd, string& buffer, int& status) {
+    char chunk[16 * 1024];
+    size_t headerEnd;
+    while ((headerEnd = buffer.find("\r\n\r\n")) == string::npos) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer.append(chunk, n);
+    }
+    status = atoi(buffer.c_str() + 9);  // "HTTP/1.1 200"
+    size_t bodyLength = 0;
+    size_t lengthPos = toLower(buffer.substr(0, headerEnd)).find("content-length:");
+    if (lengthPos != string::npos) {
+        bodyLength = strtoul(buffer.c_str() + lengthPos + 15, nullptr, 10);
+    }
+    size_t total = headerEnd + 4 + bodyLength;
+    while (buffer.size() < total) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer.append(chunk, n);
+    }
+    buffer.erase(0, total);
+    return true;
+}
+
+LoadTestResult runLoadTest(const string& host, int port, size_t connections, size_t totalRequests,
+                           const vector<string>& paths) {
+    typedef chrono::steady_clock Clock;
+    LoadTestResult result;
+    if (connections == 0 || paths.empty()) return result;
+
+    vector<string> requests;
+    for (const auto& path : paths) {
+        requests.push_back("GET " + path + " HTTP/1.1\r\nHost: " + host + "\r\n\r\n");
+    }
+    vector<vector<double>> latencies(connections);
+    vector<size_t> errors(connections, 0);
+
+    auto client = [&](size_t t) {
+        size_t count = totalRequests / connections + (t < totalRequests % connections ? 1 : 0);
+        latencies[t].reserve(count);
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        inet_pton(AF_INET, host.c_str(), &addr.sin_addr);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            errors[t] = count;
+            if (fd >= 0) close(fd);
+            return;
+        }
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+        string buffer;
+        for (size_t i = 0; i < count; i++) {
+            auto start = Clock::now();
+            int status = 0;
+            if (!sendAll(fd, requests[(t + i) % requests.size()]) || !readResponse(fd, buffer, status)) {
+                errors[t] += count - i;  // Connection is gone; the rest count as failed
+                break;
+            }
+            if (status < 200 || status >= 300) errors[t]++;
+            latencies[t].push_back(chrono::duration<double, milli>(Clock::now() - start).count());
+        }
+        close(fd);
+    };
+
+    auto start = Clock::now();
+    vector<thread> threads;
+    for (size_t t = 0; t < connections; t++) {
+        threads.push_back(thread(client, t));
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    result.seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    vector<double> all;
+    for (size_t t = 0; t < connections; t++) {
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+        result.errors += errors[t];
+    }
+    result.requests = all.size();
+    if (!all.empty()) {
+        sort(all.begin(), all.end());
+        result.p50Ms = all[all.size() / 2];
+        result.p99Ms = all[min(all.size() - 1, all.size() * 99 / 100)];
+        result.maxMs = all.back();
+    }
+    result.requestsPerSecond = result.seconds > 0 ? result.requests / result.seconds : 0.0;
+    return result;
+}
+
+#else  // No epoll: HTTP mode is Linux-only
+
+struct HttpServer::Connection {};
+
+HttpServer::HttpServer() : listenFd(-1), epollFd(-1), wakeFd(-1), port(0), stopping(false), requestsServed(0) {}
+HttpServer::~HttpServer() {}
+
+bool HttpServer::listenOn(const string&, int) {
+    cout << "The HTTP service needs Linux (epoll)." << endl;
+    return false;
+}
+bool HttpServer::handleReadable(Connection&) { return false; }
+bool HttpServer::flush(Connection&) { return false; }
+void HttpServer::closeConnection(Connection*, map<int, Connection*>&) {}
+void HttpServer::run() {}
+void HttpServer::stop() { stopping = true; }
+
+LoadTestResult runLoadTest(const string&, int, size_t, size_t totalRequests, const vector<string>&) {
+    LoadTestResult result;
+    result.errors = totalRequests;
+    return result;
+}
+
+#endif
+
+void printLoadTestResult(const LoadTestResult& result, ostream& os) {
+    os << fixed << setprecision(2);
+    os << "Requests:     " << result.requests << " (" << result.errors << " failed)\n"
+       << "Elapsed:      " << result.seconds << " s\n"
+       << "Throughput:   " << result.requestsPerSecond << " requests/sec\n"
+       << "Latency p50:  " << result.p50Ms << " ms\n"
+       << "Latency p99:  " << result.p99Ms << " ms\n"
+       << "Latency max:  " << result.maxMs << " ms\n";
+    os.unsetf(ios::floatfield);
+    os << setprecision(6);
+}
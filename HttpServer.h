@@ -0,0 +1,99 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <atomic>
+#include <iostream>
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+using namespace std;
+
+struct HttpRequest {
+    string method;
+    string path;                  // Without the query string
+    map<string, string> query;    // Decoded ?key=value pairs
+    map<string, string> headers;  // Names lower-cased
+    map<string, string> params;   // Filled from ":name" segments of the matched route
+    string body;
+    bool keepAlive;
+
+    HttpRequest() : keepAlive(true) {}
+    int intParam(const string& name) const;  // Throws invalid_argument if not a number
+    // ?name= as a whole number, or `fallback` when absent; false if it's there but not a number
+    bool intQuery(const string& name, int fallback, int& out) const;
+};
+
+struct HttpResponse {
+    int status;
+    json body;
+
+    HttpResponse(int s = 200, const json& b = json::object()) : status(s), body(b) {}
+    static HttpResponse error(int status, const string& message) {
+        return HttpResponse(status, json{ {"error", message} });
+    }
+};
+
+typedef function<HttpResponse(const HttpRequest&)> RouteHandler;
+
+// Single-threaded HTTP/1.1 server on an epoll event loop (Linux only).
+// Every handler runs on the thread that called run(), one request at a time,
+// so handlers can use the registries the same way the menus do. Connections
+// are kept alive and pipelined requests are answered in order.
+class HttpServer {
+    struct Route {
+        string method;
+        vector<string> segments;  // "/cases/:id" -> {"cases", ":id"}
+        RouteHandler handler;
+    };
+    struct Connection;
+
+    vector<Route> routes;
+    function<void()> afterBatch;
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    int port;
+    atomic<bool> stopping;
+    size_t requestsServed;
+
+    HttpResponse dispatch(HttpRequest& req) const;
+    bool handleReadable(Connection& conn);
+    bool flush(Connection& conn);
+    void closeConnection(Connection* conn, map<int, Connection*>& connections);
+
+public:
+    static const size_t MAX_HEADER_BYTES = 16 * 1024;
+    static const size_t MAX_BODY_BYTES = 1024 * 1024;
+
+    HttpServer();
+    ~HttpServer();
+
+    void route(const string& method, const string& pattern, RouteHandler handler);
+    void setAfterBatch(function<void()> hook) { afterBatch = hook; }  // Runs after each epoll wakeup's requests
+
+    bool listenOn(const string& host, int port);  // Port 0 picks a free one
+    int getPort() const { return port; }
+    void run();    // Blocks until stop()
+    void stop();   // Safe from any thread and from a signal handler
+    size_t getRequestsServed() const { return requestsServed; }
+};
+
+// Result of hammering a running server with keep-alive GETs
+struct LoadTestResult {
+    size_t requests;
+    size_t errors;
+    double seconds;
+    double requestsPerSecond;
+    double p50Ms;
+    double p99Ms;
+    double maxMs;
+
+    LoadTestResult() : requests(0), errors(0), seconds(0.0), requestsPerSecond(0.0), p50Ms(0.0), p99Ms(0.0), maxMs(0.0) {}
+};
+
+// `connections` client threads, each with one keep-alive connection, share
+// `totalRequests` GETs, cycling through `paths`
+LoadTestResult runLoadTest(const string& host, int port, size_t connections, size_t totalRequests,
+                           const vector<string>& paths);
+void printLoadTestResult(const LoadTestResult& result, ostream& os);
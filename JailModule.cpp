@@ -1,12 +1,24 @@
 #include "JailModule.h"
+#include "DataLoader.h"
+#include "PersistenceCoordinator.h"
+#include "OccupancySimulator.h"
+#include "CrimeModule.h"
+#include "CaseLinkBackfill.h"
+#include <mutex>
+#include <algorithm>
 using namespace std;
 
 JailRegistry* JailRegistry::instance = nullptr;
 
-void Jail::listCells() {
-    cout << "\nHigh Security Cells (Capacity: " << HIGH_SEC_CAPACITY << " per cell):" << endl;
-    for (int i = 1; i <= NUM_HIGH_SEC_CELLS; i++) {
-        Cell* cell = cellMap[i];
+static bool betterMatch(const PrisonerMatch& a, const PrisonerMatch& b) {
+    if (a.score != b.score) return a.score > b.score;
+    if (a.facility != b.facility) return a.facility < b.facility;
+    return a.prisoner.getId() < b.prisoner.getId();
+}
+
+void Jail::listCellRange(int firstId, int lastId) const {
+    for (int i = firstId; i <= lastId; i++) {
+        const Cell* cell = findCell(i);
         cout << *cell << endl;
         cout << "Prisoners in cell:" << endl;
         for (const auto& prisoner : cell->getPrisoners()) {
@@ -18,36 +30,34 @@ void Jail::listCells() {
         }
         cout << "------------------------" << endl;
     }
+}
+
+void Jail::listCells() {
+    shared_lock<shared_mutex> lock(jailMutex);
+    cout << "\nHigh Security Cells (Capacity: " << HIGH_SEC_CAPACITY << " per cell):" << endl;
+    listCellRange(1, NUM_HIGH_SEC_CELLS);
     
     cout << "\nStandard Cells (Capacity: " << STANDARD_CAPACITY << " per cell):" << endl;
-    for (int i = NUM_HIGH_SEC_CELLS + 1; i <= NUM_HIGH_SEC_CELLS + NUM_STANDARD_CELLS; i++) {
-        Cell* cell = cellMap[i];
-        cout << *cell << endl;
-        cout << "Prisoners in cell:" << endl;
-        for (const auto& prisoner : cell->getPrisoners()) {
-            cout << *prisoner << endl;
-        }
-        if (cell->getAssignedOfficer()) {
-            cout << "Assigned CO: " << cell->getAssignedOfficer()->getName() 
-                 << " (ID: " << cell->getAssignedOfficer()->getId() << ")" << endl;
-        }
-        cout << "------------------------" << endl;
-    }
+    listCellRange(NUM_HIGH_SEC_CELLS + 1, NUM_HIGH_SEC_CELLS + NUM_STANDARD_CELLS);
 }
 
-void Jail::save() {
+json Jail::toJson() const {
+    shared_lock<shared_mutex> lock(jailMutex);
     json j;
     json prisonersArray = json::array();
     
     // Save prisoners
-    for (const auto& pair : prisonerMap) {
-        Prisoner* p = pair.second;
+    for (int id : prisonerMap.sortedKeys()) {
+        Prisoner* p = prisonerMap.at(id);
         json prisonerJson = {
             {"id", p->getId()},
             {"name", p->getName()},
             {"crime", p->getCrime()},
             {"sentenceYears", p->getSentenceYears()},
-            {"currentCellId", p->getCurrentCellId()}
+            {"currentCellId", p->getCurrentCellId()},
+            {"intakeDate", p->getIntakeDate()},
+            {"releaseDate", p->getReleaseDate()},
+            {"caseIds", p->getCaseIds()}
         };
         prisonersArray.push_back(prisonerJson);
     }
@@ -55,44 +65,82 @@ void Jail::save() {
     
     // Save cell assignments
     json cellsArray = json::array();
-    for (const auto& pair : cellMap) {
-        Cell* cell = pair.second;
+    for (int id : cellMap.sortedKeys()) {
+        const Cell* cell = findCell(id);
         json cellJson = {
             {"id", cell->getId()},
             {"type", cell->getType()},
-            {"assignedOfficerId", cell->getAssignedOfficer() ? cell->getAssignedOfficer()->getId() : -1}
+            {"assignedOfficerId", cell->getAssignedOfficer() ? cell->getAssignedOfficer()->getId() :
+                (pendingOfficerLinks.count(cell->getId()) ? pendingOfficerLinks.at(cell->getId()) : -1)}
         };
         cellsArray.push_back(cellJson);
     }
     j["cells"] = cellsArray;
-    
-    // Write to file
-    ofstream file("jail_data.json");
-    if (file.is_open()) {
-        file << j.dump(4); // Pretty print with 4 spaces
-        file.close();
-    } else {
+    return j;
+}
+
+void Jail::save() {
+    // Pretty print with 4 spaces
+    unsigned long long version = state.getVersion();
+    if (!state.writeFile(dataFile, toJson().dump(4), version)) {
         cout << "Error opening file for saving" << endl;
     }
 }
 
 void Jail::load() {
-    ifstream file("jail_data.json");
+    FileStamp stamp = FileStamp::of(dataFile);
+    ifstream file(dataFile);
     if (!file.is_open()) {
         cout << "Error opening file for loading" << endl;
         return;
     }
     
-    json j;
-    file >> j;
-    file.close();
+    try {
+        json j;
+        file >> j;
+        file.close();
+        loadFromJson(j);
+        resolveCellOfficers();
+        state.markLoaded(dataFile, stamp);
+        state.clearDirty();
+    } catch (const exception& e) {
+        cout << "Error loading jail data: " << e.what() << endl;
+        return;
+    }
     
+    cout << "Loaded " << getPrisonerCount() << " prisoners from file." << endl;
+}
+
+void Jail::loadFromJson(const json& j) {
+    unique_lock<shared_mutex> lock(jailMutex);
     // Clear existing data
+    for (auto& pair : prisonerMap) {
+        Prisoner* p = pair.second;
+        Cell* cell = findCell(p->getCurrentCellId());
+        if (cell) {
+            unseat(cell, p);
+        }
+        if (directory) directory->release(p->getId(), facility);
+        if (caseLinks) caseLinks->unlinkAll(p->getId());
+        delete p;
+    }
     prisonerMap.clear();
+    releases.clear();
+    nameIndex.clear();
+    crimeIndex.clear();
+    for (auto& cell : highSecCells) cell.assignOfficer(nullptr);
+    for (auto& cell : standardCells) cell.assignOfficer(nullptr);
+    pendingOfficerLinks.clear();
     
     // Load prisoners
     if (j.contains("prisoners")) {
         for (const auto& prisonerJson : j["prisoners"]) {
+            if (prisonerMap.count(prisonerJson["id"].get<int>()) ||
+                (directory && !directory->claim(prisonerJson["id"].get<int>(), facility))) {
+                cout << "Warning: prisoner " << prisonerJson["id"] << " in " << dataFile
+                     << " is already held elsewhere; skipped" << endl;
+                continue;
+            }
             Prisoner* p = new Prisoner(
                 prisonerJson["id"],
                 prisonerJson["name"],
@@ -100,85 +148,399 @@ void Jail::load() {
                 prisonerJson["sentenceYears"],
                 prisonerJson["currentCellId"]
             );
+            // Files from before the calendar have no dates; those prisoners start today
+            p->setDates(dayFromDate(prisonerJson.value("intakeDate", "")), dayFromDate(prisonerJson.value("releaseDate", "")));
+            p->setCaseIds(prisonerJson.value("caseIds", vector<int>()));
+            if (caseLinks) caseLinks->linkAll(p->getId(), p->getCaseIds());
             prisonerMap[p->getId()] = p;
+            releases.schedule(p->getId(), p->getReleaseDay());
+            nameIndex.add(p->getId(), p->getName());
+            crimeIndex.add(p->getId(), p->getCrime());
             
-            // Reassign prisoner to their cell
+            // Reassign prisoner to their cell; only seat() sets the cell ID, so a
+            // missing or full cell leaves the prisoner unhoused rather than pointing at it
             int cellId = prisonerJson["currentCellId"];
+            p->setCurrentCellId(-1);
             if (cellId != -1) {
-                auto cellIt = cellMap.find(cellId);
-                if (cellIt != cellMap.end()) {
-                    cellIt->second->addPrisoner(p);
+                Cell* cell = findCell(cellId);
+                if (cell) {
+                    seat(cell, p);
                 }
             }
         }
     }
     
-    // Load cell assignments
+    // Load cell assignments; officers are linked by ID afterwards
     if (j.contains("cells")) {
         for (const auto& cellJson : j["cells"]) {
             int cellId = cellJson["id"];
             int officerId = cellJson["assignedOfficerId"];
             
-            if (officerId != -1) {
-                auto& officerMap = OfficerRegistry::getInstance()->getManager().getOfficerMap();
-                auto officerIt = officerMap.find(officerId);
-                if (officerIt != officerMap.end()) {
-                    cellMap[cellId]->assignOfficer(officerIt->second);
-                }
+            if (officerId != -1 && cellMap.find(cellId) != cellMap.end()) {
+                pendingOfficerLinks[cellId] = officerId;
             }
         }
     }
-    
-    cout << "Loaded " << prisonerMap.size() << " prisoners from file." << endl;
 }
 
-JailRegistry* JailRegistry::getInstance() {
-    if (instance == nullptr) {
-        instance = new JailRegistry();
+// Links cells to COs in the officer roster; unknown officers stay pending
+void Jail::unlinkCellOfficers() {
+    unique_lock<shared_mutex> lock(jailMutex);
+    auto unlink = [this](Cell& cell) {
+        if (cell.getAssignedOfficer()) {
+            pendingOfficerLinks[cell.getId()] = cell.getAssignedOfficer()->getId();
+            cell.assignOfficer(nullptr);
+        }
+    };
+    for (auto& cell : highSecCells) unlink(cell);
+    for (auto& cell : standardCells) unlink(cell);
+}
+
+size_t Jail::resolveCellOfficers() {
+    unique_lock<shared_mutex> lock(jailMutex);
+    OfficerManager& officers = OfficerRegistry::getInstance()->getManager();
+    size_t resolved = 0;
+    for (auto it = pendingOfficerLinks.begin(); it != pendingOfficerLinks.end();) {
+        shared_ptr<const Officer> officer = officers.findOfficer(it->second);
+        if (officer) {
+            findCell(it->first)->assignOfficer(officer);
+            it = pendingOfficerLinks.erase(it);
+            resolved++;
+        } else {
+            ++it;
+        }
     }
+    return resolved;
+}
+
+size_t Jail::getPendingOfficerLinks() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    return pendingOfficerLinks.size();
+}
+
+JailRegistry* JailRegistry::getInstance() {
+    static once_flag created;
+    call_once(created, []() { instance = new JailRegistry(); });
     return instance;
 }
 
-Jail& JailRegistry::getJail() { return jail; }
+bool PrisonerDirectory::claim(int prisonerId, int facility) {
+    unique_lock<shared_mutex> lock(directoryMutex);
+    return facilityOf.emplace(prisonerId, facility).first->second == facility;
+}
+
+void PrisonerDirectory::release(int prisonerId, int facility) {
+    unique_lock<shared_mutex> lock(directoryMutex);
+    auto it = facilityOf.find(prisonerId);
+    if (it != facilityOf.end() && it->second == facility) {
+        facilityOf.erase(it);
+    }
+}
+
+void PrisonerDirectory::move(int prisonerId, int facility) {
+    unique_lock<shared_mutex> lock(directoryMutex);
+    facilityOf.insert_or_assign(prisonerId, facility);
+}
+
+int PrisonerDirectory::find(int prisonerId) const {
+    shared_lock<shared_mutex> lock(directoryMutex);
+    auto it = facilityOf.find(prisonerId);
+    return it != facilityOf.end() ? it->second : -1;
+}
+
+size_t PrisonerDirectory::size() const {
+    shared_lock<shared_mutex> lock(directoryMutex);
+    return facilityOf.size();
+}
+
+bool CaseLinkIndex::eraseValue(vector<int>& from, int value) {
+    for (size_t i = 0; i < from.size(); i++) {
+        if (from[i] == value) {
+            from[i] = from.back();
+            from.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CaseLinkIndex::link(int prisonerId, int caseId) {
+    unique_lock<shared_mutex> lock(linkMutex);
+    vector<int>& cases = casesByPrisoner[prisonerId];
+    for (int id : cases) {
+        if (id == caseId) return false;
+    }
+    cases.push_back(caseId);
+    prisonersByCase[caseId].push_back(prisonerId);
+    links++;
+    return true;
+}
+
+bool CaseLinkIndex::unlink(int prisonerId, int caseId) {
+    unique_lock<shared_mutex> lock(linkMutex);
+    auto it = casesByPrisoner.find(prisonerId);
+    if (it == casesByPrisoner.end() || !eraseValue(it->second, caseId)) return false;
+    if (it->second.empty()) casesByPrisoner.erase(it);
+    auto caseIt = prisonersByCase.find(caseId);
+    eraseValue(caseIt->second, prisonerId);
+    if (caseIt->second.empty()) prisonersByCase.erase(caseIt);
+    links--;
+    return true;
+}
+
+void CaseLinkIndex::linkAll(int prisonerId, const vector<int>& caseIds) {
+    for (int caseId : caseIds) link(prisonerId, caseId);
+}
+
+void CaseLinkIndex::unlinkAll(int prisonerId) {
+    unique_lock<shared_mutex> lock(linkMutex);
+    auto it = casesByPrisoner.find(prisonerId);
+    if (it == casesByPrisoner.end()) return;
+    for (int caseId : it->second) {
+        auto caseIt = prisonersByCase.find(caseId);
+        eraseValue(caseIt->second, prisonerId);
+        if (caseIt->second.empty()) prisonersByCase.erase(caseIt);
+        links--;
+    }
+    casesByPrisoner.erase(it);
+}
+
+vector<int> CaseLinkIndex::casesOf(int prisonerId) const {
+    shared_lock<shared_mutex> lock(linkMutex);
+    auto it = casesByPrisoner.find(prisonerId);
+    return it != casesByPrisoner.end() ? it->second : vector<int>();
+}
+
+vector<int> CaseLinkIndex::prisonersOf(int caseId) const {
+    shared_lock<shared_mutex> lock(linkMutex);
+    auto it = prisonersByCase.find(caseId);
+    return it != prisonersByCase.end() ? it->second : vector<int>();
+}
+
+size_t CaseLinkIndex::size() const {
+    shared_lock<shared_mutex> lock(linkMutex);
+    return links;
+}
+
+JailRegistry::JailRegistry() {
+    ifstream file("facilities.json");
+    if (file.is_open()) {
+        try {
+            json j;
+            file >> j;
+            for (const auto& f : j.at("facilities")) {
+                string name = f.at("name").get<string>();
+                if (findFacility(name) != -1) continue;
+                facilities.emplace_back(new Jail(name, f.at("file").get<string>(), facilities.size(), &directory, &caseLinks));
+            }
+        } catch (const exception& e) {
+            cout << "Error reading facilities.json: " << e.what() << endl;
+        }
+    }
+    if (facilities.empty()) {
+        facilities.emplace_back(new Jail("Central", "jail_data.json", 0, &directory, &caseLinks));
+    }
+}
+
+Jail& JailRegistry::getJail() { return *facilities[0]; }
+
+Jail& JailRegistry::getJail(size_t facility) { return *facilities.at(facility); }
+
+int JailRegistry::findFacility(const string& name) const {
+    for (size_t i = 0; i < facilities.size(); i++) {
+        if (facilities[i]->getName() == name) return i;
+    }
+    return -1;
+}
+
+int JailRegistry::locatePrisoner(int prisonerId) const {
+    return directory.find(prisonerId);
+}
+
+bool JailRegistry::findPrisoner(int prisonerId, Prisoner& out, int& facility) const {
+    // A transfer can move the prisoner between the lookup and the read; look again
+    for (int attempt = 0; attempt < 3; attempt++) {
+        facility = directory.find(prisonerId);
+        if (facility < 0) return false;
+        if (facilities[facility]->findPrisoner(prisonerId, out)) return true;
+    }
+    return false;
+}
+
+size_t JailRegistry::getPrisonerCount() const {
+    return directory.size();
+}
+
+vector<PrisonerMatch> JailRegistry::searchPrisoners(const string& query, size_t limit) const {
+    vector<PrisonerMatch> matches;
+    for (const auto& jail : facilities) {
+        vector<PrisonerMatch> found = jail->searchPrisoners(query, limit);
+        matches.insert(matches.end(), found.begin(), found.end());
+    }
+    sort(matches.begin(), matches.end(), betterMatch);
+    if (limit && matches.size() > limit) matches.resize(limit);
+    return matches;
+}
+
+bool JailRegistry::changePrisonerCell(int prisonerId, int cellId) {
+    // A transfer can move the prisoner between the lookup and the change; look again
+    for (int attempt = 0; attempt < 3; attempt++) {
+        int facility = directory.find(prisonerId);
+        if (facility < 0) return false;
+        if (facilities[facility]->changePrisonerCell(prisonerId, cellId)) return true;
+        if (directory.find(prisonerId) == facility) return false;  // Still there: the cell was the problem
+    }
+    return false;
+}
+
+bool JailRegistry::removePrisoner(int prisonerId) {
+    for (int attempt = 0; attempt < 3; attempt++) {
+        int facility = directory.find(prisonerId);
+        if (facility < 0) return false;
+        if (facilities[facility]->removePrisoner(prisonerId)) return true;
+    }
+    return false;
+}
+
+size_t JailRegistry::processReleases(int today) {
+    size_t released = 0;
+    for (const auto& jail : facilities) {
+        released += jail->processReleases(today);
+    }
+    return released;
+}
+
+size_t JailRegistry::countDueReleases(int today) const {
+    size_t due = 0;
+    for (const auto& jail : facilities) {
+        due += jail->countDueReleases(today);
+    }
+    return due;
+}
+
+bool JailRegistry::transferPrisoner(int prisonerId, size_t toFacility, int cellId) {
+    int from = directory.find(prisonerId);
+    if (from < 0 || toFacility >= facilities.size() || static_cast<size_t>(from) == toFacility) {
+        return false;
+    }
+    Jail& source = *facilities[from];
+    Jail& target = *facilities[toFacility];
+    // Always the lower facility first, so opposite transfers can't deadlock
+    unique_lock<shared_mutex> firstLock(static_cast<size_t>(from) < toFacility ? source.jailMutex : target.jailMutex);
+    unique_lock<shared_mutex> secondLock(static_cast<size_t>(from) < toFacility ? target.jailMutex : source.jailMutex);
+
+    if (!source.prisonerMap.count(prisonerId)) return false;  // Moved or released meanwhile
+    Cell* cell = nullptr;
+    if (cellId != -1) {
+        cell = target.findCell(cellId);
+        if (!cell || cell->isFull()) return false;
+    }
+    Prisoner* prisoner = source.detachPrisonerLocked(prisonerId);
+    target.attachPrisonerLocked(prisoner, cell);
+    directory.move(prisonerId, toFacility);
+    return true;
+}
+
+bool JailRegistry::linkCase(int prisonerId, int caseId) {
+    if (!CrimeRegistry::getInstance()->getManager().hasCase(caseId)) return false;
+    // A transfer can move the prisoner between the lookup and the link; look again
+    for (int attempt = 0; attempt < 3; attempt++) {
+        int facility = directory.find(prisonerId);
+        if (facility < 0) return false;
+        if (facilities[facility]->linkCase(prisonerId, caseId)) return true;
+        if (directory.find(prisonerId) == facility) return false;  // Already linked
+    }
+    return false;
+}
+
+bool JailRegistry::unlinkCase(int prisonerId, int caseId) {
+    for (int attempt = 0; attempt < 3; attempt++) {
+        int facility = directory.find(prisonerId);
+        if (facility < 0) return false;
+        if (facilities[facility]->unlinkCase(prisonerId, caseId)) return true;
+        if (directory.find(prisonerId) == facility) return false;
+    }
+    return false;
+}
+
+size_t JailRegistry::linkCases(const vector<pair<int, int>>& links) {
+    // One lock hold per facility
+    vector<vector<pair<int, int>>> byFacility(facilities.size());
+    for (const auto& link : links) {
+        int facility = directory.find(link.first);
+        if (facility >= 0) byFacility[facility].push_back(link);
+    }
+    size_t added = 0;
+    for (size_t i = 0; i < facilities.size(); i++) {
+        if (!byFacility[i].empty()) added += facilities[i]->linkCases(byFacility[i]);
+    }
+    return added;
+}
+
+size_t JailRegistry::dropCase(int caseId) {
+    size_t dropped = 0;
+    for (int prisonerId : caseLinks.prisonersOf(caseId)) {
+        if (unlinkCase(prisonerId, caseId)) dropped++;
+    }
+    return dropped;
+}
+
+json JailRegistry::facilitiesToJson() const {
+    json list = json::array();
+    for (size_t i = 0; i < facilities.size(); i++) {
+        list.push_back({
+            {"index", i},
+            {"name", facilities[i]->getName()},
+            {"file", facilities[i]->getDataFile()},
+            {"prisoners", facilities[i]->getPrisonerCount()},
+            {"housed", facilities[i]->getHousedPrisonerCount()}
+        });
+    }
+    return list;
+}
 
 bool Jail::assignOfficerToCell(int officerId, int cellId) {
-    auto cellIt = cellMap.find(cellId);
-    if (cellIt == cellMap.end()) {
+    unique_lock<shared_mutex> lock(jailMutex);
+    Cell* cell = findCell(cellId);
+    if (!cell) {
         return false;
     }
     
-    auto& officerMap = OfficerRegistry::getInstance()->getManager().getOfficerMap();
-    auto officerIt = officerMap.find(officerId);
-    if (officerIt == officerMap.end()) {
+    shared_ptr<const Officer> officer = OfficerRegistry::getInstance()->getManager().findOfficer(officerId);
+    if (!officer) {
         return false;
     }
     
     // Check if the officer is a CO
-    if (officerIt->second->getRole() != "CO") {
+    if (officer->getRole() != "CO") {
         cout << "Error: Only Correctional Officers (CO) can be assigned to cells." << endl;
         return false;
     }
     
-    cellIt->second->assignOfficer(officerIt->second);
-    save(); // Auto-save after assigning officer
+    cell->assignOfficer(officer);
+    pendingOfficerLinks.erase(cellId);
+    state.markDirty();
     return true;
 }
 
 bool Jail::removeOfficerFromCell(int cellId) {
-    auto cellIt = cellMap.find(cellId);
-    if (cellIt == cellMap.end()) {
+    unique_lock<shared_mutex> lock(jailMutex);
+    Cell* cell = findCell(cellId);
+    if (!cell) {
         return false;
     }
     
-    cellIt->second->assignOfficer(nullptr);
-    save(); // Auto-save after removing officer
+    cell->assignOfficer(nullptr);
+    pendingOfficerLinks.erase(cellId);
+    state.markDirty();
     return true;
 }
 
 void Jail::listOfficerAssignments() {
+    shared_lock<shared_mutex> lock(jailMutex);
     cout << "\nOfficer Assignments:" << endl;
-    for (const auto& pair : cellMap) {
-        Cell* cell = pair.second;
+    for (int id : cellMap.sortedKeys()) {
+        const Cell* cell = findCell(id);
         cout << "Cell " << cell->getId() << " (" << cell->getType() << "): ";
         if (cell->getAssignedOfficer()) {
             cout << cell->getAssignedOfficer()->getName() 
@@ -192,10 +554,37 @@ void Jail::listOfficerAssignments() {
 
 void jailMenu() {
     JailRegistry* registry = JailRegistry::getInstance();
-    Jail& jail = registry->getJail();
+    refreshChangedData();
+    // Releasing removes the records, so it waits for a yes
+    size_t due = registry->countDueReleases(currentDay());
+    if (due > 0) {
+        char choice;
+        cout << due << " prisoner(s) have reached their release date. Release them now? (y/n): ";
+        cin >> choice;
+        if (choice == 'y' || choice == 'Y') {
+            cout << registry->processReleases(currentDay()) << " prisoner(s) released" << endl;
+        }
+    }
+
+    size_t facility = 0;
+    if (registry->getFacilityCount() > 1) {
+        cout << "\nFacilities:" << endl;
+        for (size_t i = 0; i < registry->getFacilityCount(); i++) {
+            cout << i + 1 << ". " << registry->getJail(i).getName() << endl;
+        }
+        cout << "Choose facility: ";
+        cin >> facility;
+        if (facility < 1 || facility > registry->getFacilityCount()) {
+            cout << "Invalid facility" << endl;
+            return;
+        }
+        facility--;
+    }
+    Jail& jail = registry->getJail(facility);
     
     while (true) {
-        cout << "\nJail Management System" << endl;
+        persistChanges();  // Changes are written by the background flusher, not per operation
+        cout << "\nJail Management System - " << jail.getName() << endl;
         cout << "1. View Cell Information" << endl;
         cout << "2. Add Prisoner" << endl;
         cout << "3. Assign Prisoner to Cell" << endl;
@@ -205,6 +594,16 @@ void jailMenu() {
         cout << "7. Assign Officer to Cell" << endl;
         cout << "8. Remove Officer from Cell" << endl;
         cout << "9. List Officer Assignments" << endl;
+        cout << "10. Occupancy Summary" << endl;
+        cout << "11. Releases This Week" << endl;
+        cout << "12. Process Due Releases" << endl;
+        cout << "13. Find Prisoner in Any Facility" << endl;
+        cout << "14. Transfer Prisoner to Another Facility" << endl;
+        cout << "15. Capacity Planning Simulation" << endl;
+        cout << "16. Search Prisoners by Name or Crime" << endl;
+        cout << "17. Link Prisoner to Crime Case" << endl;
+        cout << "18. Prisoners Linked to a Case" << endl;
+        cout << "19. Link Prisoners to Cases from Crime Text" << endl;
         cout << "0. Exit" << endl;
         cout << "Enter your choice: ";
         
@@ -305,18 +704,13 @@ void jailMenu() {
                 
                 // Show available COs
                 cout << "\nAvailable Correctional Officers:" << endl;
-                auto& officerMap = OfficerRegistry::getInstance()->getManager().getOfficerMap();
-                bool hasAvailableCOs = false;
-                
-                for (const auto& pair : officerMap) {
-                    if (pair.second->getRole() == "CO") {
-                        cout << "ID: " << pair.second->getId() 
-                             << ", Name: " << pair.second->getName() << endl;
-                        hasAvailableCOs = true;
-                    }
+                vector<shared_ptr<const CO>> cos = OfficerRegistry::getInstance()->getManager().getCOs();
+                for (const auto& co : cos) {
+                    cout << "ID: " << co->getId() 
+                         << ", Name: " << co->getName() << endl;
                 }
                 
-                if (!hasAvailableCOs) {
+                if (cos.empty()) {
                     cout << "No Correctional Officers available." << endl;
                     break;
                 }
@@ -346,8 +740,138 @@ void jailMenu() {
             case 9:
                 jail.listOfficerAssignments();
                 break;
+            case 10:
+                jail.printOccupancy();
+                break;
+            case 11:
+                jail.listReleasesThisWeek();
+                break;
+            case 12:
+                cout << jail.processReleases(currentDay()) << " prisoner(s) released" << endl;
+                break;
+            case 13: {
+                int prisonerId, where;
+                cout << "Enter prisoner ID: ";
+                cin >> prisonerId;
+                Prisoner p;
+                if (registry->findPrisoner(prisonerId, p, where)) {
+                    cout << "Facility: " << registry->getJail(where).getName() << endl;
+                    cout << p << endl;
+                } else {
+                    cout << "Prisoner not found in any facility" << endl;
+                }
+                break;
+            }
+            case 14: {
+                int prisonerId, cellId;
+                string target;
+                cout << "Enter prisoner ID: ";
+                cin >> prisonerId;
+                cout << "Enter destination facility name: ";
+                cin.ignore();
+                getline(cin, target);
+                cout << "Enter cell ID there (-1 for none): ";
+                cin >> cellId;
+                int to = registry->findFacility(target);
+                if (to >= 0 && registry->transferPrisoner(prisonerId, to, cellId)) {
+                    cout << "Prisoner transferred successfully" << endl;
+                } else {
+                    cout << "Failed to transfer prisoner" << endl;
+                }
+                break;
+            }
+            case 15: {
+                // Starts from this facility's cells and current prisoners
+                SimulationConfig config;
+                int process, distribution;
+                cout << "Expected arrivals per day: ";
+                cin >> config.arrivalsPerDay;
+                cout << "Arrivals (1. Poisson, 2. Constant, 3. Bursty): ";
+                cin >> process;
+                if (process == 2) {
+                    config.arrivals = ArrivalProcess::Constant;
+                } else if (process == 3) {
+                    config.arrivals = ArrivalProcess::Bursty;
+                    cout << "Share of days with a burst (0-1): ";
+                    cin >> config.burstProbability;
+                    cout << "Arrivals on a burst day (times the usual rate): ";
+                    cin >> config.burstFactor;
+                }
+                cout << "Share of arrivals needing high security (0-1): ";
+                cin >> config.highSecurityShare;
+                cout << "Mean sentence length (days): ";
+                cin >> config.meanSentenceDays;
+                cout << "Sentence lengths (1. Fixed, 2. Exponential, 3. Lognormal, 4. Uniform): ";
+                cin >> distribution;
+                if (distribution == 1) {
+                    config.sentences = SentenceDistribution::Fixed;
+                } else if (distribution == 3) {
+                    config.sentences = SentenceDistribution::Lognormal;
+                    cout << "Log-space spread (sigma, e.g. 0.8): ";
+                    cin >> config.sentenceSigma;
+                } else if (distribution == 4) {
+                    config.sentences = SentenceDistribution::Uniform;
+                }
+                cout << "Warm-up days (simulated, not counted): ";
+                cin >> config.warmupDays;
+                cout << "Days to simulate: ";
+                cin >> config.days;
+                cout << "Number of trials: ";
+                cin >> config.trials;
+                printSimulationResult(simulateOccupancy(FacilityLayout::of(jail), config), cout);
+                break;
+            }
+            case 16: {
+                string query;
+                cout << "Enter name or crime (spelling need not be exact): ";
+                cin.ignore();
+                getline(cin, query);
+                vector<PrisonerMatch> matches = registry->searchPrisoners(query);
+                if (matches.empty()) {
+                    cout << "No close matches" << endl;
+                }
+                for (const PrisonerMatch& m : matches) {
+                    cout << m.prisoner.getId() << "  " << m.prisoner.getName() << "  (" << m.prisoner.getCrime()
+                         << ")  " << registry->getJail(m.facility).getName() << ", "
+                         << m.field << " match " << static_cast<int>(m.score * 100 + 0.5) << "%" << endl;
+                }
+                break;
+            }
+            case 17: {
+                int prisonerId, caseId;
+                cout << "Enter prisoner ID: ";
+                cin >> prisonerId;
+                cout << "Enter case ID: ";
+                cin >> caseId;
+                if (registry->linkCase(prisonerId, caseId)) {
+                    cout << "Prisoner linked to case" << endl;
+                } else {
+                    cout << "Failed: unknown prisoner or case, or already linked" << endl;
+                }
+                break;
+            }
+            case 18: {
+                int caseId, where;
+                cout << "Enter case ID: ";
+                cin >> caseId;
+                vector<int> linked = registry->getPrisonersOf(caseId);
+                sort(linked.begin(), linked.end());
+                if (linked.empty()) {
+                    cout << "No prisoners linked to case " << caseId << endl;
+                }
+                for (int prisonerId : linked) {
+                    Prisoner p;
+                    if (registry->findPrisoner(prisonerId, p, where)) {
+                        cout << p.getId() << "  " << p.getName() << "  (" << registry->getJail(where).getName() << ")" << endl;
+                    }
+                }
+                break;
+            }
+            case 19:
+                printBackfillReport(backfillCaseLinks(), cout);
+                break;
             case 0:
-                jail.save(); // Final save before exit
+                persistChanges(true); // Write now rather than at the next interval
                 return;
             default:
                 cout << "Invalid choice" << endl;
@@ -355,84 +879,340 @@ void jailMenu() {
     }
 }
 
-Jail::Jail() { 
+Jail::Jail(const string& name, const string& dataFile, int facility, PrisonerDirectory* directory, CaseLinkIndex* caseLinks)
+    : name(name), dataFile(dataFile), facility(facility), directory(directory), caseLinks(caseLinks) {
     initializeCells();
-    load(); // Auto-load data when jail is created
+    // Data is loaded by the startup loader (loadAllData) once officers are available
 }
 
 bool Jail::addPrisoner(const Prisoner& prisoner) {
+    unique_lock<shared_mutex> lock(jailMutex);
     if (prisonerMap.find(prisoner.getId()) != prisonerMap.end()) {
         return false; // Prisoner already exists
     }
-    prisonerMap[prisoner.getId()] = new Prisoner(prisoner);
-    save(); // Auto-save after adding prisoner
+    if (directory && !directory->claim(prisoner.getId(), facility)) {
+        return false; // Held in another facility
+    }
+    Prisoner* p = new Prisoner(prisoner);
+    p->setCurrentCellId(-1);
+    p->setDates(prisoner.getIntakeDay(), prisoner.getReleaseDay());
+    attachPrisonerLocked(p, nullptr);
+    if (caseLinks) caseLinks->linkAll(p->getId(), p->getCaseIds());
     return true;
 }
 
+void Jail::attachPrisonerLocked(Prisoner* prisoner, Cell* cell) {
+    prisonerMap[prisoner->getId()] = prisoner;
+    releases.schedule(prisoner->getId(), prisoner->getReleaseDay());
+    nameIndex.add(prisoner->getId(), prisoner->getName());
+    crimeIndex.add(prisoner->getId(), prisoner->getCrime());
+    if (cell) seat(cell, prisoner);
+    state.markDirty();
+}
+
+Prisoner* Jail::detachPrisonerLocked(int prisonerId) {
+    auto prisonerIt = prisonerMap.find(prisonerId);
+    if (prisonerIt == prisonerMap.end()) {
+        return nullptr;
+    }
+    
+    Prisoner* prisoner = prisonerIt->second;
+    if (prisoner->getCurrentCellId() != -1) {
+        Cell* currentCell = findCell(prisoner->getCurrentCellId());
+        if (currentCell) unseat(currentCell, prisoner);
+        prisoner->setCurrentCellId(-1);
+    }
+    releases.cancel(prisonerId);
+    nameIndex.remove(prisonerId);
+    crimeIndex.remove(prisonerId);
+    prisonerMap.erase(prisonerIt);
+    state.markDirty();
+    return prisoner;
+}
+
+bool Jail::seat(Cell* cell, Prisoner* prisoner) {
+    int before = cell->getCurrentOccupancy();
+    if (!cell->addPrisoner(prisoner)) return false;
+    cellsByOccupancy[before]--;
+    cellsByOccupancy[before + 1]++;
+    if (cell->isFull()) fullCells++;
+    housedPrisoners++;
+    return true;
+}
+
+void Jail::unseat(Cell* cell, Prisoner* prisoner) {
+    bool wasFull = cell->isFull();
+    int before = cell->getCurrentOccupancy();
+    if (!cell->removePrisoner(prisoner)) return;
+    cellsByOccupancy[before]--;
+    cellsByOccupancy[before - 1]++;
+    if (wasFull) fullCells--;
+    housedPrisoners--;
+}
+
 bool Jail::assignPrisonerToCell(int prisonerId, int cellId) {
+    unique_lock<shared_mutex> lock(jailMutex);
+    return assignPrisonerToCellLocked(prisonerId, cellId);
+}
+
+bool Jail::assignPrisonerToCellLocked(int prisonerId, int cellId) {
     auto prisonerIt = prisonerMap.find(prisonerId);
-    auto cellIt = cellMap.find(cellId);
+    Cell* cell = findCell(cellId);
     
-    if (prisonerIt == prisonerMap.end() || cellIt == cellMap.end()) {
+    if (prisonerIt == prisonerMap.end() || !cell) {
         return false; // Prisoner or cell not found
     }
     
     Prisoner* prisoner = prisonerIt->second;
-    Cell* cell = cellIt->second;
+    Cell* currentCell = prisoner->getCurrentCellId() != -1 ? findCell(prisoner->getCurrentCellId()) : nullptr;
+    // Check for room before leaving the current cell, so a full cell changes nothing
+    if (cell->isFull() && cell != currentCell) {
+        return false;
+    }
     
     // Remove from current cell if assigned
-    if (prisoner->getCurrentCellId() != -1) {
-        Cell* currentCell = cellMap[prisoner->getCurrentCellId()];
-        currentCell->removePrisoner(prisonerId);
-    }
+    if (currentCell) unseat(currentCell, prisoner);
+    prisoner->setCurrentCellId(-1);
     
-    bool result = cell->addPrisoner(prisoner);
+    bool result = seat(cell, prisoner);
     if (result) {
-        save(); // Auto-save after successful assignment
+        state.markDirty();
     }
     return result;
 }
 
 bool Jail::changePrisonerCell(int prisonerId, int newCellId) {
-    bool result = assignPrisonerToCell(prisonerId, newCellId);
-    if (result) {
-        save(); // Auto-save after successful cell change
-    }
-    return result;
+    unique_lock<shared_mutex> lock(jailMutex);
+    return assignPrisonerToCellLocked(prisonerId, newCellId);
 }
 
 bool Jail::removePrisoner(int prisonerId) {
-    auto prisonerIt = prisonerMap.find(prisonerId);
-    if (prisonerIt == prisonerMap.end()) {
+    unique_lock<shared_mutex> lock(jailMutex);
+    return removePrisonerLocked(prisonerId);
+}
+
+bool Jail::removePrisonerLocked(int prisonerId) {
+    Prisoner* prisoner = detachPrisonerLocked(prisonerId);
+    if (!prisoner) {
         return false;
     }
-    
-    Prisoner* prisoner = prisonerIt->second;
-    if (prisoner->getCurrentCellId() != -1) {
-        Cell* currentCell = cellMap[prisoner->getCurrentCellId()];
-        currentCell->removePrisoner(prisonerId);
-    }
-    
+    if (directory) directory->release(prisonerId, facility);
+    if (caseLinks) caseLinks->unlinkAll(prisonerId);
     delete prisoner;
-    prisonerMap.erase(prisonerIt);
-    save(); // Auto-save after removing prisoner
     return true;
 }
 
 void Jail::listPrisoners() {
+    shared_lock<shared_mutex> lock(jailMutex);
     cout << "\nAll Prisoners:" << endl;
-    for (const auto& pair : prisonerMap) {
-        cout << *pair.second << endl;
+    for (int id : prisonerMap.sortedKeys()) {
+        cout << *prisonerMap.at(id) << endl;
         cout << "------------------------" << endl;
     }
 }
 
-Prisoner* Jail::getPrisoner(int prisonerId) {
+size_t Jail::getPrisonerCount() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    return prisonerMap.size();
+}
+
+bool Jail::findPrisoner(int prisonerId, Prisoner& out) const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    auto it = prisonerMap.find(prisonerId);
+    if (it == prisonerMap.end()) return false;
+    out = *it->second;
+    return true;
+}
+
+vector<Prisoner> Jail::getPrisoners() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    vector<Prisoner> prisoners;
+    prisoners.reserve(prisonerMap.size());
+    for (int id : prisonerMap.sortedKeys()) {
+        prisoners.push_back(*prisonerMap.at(id));
+    }
+    return prisoners;
+}
+
+bool Jail::linkCase(int prisonerId, int caseId) {
+    return linkCases(vector<pair<int, int>>(1, make_pair(prisonerId, caseId))) == 1;
+}
+
+size_t Jail::linkCases(const vector<pair<int, int>>& links) {
+    unique_lock<shared_mutex> lock(jailMutex);
+    size_t added = 0;
+    for (const auto& link : links) {
+        auto it = prisonerMap.find(link.first);
+        if (it == prisonerMap.end() || !it->second->addCaseId(link.second)) continue;
+        if (caseLinks) caseLinks->link(link.first, link.second);
+        added++;
+    }
+    if (added > 0) state.markDirty();
+    return added;
+}
+
+bool Jail::unlinkCase(int prisonerId, int caseId) {
+    unique_lock<shared_mutex> lock(jailMutex);
     auto it = prisonerMap.find(prisonerId);
-    return it != prisonerMap.end() ? it->second : nullptr;
+    if (it == prisonerMap.end() || !it->second->removeCaseId(caseId)) return false;
+    if (caseLinks) caseLinks->unlink(prisonerId, caseId);
+    state.markDirty();
+    return true;
+}
+
+vector<PrisonerMatch> Jail::searchPrisoners(const string& query, size_t limit) const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    // A prisoner matching on both fields is listed once, under the better one
+    FlatHashMap<int, PrisonerMatch> best;
+    auto collect = [&](const TrigramIndex& index, const char* field) {
+        for (const TrigramIndex::Match& m : index.search(query, limit)) {
+            auto it = best.find(m.id);
+            if (it != best.end() && it->second.score >= m.score) continue;
+            best[m.id] = PrisonerMatch{*prisonerMap.at(m.id), m.score, field, facility};
+        }
+    };
+    collect(nameIndex, "name");
+    collect(crimeIndex, "crime");
+
+    vector<PrisonerMatch> matches;
+    matches.reserve(best.size());
+    for (auto& entry : best) matches.push_back(entry.second);
+    sort(matches.begin(), matches.end(), betterMatch);
+    if (limit && matches.size() > limit) matches.resize(limit);
+    return matches;
 }
 
-Cell* Jail::getCell(int cellId) {
-    auto it = cellMap.find(cellId);
-    return it != cellMap.end() ? it->second : nullptr;
-} 
\ No newline at end of file
+json Jail::cellsToJson() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    json list = json::array();
+    for (int id : cellMap.sortedKeys()) {
+        const Cell* cell = findCell(id);
+        json j = {
+            {"id", cell->getId()},
+            {"type", cell->getType()},
+            {"capacity", cell->getCapacity()},
+            {"occupancy", cell->getCurrentOccupancy()},
+            {"prisonerIds", json::array()}
+        };
+        for (const Prisoner* p : cell->getPrisoners()) {
+            j["prisonerIds"].push_back(p->getId());
+        }
+        if (cell->getAssignedOfficer()) {
+            j["assignedOfficer"] = { {"id", cell->getAssignedOfficer()->getId()}, {"name", cell->getAssignedOfficer()->getName()} };
+        }
+        list.push_back(j);
+    }
+    return list;
+}
+
+int Jail::getFullCellCount() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    return fullCells;
+}
+
+int Jail::getEmptyCellCount() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    return cellsByOccupancy[0];
+}
+
+int Jail::getHousedPrisonerCount() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    return housedPrisoners;
+}
+
+vector<int> Jail::getOccupancyHistogram() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    return cellsByOccupancy;
+}
+
+vector<int> Jail::getFullCellIds() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    vector<int> ids;
+    if (fullCells == 0) return ids;
+    for (int id : cellMap.sortedKeys()) {
+        if (findCell(id)->isFull()) ids.push_back(id);
+    }
+    return ids;
+}
+
+vector<int> Jail::getEmptyCellIds() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    vector<int> ids;
+    if (cellsByOccupancy[0] == 0) return ids;
+    for (int id : cellMap.sortedKeys()) {
+        if (findCell(id)->getCurrentOccupancy() == 0) ids.push_back(id);
+    }
+    return ids;
+}
+
+json Jail::occupancyToJson() const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    json full = json::array();
+    json empty = json::array();
+    for (int id : cellMap.sortedKeys()) {
+        const Cell* cell = findCell(id);
+        if (cell->isFull()) full.push_back(id);
+        else if (cell->getCurrentOccupancy() == 0) empty.push_back(id);
+    }
+    json j = {
+        {"cells", NUM_HIGH_SEC_CELLS + NUM_STANDARD_CELLS},
+        {"capacity", NUM_HIGH_SEC_CELLS * HIGH_SEC_CAPACITY + NUM_STANDARD_CELLS * STANDARD_CAPACITY},
+        {"housed", housedPrisoners},
+        {"fullCells", full},
+        {"emptyCells", empty},
+        {"histogram", cellsByOccupancy}
+    };
+    return j;
+}
+
+void Jail::printOccupancy() const {
+    vector<int> histogram = getOccupancyHistogram();
+    int totalCapacity = NUM_HIGH_SEC_CELLS * HIGH_SEC_CAPACITY + NUM_STANDARD_CELLS * STANDARD_CAPACITY;
+    cout << "\nOccupancy: " << getHousedPrisonerCount() << "/" << totalCapacity << " places filled" << endl;
+    cout << "Full cells: " << getFullCellCount() << ", empty cells: " << getEmptyCellCount() << endl;
+    for (size_t n = 0; n < histogram.size(); n++) {
+        cout << "  " << n << " prisoner(s): " << histogram[n] << " cell(s)" << endl;
+    }
+}
+
+vector<Prisoner> Jail::getReleasesBetween(int firstDay, int lastDay) const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    vector<Prisoner> out;
+    for (int id : releases.releasedBetween(firstDay, lastDay)) {
+        out.push_back(*prisonerMap.at(id));
+    }
+    return out;
+}
+
+void Jail::listReleasesThisWeek() const {
+    int today = currentDay();
+    vector<Prisoner> due = getReleasesBetween(today, today + 6);
+    cout << "\nReleases " << dateFromDay(today) << " to " << dateFromDay(today + 6) << ":" << endl;
+    if (due.empty()) {
+        cout << "None" << endl;
+    }
+    for (const Prisoner& p : due) {
+        cout << p.getReleaseDate() << "  " << p.getId() << " " << p.getName()
+             << " (cell " << p.getCurrentCellId() << ")" << endl;
+    }
+}
+
+size_t Jail::countDueReleases(int today) const {
+    shared_lock<shared_mutex> lock(jailMutex);
+    return releases.countDue(today);
+}
+
+size_t Jail::processReleases(int today, size_t batchSize) {
+    if (batchSize == 0) batchSize = 1;
+    size_t released = 0;
+    while (true) {
+        // Readers get a turn between batches
+        unique_lock<shared_mutex> lock(jailMutex);
+        vector<int> due = releases.takeDue(today, batchSize);
+        for (int id : due) {
+            if (removePrisonerLocked(id)) released++;
+        }
+        if (due.size() < batchSize) break;
+    }
+    return released;
+}
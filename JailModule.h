@@ -1,11 +1,17 @@
 #pragma once
 #include "ListTemplate.h"
+#include "FlatHashMap.h"
 #include "OfficerModule.h"
+#include "ModuleState.h"
+#include "ReleaseCalendar.h"
+#include "TrigramIndex.h"
 #include <string>
 #include <fstream>
 #include <iostream>
 #include <vector>
 #include <map>
+#include <memory>
+#include <shared_mutex>
 using namespace std;
 
 class Prisoner {
@@ -15,6 +21,11 @@ private:
     string crime;
     int sentenceYears;
     int currentCellId;
+    int intakeDay = NO_DAY;   // Filled in by Jail::addPrisoner() if not given
+    int releaseDay = NO_DAY;  // Defaults to intake + sentenceYears; none without a sentence
+    int cellSlot = -1;  // Position in its cell's prisoner list; kept by Cell
+    vector<int> caseIds;      // Crime cases this prisoner is linked to
+    friend class Cell;
 public:
     Prisoner(int id = 0, const string& n = "", const string& c = "", int years = 0, int cellId = -1)
         : prisonerId(id), name(n), crime(c), sentenceYears(years), currentCellId(cellId) {}
@@ -25,25 +36,79 @@ public:
     int getSentenceYears() const { return sentenceYears; }
     int getCurrentCellId() const { return currentCellId; }
     void setCurrentCellId(int cellId) { currentCellId = cellId; }
+    int getIntakeDay() const { return intakeDay; }
+    int getReleaseDay() const { return releaseDay; }
+    string getIntakeDate() const { return dateFromDay(intakeDay); }
+    string getReleaseDate() const { return dateFromDay(releaseDay); }
+    // Missing dates: intake today, release after the sentence. Without a
+    // sentence (years <= 0, e.g. on remand) no release is scheduled.
+    void setDates(int intake, int release = NO_DAY) {
+        intakeDay = intake != NO_DAY ? intake : currentDay();
+        if (release != NO_DAY) releaseDay = release;
+        else releaseDay = sentenceYears > 0 ? addYears(intakeDay, sentenceYears) : NO_DAY;
+    }
+    
+    const vector<int>& getCaseIds() const { return caseIds; }
+    void setCaseIds(const vector<int>& ids) {
+        caseIds.clear();
+        for (int id : ids) addCaseId(id);
+    }
+    bool addCaseId(int caseId) {  // False if already linked
+        for (int id : caseIds) {
+            if (id == caseId) return false;
+        }
+        caseIds.push_back(caseId);
+        return true;
+    }
+    bool removeCaseId(int caseId) {
+        for (size_t i = 0; i < caseIds.size(); i++) {
+            if (caseIds[i] == caseId) {
+                caseIds.erase(caseIds.begin() + i);
+                return true;
+            }
+        }
+        return false;
+    }
     
     friend ostream& operator<<(ostream& os, const Prisoner& p) {
         os << "Prisoner ID: " << p.prisonerId << "\n"
            << "Name: " << p.name << "\n"
            << "Crime: " << p.crime << "\n"
            << "Sentence: " << p.sentenceYears << " years\n"
-           << "Current Cell ID: " << p.currentCellId;
+           << "Intake: " << p.getIntakeDate() << ", release: "
+           << (p.releaseDay != NO_DAY ? p.getReleaseDate() : "not scheduled") << "\n";
+        if (!p.caseIds.empty()) {
+            os << "Cases:";
+            for (int id : p.caseIds) os << " " << id;
+            os << "\n";
+        }
+        os << "Current Cell ID: " << p.currentCellId;
         return os;
     }
 };
 
+// Non-owning view of a cell's occupants. Valid until the cell next changes,
+// so use it under the jail lock and don't keep it.
+class PrisonerView {
+    Prisoner* const* first;
+    Prisoner* const* last;
+public:
+    PrisonerView(Prisoner* const* f, Prisoner* const* l) : first(f), last(l) {}
+    Prisoner* const* begin() const { return first; }
+    Prisoner* const* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    const Prisoner* operator[](size_t i) const { return first[i]; }
+};
+
 class Cell {
 protected:
     int cellId;
     int capacity;
     vector<Prisoner*> prisoners;
-    Officer* assignedOfficer;
+    shared_ptr<const Officer> assignedOfficer;
 public:
-    Cell(int id = 0, int cap = 0) : cellId(id), capacity(cap), assignedOfficer(nullptr) {}
+    Cell(int id = 0, int cap = 0) : cellId(id), capacity(cap) {}
     virtual string getType() const = 0;
     int getId() const { return cellId; }
     int getCapacity() const { return capacity; }
@@ -52,26 +117,30 @@ public:
     
     bool addPrisoner(Prisoner* prisoner) {
         if (isFull()) return false;
+        prisoner->cellSlot = prisoners.size();
         prisoners.push_back(prisoner);
         prisoner->setCurrentCellId(cellId);
         return true;
     }
     
-    bool removePrisoner(int prisonerId) {
-        for (auto it = prisoners.begin(); it != prisoners.end(); ++it) {
-            if ((*it)->getId() == prisonerId) {
-                (*it)->setCurrentCellId(-1);
-                prisoners.erase(it);
-                return true;
-            }
+    // O(1): the last occupant takes the removed one's place
+    bool removePrisoner(Prisoner* prisoner) {
+        int slot = prisoner->cellSlot;
+        if (prisoner->getCurrentCellId() != cellId || slot < 0 || slot >= getCurrentOccupancy() || prisoners[slot] != prisoner) {
+            return false;
         }
-        return false;
+        prisoners[slot] = prisoners.back();
+        prisoners[slot]->cellSlot = slot;
+        prisoners.pop_back();
+        prisoner->cellSlot = -1;
+        prisoner->setCurrentCellId(-1);
+        return true;
     }
     
-    vector<Prisoner*> getPrisoners() const { return prisoners; }
+    PrisonerView getPrisoners() const { return PrisonerView(prisoners.data(), prisoners.data() + prisoners.size()); }
     
-    void assignOfficer(Officer* officer) { assignedOfficer = officer; }
-    Officer* getAssignedOfficer() const { return assignedOfficer; }
+    void assignOfficer(shared_ptr<const Officer> officer) { assignedOfficer = officer; }
+    shared_ptr<const Officer> getAssignedOfficer() const { return assignedOfficer; }
     
     virtual ~Cell() {}
     bool operator==(const Cell& other) const { return cellId == other.cellId; }
@@ -97,49 +166,143 @@ public:
     string getType() const override { return "Standard"; }
 };
 
+// Which facility holds each prisoner. Prisoner IDs are unique across all
+// facilities: a Jail claims the ID here before it adds the prisoner. Locked
+// after a jail's lock, never before.
+class PrisonerDirectory {
+    FlatHashMap<int, int> facilityOf;  // prisonerId -> facility index
+    mutable shared_mutex directoryMutex;
+public:
+    bool claim(int prisonerId, int facility);    // False if another facility holds the ID
+    void release(int prisonerId, int facility);  // Only if `facility` holds it
+    void move(int prisonerId, int facility);
+    int find(int prisonerId) const;              // -1 if nobody holds the ID
+    size_t size() const;
+};
+
+// Prisoner <-> crime case links, indexed both ways so either join is a single
+// hash lookup. The prisoners' own caseIds are what gets saved; the jails add
+// and drop a prisoner's links here as it is added, loaded or removed. Locked
+// after a jail's lock, never before.
+class CaseLinkIndex {
+    FlatHashMap<int, vector<int>> casesByPrisoner;
+    FlatHashMap<int, vector<int>> prisonersByCase;
+    size_t links = 0;
+    mutable shared_mutex linkMutex;
+
+    static bool eraseValue(vector<int>& from, int value);  // Swap-remove
+public:
+    bool link(int prisonerId, int caseId);  // False if already linked
+    bool unlink(int prisonerId, int caseId);
+    void linkAll(int prisonerId, const vector<int>& caseIds);
+    void unlinkAll(int prisonerId);
+    vector<int> casesOf(int prisonerId) const;
+    vector<int> prisonersOf(int caseId) const;
+    size_t size() const;  // Links
+};
+
+// A fuzzy search hit: a copy of the prisoner, its score and which field matched
+struct PrisonerMatch {
+    Prisoner prisoner;
+    double score;
+    string field;      // "name" or "crime"
+    int facility = 0;  // Index in JailRegistry
+};
+
+// One facility. Thread-safe: queries take jailMutex shared, changes take it
+// exclusive. The officer roster is locked after it, never before. Prisoners
+// and cells are not handed out by pointer; callers get copies or JSON.
 class Jail {
     static const int NUM_HIGH_SEC_CELLS = 5;
     static const int NUM_STANDARD_CELLS = 10;
     static const int HIGH_SEC_CAPACITY = 2;
     static const int STANDARD_CAPACITY = 4;
     
-    ListTemplate<HighSecurityCell> highSecCells;
+    // Which list a cell lives in and its handle there
+    struct CellRef {
+        bool highSecurity;
+        SlotHandle handle;
+    };
+
+    ListTemplate<HighSecurityCell> highSecCells;  // Own the cells
     ListTemplate<StandardCell> standardCells;
-    map<int, Cell*> cellMap;
-    map<int, Prisoner*> prisonerMap;
+    FlatHashMap<int, CellRef> cellMap;  // cellId -> cell, resolved by findCell()
+    FlatHashMap<int, Prisoner*> prisonerMap;
+    map<int, int> pendingOfficerLinks;  // cellId -> CO ID not linked to the roster yet
+    string name;
+    string dataFile;
+    int facility;                   // Index in JailRegistry
+    PrisonerDirectory* directory;   // nullptr for a jail outside the registry
+    CaseLinkIndex* caseLinks;       // Likewise
+    ModuleState state;  // Loaded/dirty tracking for dataFile
+    mutable shared_mutex jailMutex;
+    friend class JailRegistry;  // Transfers lock two jails at once
+
+    // Kept up to date by seat()/unseat(), so occupancy queries never walk prisoners
+    vector<int> cellsByOccupancy;  // [n] = cells holding n prisoners
+    int fullCells = 0;
+    int housedPrisoners = 0;
+    ReleaseCalendar releases;  // Every prisoner, by release date
+    TrigramIndex nameIndex;    // Every prisoner's name, for searchPrisoners()
+    TrigramIndex crimeIndex;   // Every prisoner's crime, searched alongside the names
+
+    bool assignPrisonerToCellLocked(int prisonerId, int cellId);
+    bool seat(Cell* cell, Prisoner* prisoner);
+    void unseat(Cell* cell, Prisoner* prisoner);
+    bool removePrisonerLocked(int prisonerId);
+    Prisoner* detachPrisonerLocked(int prisonerId);  // Out of the cell, calendar and indexes; caller owns it
+    void attachPrisonerLocked(Prisoner* prisoner, Cell* cell);
+    void listCellRange(int firstId, int lastId) const;
     
     void initializeCells() {
         // Initialize High Security Cells
         for (int i = 1; i <= NUM_HIGH_SEC_CELLS; i++) {
-            HighSecurityCell* cell = new HighSecurityCell(i, HIGH_SEC_CAPACITY);
-            highSecCells.add(*cell);
-            cellMap[i] = cell;
+            cellMap[i] = CellRef{true, highSecCells.add(HighSecurityCell(i, HIGH_SEC_CAPACITY))};
         }
         
         // Initialize Standard Cells
         for (int i = NUM_HIGH_SEC_CELLS + 1; i <= NUM_HIGH_SEC_CELLS + NUM_STANDARD_CELLS; i++) {
-            StandardCell* cell = new StandardCell(i, STANDARD_CAPACITY);
-            standardCells.add(*cell);
-            cellMap[i] = cell;
+            cellMap[i] = CellRef{false, standardCells.add(StandardCell(i, STANDARD_CAPACITY))};
         }
+
+        cellsByOccupancy.assign((HIGH_SEC_CAPACITY > STANDARD_CAPACITY ? HIGH_SEC_CAPACITY : STANDARD_CAPACITY) + 1, 0);
+        cellsByOccupancy[0] = NUM_HIGH_SEC_CELLS + NUM_STANDARD_CELLS;
+    }
+
+    // nullptr for an unknown cell ID; don't keep the pointer past the lock
+    Cell* findCell(int cellId) {
+        auto it = cellMap.find(cellId);
+        if (it == cellMap.end()) return nullptr;
+        const CellRef& ref = it->second;
+        return ref.highSecurity ? static_cast<Cell*>(highSecCells.get(ref.handle)) : standardCells.get(ref.handle);
+    }
+    const Cell* findCell(int cellId) const {
+        return const_cast<Jail*>(this)->findCell(cellId);
     }
     
 public:
-    Jail();
+    Jail(const string& name = "Central", const string& dataFile = "jail_data.json",
+         int facility = 0, PrisonerDirectory* directory = nullptr, CaseLinkIndex* caseLinks = nullptr);
+    Jail(const Jail&) = delete;
+    Jail& operator=(const Jail&) = delete;
     ~Jail() {
-        // Clean up cells
-        for (auto& pair : cellMap) {
-            delete pair.second;
-        }
-        // Clean up prisoners
+        // Cells are owned by their lists; clean up prisoners
         for (auto& pair : prisonerMap) {
             delete pair.second;
         }
     }
     
+    const string& getName() const { return name; }
+    const string& getDataFile() const { return dataFile; }
     void listCells();
+    json toJson() const;  // Prisoners and cell assignments as saved in dataFile
     void save();
     void load();
+    void loadFromJson(const json& j);  // COs stay pending until resolveCellOfficers()
+    size_t resolveCellOfficers();
+    size_t getPendingOfficerLinks() const;
+    void unlinkCellOfficers();  // Back to IDs before the officer roster is replaced
+    ModuleState& getState() { return state; }
     
     // Prisoner management methods
     bool addPrisoner(const Prisoner& prisoner);
@@ -147,8 +310,35 @@ public:
     bool changePrisonerCell(int prisonerId, int newCellId);
     bool removePrisoner(int prisonerId);
     void listPrisoners();
-    Prisoner* getPrisoner(int prisonerId);
-    Cell* getCell(int cellId);
+    size_t getPrisonerCount() const;
+    bool findPrisoner(int prisonerId, Prisoner& out) const;  // Copies the prisoner out
+    vector<Prisoner> getPrisoners() const;  // Copies, by ID
+    // Case links by ID only; JailRegistry::linkCase() checks the case exists
+    bool linkCase(int prisonerId, int caseId);
+    bool unlinkCase(int prisonerId, int caseId);
+    size_t linkCases(const vector<pair<int, int>>& links);  // (prisonerId, caseId) under one lock; returns how many were new
+    // Best `limit` prisoners whose name or crime is close to the query,
+    // misspellings included; see TrigramIndex.h for the scoring
+    vector<PrisonerMatch> searchPrisoners(const string& query, size_t limit = 10) const;
+    json cellsToJson() const;  // Every cell with its occupants and CO
+    
+    // Occupancy queries, answered from counters
+    int getFullCellCount() const;
+    int getEmptyCellCount() const;
+    int getHousedPrisonerCount() const;
+    vector<int> getOccupancyHistogram() const;  // [n] = cells holding n prisoners
+    vector<int> getFullCellIds() const;
+    vector<int> getEmptyCellIds() const;
+    json occupancyToJson() const;
+    void printOccupancy() const;
+    
+    // Release calendar; days as in ReleaseCalendar.h
+    vector<Prisoner> getReleasesBetween(int firstDay, int lastDay) const;  // Copies, by release date
+    void listReleasesThisWeek() const;
+    size_t countDueReleases(int today) const;
+    // Removes everyone due on or before `today`, batchSize prisoners per lock hold;
+    // returns how many were released
+    size_t processReleases(int today, size_t batchSize = 1000);
     
     // Officer management methods
     bool assignOfficerToCell(int officerId, int cellId);
@@ -162,13 +352,49 @@ public:
     int getStandardCapacity() const { return STANDARD_CAPACITY; }
 };
 
+// Every facility, each a Jail with its own data file, lock and indexes. The
+// list is read once from facilities.json:
+//   {"facilities": [{"name": "Central", "file": "jail_data.json"}, ...]}
+// Without that file there is one facility, "Central", in jail_data.json.
 class JailRegistry {
     static JailRegistry* instance;
-    Jail jail;
-    JailRegistry() {}
+    PrisonerDirectory directory;
+    CaseLinkIndex caseLinks;
+    vector<unique_ptr<Jail>> facilities;
+    JailRegistry();
 public:
     static JailRegistry* getInstance();
-    Jail& getJail();
+    Jail& getJail();  // The first facility
+    Jail& getJail(size_t facility);
+    size_t getFacilityCount() const { return facilities.size(); }
+    int findFacility(const string& name) const;  // -1 if there's no such facility
+
+    // Across all facilities
+    int locatePrisoner(int prisonerId) const;  // Facility index, or -1; O(1)
+    bool findPrisoner(int prisonerId, Prisoner& out, int& facility) const;
+    size_t getPrisonerCount() const;
+    vector<PrisonerMatch> searchPrisoners(const string& query, size_t limit = 10) const;  // Best first
+    // In whichever facility holds the prisoner; false if none does (or the cell there is full or missing)
+    bool changePrisonerCell(int prisonerId, int cellId);
+    bool removePrisoner(int prisonerId);
+    size_t processReleases(int today);  // Every facility; returns how many were released
+    size_t countDueReleases(int today) const;
+    // Moves a prisoner to another facility, into cellId there (-1 for no
+    // cell). Both jails are locked for the move, so nobody sees the prisoner
+    // in both or neither; fails without changing anything if the prisoner,
+    // facility or a free place in the cell is missing.
+    bool transferPrisoner(int prisonerId, size_t toFacility, int cellId = -1);
+    json facilitiesToJson() const;
+
+    // Prisoner <-> crime case links. linkCase() fails for an unknown prisoner
+    // or case, or a link that already exists.
+    bool linkCase(int prisonerId, int caseId);
+    bool unlinkCase(int prisonerId, int caseId);
+    size_t linkCases(const vector<pair<int, int>>& links);  // Skips prisoners not held anywhere
+    size_t dropCase(int caseId);  // After the case is deleted; returns prisoners unlinked
+    vector<int> getCasesOf(int prisonerId) const { return caseLinks.casesOf(prisonerId); }
+    vector<int> getPrisonersOf(int caseId) const { return caseLinks.prisonersOf(caseId); }
+    size_t getCaseLinkCount() const { return caseLinks.size(); }
 };
 
 void jailMenu(); 
\ No newline at end of file
@@ -1,28 +1,134 @@
 #pragma once
 #include <vector>
 #include <iostream>
+#include <cstdint>
+#include <utility>
 using namespace std;
 
+// Names an item in a ListTemplate. Stays valid while the item is in the list,
+// however many other items are added or removed; once the item is removed the
+// handle goes stale and lookups with it return nullptr. The default handle
+// never names anything.
+struct SlotHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;  // 0 only for the null handle
+
+    bool isNull() const { return generation == 0; }
+    bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+// Generational slot map. Items are kept densely in one vector, so iteration
+// and operator[] walk contiguous memory; a side table of slots maps handles to
+// dense positions. Add, remove and lookup by handle are all O(1): removing
+// moves the last item into the hole, so positions (but not handles) change.
+// Adding may reallocate, so hold handles rather than pointers across changes.
 template<typename T>
 class ListTemplate {
 private:
+    struct Slot {
+        uint32_t dense;       // Position in items while live; next free slot otherwise
+        uint32_t generation;  // Bumped on every removal
+    };
+    static const uint32_t NO_SLOT = UINT32_MAX;
+
     vector<T> items;
+    vector<uint32_t> slotOf;  // Same positions as items -> slot index
+    vector<Slot> slots;
+    uint32_t freeHead = NO_SLOT;
+
+    // Slot for the item just added at the back of items
+    SlotHandle claimSlot() {
+        uint32_t index;
+        if (freeHead != NO_SLOT) {
+            index = freeHead;
+            freeHead = slots[index].dense;
+        } else {
+            index = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{0, 1});
+        }
+        slots[index].dense = static_cast<uint32_t>(items.size() - 1);
+        slotOf.push_back(index);
+        return SlotHandle{index, slots[index].generation};
+    }
+
+    // Position of the item, or items.size() for a stale or null handle
+    size_t denseOf(SlotHandle h) const {
+        if (h.index >= slots.size() || slots[h.index].generation != h.generation) return items.size();
+        return slots[h.index].dense;
+    }
+
+    void releaseSlot(uint32_t index) {
+        if (++slots[index].generation == 0) slots[index].generation = 1;  // 0 is the null handle
+        slots[index].dense = freeHead;
+        freeHead = index;
+    }
+
 public:
-    void add(const T& item) { items.push_back(item); }
+    SlotHandle add(const T& item) { return emplace(item); }
+    SlotHandle add(T&& item) { return emplace(std::move(item)); }
+
+    template<typename... Args>
+    SlotHandle emplace(Args&&... args) {
+        items.emplace_back(std::forward<Args>(args)...);
+        return claimSlot();
+    }
+
+    T* get(SlotHandle h) {
+        size_t d = denseOf(h);
+        return d < items.size() ? &items[d] : nullptr;
+    }
+    const T* get(SlotHandle h) const {
+        size_t d = denseOf(h);
+        return d < items.size() ? &items[d] : nullptr;
+    }
+    bool contains(SlotHandle h) const { return denseOf(h) < items.size(); }
+
+    // False if the handle is already stale
+    bool remove(SlotHandle h) {
+        size_t d = denseOf(h);
+        if (d >= items.size()) return false;
+        size_t last = items.size() - 1;
+        if (d != last) {
+            items[d] = std::move(items[last]);
+            slotOf[d] = slotOf[last];
+            slots[slotOf[d]].dense = static_cast<uint32_t>(d);
+        }
+        items.pop_back();
+        slotOf.pop_back();
+        releaseSlot(h.index);
+        return true;
+    }
+
+    // Handle of the item now at position a
+    SlotHandle handleAt(size_t a) const {
+        uint32_t index = slotOf.at(a);
+        return SlotHandle{index, slots[index].generation};
+    }
+
     T& operator[](size_t a) { return items.at(a); }
     size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    void reserve(size_t n) { items.reserve(n); slotOf.reserve(n); slots.reserve(n); }
+    typename vector<T>::iterator begin() { return items.begin(); }
+    typename vector<T>::iterator end() { return items.end(); }
     typename vector<T>::const_iterator begin() const { return items.begin(); }
     typename vector<T>::const_iterator end() const { return items.end(); }
-    void clear() { items.clear(); }
-    
+
+    // Every outstanding handle goes stale
+    void clear() {
+        for (uint32_t index : slotOf) releaseSlot(index);
+        items.clear();
+        slotOf.clear();
+    }
+
     void removeAt(size_t a) {
         if (a < items.size()) {
-            items.erase(items.begin() + a);
+            remove(handleAt(a));
         }
     }
-    
+
     const T& operator[](size_t a) const {
         return items.at(a);
     }
-}; 
-
+};
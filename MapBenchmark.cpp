@@ -0,0 +1,90 @@
+#include "MapBenchmark.h"
+#include "FlatHashMap.h"
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+using namespace std;
+
+struct MapTimings {
+    double insertNs, lookupNs, eraseNs;
+    size_t checksum;  // Keeps the lookups from being optimised away
+};
+
+// IDs 1..n like the registries hand out, inserted and looked up in random order
+template<typename Map>
+static MapTimings timeMap(const vector<int>& insertOrder, const vector<int>& lookupOrder, const vector<int>& eraseOrder) {
+    typedef chrono::steady_clock clock;
+    MapTimings t;
+    Map m;
+
+    auto start = clock::now();
+    for (int id : insertOrder) m[id] = static_cast<size_t>(id) * 3;
+    t.insertNs = chrono::duration<double, nano>(clock::now() - start).count() / insertOrder.size();
+
+    t.checksum = 0;
+    start = clock::now();
+    for (int id : lookupOrder) {
+        auto it = m.find(id);
+        if (it != m.end()) t.checksum += it->second;
+    }
+    t.lookupNs = chrono::duration<double, nano>(clock::now() - start).count() / lookupOrder.size();
+
+    start = clock::now();
+    for (int id : eraseOrder) m.erase(id);
+    t.eraseNs = chrono::duration<double, nano>(clock::now() - start).count() / eraseOrder.size();
+    return t;
+}
+
+static void printRow(const string& name, const MapTimings& t) {
+    cout << "  " << left << setw(14) << name << right
+         << setw(10) << t.insertNs << setw(10) << t.lookupNs << setw(10) << t.eraseNs << "\n";
+}
+
+void benchmarkIdMaps(size_t maxEntries) {
+    vector<size_t> sizes;
+    for (size_t n = 10000; n <= maxEntries; n *= 10) sizes.push_back(n);
+    if (sizes.empty()) sizes.push_back(maxEntries > 0 ? maxEntries : 1);
+
+    mt19937 rng(42);
+    cout << "\nID index benchmark (ns per operation; every ID looked up once, 1 in 4 a miss; half erased)\n";
+    cout << fixed << setprecision(1);
+    for (size_t n : sizes) {
+        vector<int> insertOrder(n);
+        for (size_t i = 0; i < n; i++) insertOrder[i] = static_cast<int>(i + 1);
+        shuffle(insertOrder.begin(), insertOrder.end(), rng);
+
+        vector<int> lookupOrder(insertOrder);
+        shuffle(lookupOrder.begin(), lookupOrder.end(), rng);
+        for (size_t i = 0; i < n; i += 4) lookupOrder[i] = static_cast<int>(n + 1 + i);  // Not present
+
+        vector<int> eraseOrder(insertOrder.begin(), insertOrder.begin() + n / 2);
+        shuffle(eraseOrder.begin(), eraseOrder.end(), rng);
+        if (eraseOrder.empty()) eraseOrder.push_back(insertOrder[0]);
+
+        MapTimings tree = timeMap<map<int, size_t>>(insertOrder, lookupOrder, eraseOrder);
+        MapTimings flat = timeMap<FlatHashMap<int, size_t>>(insertOrder, lookupOrder, eraseOrder);
+
+        cout << "\n" << n << " entries\n";
+        cout << "  " << setw(14) << "" << setw(10) << "insert" << setw(10) << "lookup" << setw(10) << "erase" << "\n";
+        printRow("map", tree);
+        printRow("FlatHashMap", flat);
+        cout << "  " << left << setw(14) << "speedup" << right
+             << setw(9) << tree.insertNs / flat.insertNs << "x"
+             << setw(9) << tree.lookupNs / flat.lookupNs << "x"
+             << setw(9) << tree.eraseNs / flat.eraseNs << "x\n";
+        if (tree.checksum != flat.checksum) {
+            cout << "  Warning: lookups disagree (" << tree.checksum << " vs " << flat.checksum << ")\n";
+        }
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+}
+
+int runMapBenchmarkMode(size_t maxEntries) {
+    benchmarkIdMaps(maxEntries);
+    return 0;
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <cstddef>
+using namespace std;
+
+// Times insert, lookup and erase on map<int, ...> (what the registries used
+// before) and FlatHashMap, at 10k entries and every power of ten up to maxEntries
+void benchmarkIdMaps(size_t maxEntries = 10000000);
+
+int runMapBenchmarkMode(size_t maxEntries);
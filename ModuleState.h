@@ -0,0 +1,128 @@
+#pragma once
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#include <sys/stat.h>
+#ifdef __unix__
+#include <unistd.h>
+#endif
+using namespace std;
+
+// What a data file looked like on disk: enough to notice edits made outside
+// the program without reading the file
+struct FileStamp {
+    bool exists;
+    long long mtime;
+    long long size;
+
+    FileStamp() : exists(false), mtime(0), size(0) {}
+
+    static FileStamp of(const string& path) {
+        FileStamp stamp;
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0) {
+            stamp.exists = true;
+#ifdef __linux__
+            stamp.mtime = static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#else
+            stamp.mtime = static_cast<long long>(info.st_mtime);
+#endif
+            stamp.size = static_cast<long long>(info.st_size);
+        }
+        return stamp;
+    }
+
+    bool operator==(const FileStamp& other) const {
+        return exists == other.exists && mtime == other.mtime && size == other.size;
+    }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+// Writes `contents` to `tmp`, flushed all the way to disk. Paired with a
+// rename() over the real file, a crash or a concurrent reader only ever sees
+// the old file or the new one, never half of each.
+inline bool writeTempFile(const string& tmp, const string& contents) {
+    FILE* file = fopen(tmp.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = fflush(file) == 0 && ok;
+#ifdef __unix__
+    ok = fsync(fileno(file)) == 0 && ok;
+#endif
+    ok = fclose(file) == 0 && ok;
+    if (!ok) remove(tmp.c_str());
+    return ok;
+}
+
+inline bool writeFileAtomically(const string& path, const string& contents) {
+    string tmp = path + ".tmp";
+    return writeTempFile(tmp, contents) && rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+// Load-once lifecycle shared by the managers: whether the data has been
+// loaded, whether memory holds unsaved changes, and the stamp of each data
+// file as of the last read or write.
+// Every change bumps a version number; the module is dirty until that
+// version (or a later one) has been written.
+class ModuleState {
+    atomic<bool> loaded;
+    atomic<unsigned long long> version;
+    atomic<unsigned long long> savedVersion;
+    mutable mutex stampMutex;
+    map<string, FileStamp> stamps;
+
+public:
+    ModuleState() : loaded(false), version(0), savedVersion(0) {}
+
+    bool isLoaded() const { return loaded; }
+    bool isDirty() const { return version != savedVersion; }
+    unsigned long long getVersion() const { return version; }
+    void markDirty() { ++version; }
+    void clearDirty() { savedVersion = version.load(); }
+
+    // `before` is the stamp taken just before reading, so an edit made while
+    // parsing still shows up as a change
+    void markLoaded(const string& file, const FileStamp& before) {
+        lock_guard<mutex> lock(stampMutex);
+        stamps[file] = before;
+        loaded = true;
+    }
+
+    void markSaved(const string& file) {
+        lock_guard<mutex> lock(stampMutex);
+        stamps[file] = FileStamp::of(file);
+    }
+
+    // Replaces `file` with a snapshot of version `ver`. The temp file is written
+    // without holding the lock; the rename is skipped if a newer version
+    // already reached the disk, so a late background write can't undo a save.
+    bool writeFile(const string& file, const string& contents, unsigned long long ver) {
+        static atomic<unsigned> tmpCounter(0);
+        string tmp = file + ".tmp" + to_string(++tmpCounter);
+        if (!writeTempFile(tmp, contents)) return false;
+
+        lock_guard<mutex> lock(stampMutex);
+        if (ver < savedVersion) {
+            remove(tmp.c_str());
+            return true;
+        }
+        if (rename(tmp.c_str(), file.c_str()) != 0) {
+            remove(tmp.c_str());
+            return false;
+        }
+        stamps[file] = FileStamp::of(file);
+        if (ver > savedVersion) savedVersion = ver;
+        return true;
+    }
+
+    // One stat() per tracked file; doesn't read the data
+    bool changedOnDisk() const {
+        lock_guard<mutex> lock(stampMutex);
+        for (const auto& entry : stamps) {
+            if (FileStamp::of(entry.first) != entry.second) return true;
+        }
+        return false;
+    }
+};
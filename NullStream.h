@@ -0,0 +1,10 @@
+#pragma once
+#include <streambuf>
+using namespace std;
+
+// Swallows whatever is written to it. Batch runs and the stress test point
+// cout here so the managers' per-change confirmations stay out of their reports.
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
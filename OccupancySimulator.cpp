@@ -0,0 +1,359 @@
+#include "OccupancySimulator.h"
+#include "JailModule.h"
+#include "ThreadPool.h"
+#include <random>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+using namespace std;
+
+int FacilityLayout::totalCapacity() const {
+    int total = 0;
+    for (const SimCell& cell : cells) total += cell.capacity;
+    return total;
+}
+
+bool arrivalProcessFromName(const string& name, ArrivalProcess& out) {
+    if (name == "poisson") out = ArrivalProcess::Poisson;
+    else if (name == "constant") out = ArrivalProcess::Constant;
+    else if (name == "bursty") out = ArrivalProcess::Bursty;
+    else return false;
+    return true;
+}
+
+bool sentenceDistributionFromName(const string& name, SentenceDistribution& out) {
+    if (name == "fixed") out = SentenceDistribution::Fixed;
+    else if (name == "exponential") out = SentenceDistribution::Exponential;
+    else if (name == "lognormal") out = SentenceDistribution::Lognormal;
+    else if (name == "uniform") out = SentenceDistribution::Uniform;
+    else return false;
+    return true;
+}
+
+const char* arrivalProcessName(ArrivalProcess process) {
+    switch (process) {
+    case ArrivalProcess::Constant: return "constant";
+    case ArrivalProcess::Bursty: return "bursty";
+    default: return "poisson";
+    }
+}
+
+const char* sentenceDistributionName(SentenceDistribution distribution) {
+    switch (distribution) {
+    case SentenceDistribution::Fixed: return "fixed";
+    case SentenceDistribution::Lognormal: return "lognormal";
+    case SentenceDistribution::Uniform: return "uniform";
+    default: return "exponential";
+    }
+}
+
+FacilityLayout FacilityLayout::uniform(int highSecCells, int highSecCapacity, int standardCells, int standardCapacity) {
+    FacilityLayout layout;
+    layout.cells.reserve(max(0, highSecCells) + max(0, standardCells));
+    for (int i = 0; i < highSecCells; i++) layout.cells.push_back(SimCell{highSecCapacity, true});
+    for (int i = 0; i < standardCells; i++) layout.cells.push_back(SimCell{standardCapacity, false});
+    return layout;
+}
+
+FacilityLayout FacilityLayout::of(const Jail& jail) {
+    FacilityLayout layout;
+    int today = currentDay();
+    for (const auto& cellJson : jail.cellsToJson()) {
+        int index = layout.cells.size();
+        layout.cells.push_back(SimCell{cellJson["capacity"].get<int>(), cellJson["type"].get<string>() == "High Security"});
+        for (const auto& id : cellJson["prisonerIds"]) {
+            Prisoner p;
+            if (!jail.findPrisoner(id.get<int>(), p)) continue;  // Released since the cell list was taken
+            int daysLeft = p.getReleaseDay() != NO_DAY ? max(1, p.getReleaseDay() - today) : INT_MAX;  // No release: stays
+            layout.occupants.push_back(Occupant{index, daysLeft});
+        }
+    }
+    return layout;
+}
+
+namespace {
+
+struct TrialStats {
+    long long housedDays;  // Sum of the daily occupancy
+    int peak;
+    int arrivals;
+    int rejections;
+    int overflowDays;
+    int fullDays;
+};
+
+// Everything one worker needs for a trial, sized once from the layout and
+// config. run() only resets and reuses it.
+class TrialRunner {
+    const FacilityLayout& layout;
+    const SimulationConfig& config;
+    int horizon;   // Warm-up plus measured days
+    int capacity;
+    bool hasHigh, hasStandard;  // With no cells of one kind, everybody goes to the other
+
+    vector<int> occupancy;    // Per cell
+    vector<int> openCells[2];  // Cells with room, by highSecurity
+    vector<int> openSlot;     // Position of each cell in its open list, -1 if full
+
+    // Pending releases: one singly linked list per day through a pool of
+    // places, so nothing is allocated while a trial runs
+    vector<int> releaseHead;  // Per day
+    vector<int> nextPlace;
+    vector<int> placeCell;
+    int freePlace;
+
+    mt19937_64 rng;
+    poisson_distribution<int> normalDay;
+    poisson_distribution<int> burstDay;
+    bernoulli_distribution isBurst;
+    bernoulli_distribution needsHighSecurity;
+    exponential_distribution<double> exponentialSentence;
+    lognormal_distribution<double> lognormalSentence;
+    uniform_real_distribution<double> uniformSentence;
+    double carry;  // Fractional arrivals for ArrivalProcess::Constant
+
+    void markOpen(int cell) {
+        vector<int>& open = openCells[layout.cells[cell].highSecurity];
+        openSlot[cell] = open.size();
+        open.push_back(cell);
+    }
+
+    void markFull(int cell) {
+        vector<int>& open = openCells[layout.cells[cell].highSecurity];
+        int slot = openSlot[cell];
+        open[slot] = open.back();
+        openSlot[open[slot]] = slot;
+        open.pop_back();
+        openSlot[cell] = -1;
+    }
+
+    void admit(int cell, int releaseDay) {
+        if (++occupancy[cell] == layout.cells[cell].capacity) markFull(cell);
+        if (releaseDay >= horizon || freePlace < 0) return;  // Still inside when the trial ends
+        int place = freePlace;
+        freePlace = nextPlace[place];
+        placeCell[place] = cell;
+        nextPlace[place] = releaseHead[releaseDay];
+        releaseHead[releaseDay] = place;
+    }
+
+    int releaseDueOn(int day) {
+        int released = 0;
+        for (int place = releaseHead[day]; place >= 0;) {
+            int cell = placeCell[place];
+            if (occupancy[cell]-- == layout.cells[cell].capacity) markOpen(cell);
+            int next = nextPlace[place];
+            nextPlace[place] = freePlace;
+            freePlace = place;
+            place = next;
+            released++;
+        }
+        releaseHead[day] = -1;
+        return released;
+    }
+
+    int arrivalsToday() {
+        switch (config.arrivals) {
+        case ArrivalProcess::Constant: {
+            carry += config.arrivalsPerDay;
+            int n = static_cast<int>(carry);
+            carry -= n;
+            return n;
+        }
+        case ArrivalProcess::Bursty:
+            return isBurst(rng) ? burstDay(rng) : normalDay(rng);
+        default:
+            return normalDay(rng);
+        }
+    }
+
+    int sentenceDays() {
+        double days;
+        switch (config.sentences) {
+        case SentenceDistribution::Fixed: days = config.meanSentenceDays; break;
+        case SentenceDistribution::Lognormal: days = lognormalSentence(rng); break;
+        case SentenceDistribution::Uniform: days = uniformSentence(rng); break;
+        default: days = exponentialSentence(rng); break;
+        }
+        return days < 1.0 ? 1 : static_cast<int>(days + 0.5);
+    }
+
+public:
+    TrialRunner(const FacilityLayout& layout, const SimulationConfig& config)
+        : layout(layout), config(config),
+          horizon(max(0, config.warmupDays) + max(1, config.days)),
+          capacity(layout.totalCapacity()), hasHigh(false), hasStandard(false),
+          occupancy(layout.cells.size()), openSlot(layout.cells.size()),
+          releaseHead(horizon), nextPlace(capacity), placeCell(capacity), freePlace(-1),
+          normalDay(max(1e-9, config.arrivalsPerDay)),
+          burstDay(max(1e-9, config.arrivalsPerDay * config.burstFactor)),
+          isBurst(min(1.0, max(0.0, config.burstProbability))),
+          needsHighSecurity(min(1.0, max(0.0, config.highSecurityShare))),
+          exponentialSentence(1.0 / max(1.0, config.meanSentenceDays)),
+          lognormalSentence(log(max(1.0, config.meanSentenceDays)) - config.sentenceSigma * config.sentenceSigma / 2,
+                            max(1e-9, config.sentenceSigma)),
+          uniformSentence(1.0, max(1.0, 2 * config.meanSentenceDays)),
+          carry(0.0) {
+        for (const FacilityLayout::SimCell& cell : layout.cells) {
+            if (cell.highSecurity) hasHigh = true;
+            else hasStandard = true;
+        }
+        openCells[0].reserve(layout.cells.size());
+        openCells[1].reserve(layout.cells.size());
+    }
+
+    TrialStats run(size_t trial) {
+        // A separate, reproducible stream per trial (splitmix64 of the seed)
+        uint64_t z = config.seed + 0x9E3779B97F4A7C15ull * (trial + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        rng.seed(z ^ (z >> 31));
+        normalDay.reset();
+        burstDay.reset();
+        lognormalSentence.reset();
+        carry = 0.0;
+
+        openCells[0].clear();
+        openCells[1].clear();
+        for (size_t c = 0; c < layout.cells.size(); c++) {
+            occupancy[c] = 0;
+            openSlot[c] = -1;
+            if (layout.cells[c].capacity > 0) markOpen(c);
+        }
+        fill(releaseHead.begin(), releaseHead.end(), -1);
+        freePlace = capacity > 0 ? 0 : -1;
+        for (int p = 0; p < capacity; p++) nextPlace[p] = p + 1 < capacity ? p + 1 : -1;
+
+        int housed = 0;
+        for (const FacilityLayout::Occupant& o : layout.occupants) {
+            if (occupancy[o.cell] >= layout.cells[o.cell].capacity) continue;
+            admit(o.cell, o.daysLeft);
+            housed++;
+        }
+
+        TrialStats stats = {0, housed, 0, 0, 0, 0};
+        for (int day = 0; day < horizon; day++) {
+            housed -= releaseDueOn(day);
+            int rejectedToday = 0;
+            int arrivals = arrivalsToday();
+            for (int i = 0; i < arrivals; i++) {
+                bool high = hasHigh && (!hasStandard || needsHighSecurity(rng));
+                int sentence = sentenceDays();
+                vector<int>& open = openCells[high];
+                if (open.empty()) {
+                    rejectedToday++;
+                    continue;
+                }
+                admit(open.back(), day + sentence);
+                housed++;
+            }
+            if (day < config.warmupDays) continue;
+            stats.housedDays += housed;
+            stats.peak = max(stats.peak, housed);
+            stats.arrivals += arrivals;
+            stats.rejections += rejectedToday;
+            if (rejectedToday > 0) stats.overflowDays++;
+            if (housed == capacity) stats.fullDays++;
+        }
+        return stats;
+    }
+};
+
+}  // namespace
+
+SimulationResult simulateOccupancy(const FacilityLayout& layout, const SimulationConfig& config) {
+    SimulationResult result;
+    result.trials = config.trials;
+    result.capacity = layout.totalCapacity();
+    if (config.trials == 0 || layout.cells.empty()) return result;
+
+    auto start = chrono::steady_clock::now();
+    vector<TrialStats> trials(config.trials);
+    size_t workers = config.threads > 0 ? config.threads : ThreadPool::defaultThreadCount();
+    workers = min(workers, config.trials);
+    {
+        ThreadPool pool(workers);
+        vector<future<void>> done;
+        for (size_t w = 0; w < workers; w++) {
+            done.push_back(pool.enqueue([&, w]() {
+                TrialRunner runner(layout, config);
+                for (size_t t = w; t < config.trials; t += workers) {
+                    trials[t] = runner.run(t);
+                }
+            }));
+        }
+        for (auto& f : done) f.get();
+    }
+
+    int measuredDays = max(1, config.days);
+    vector<int> peaks;
+    peaks.reserve(trials.size());
+    double housed = 0, arrivals = 0, rejections = 0, overflowDays = 0, fullDays = 0, overflowed = 0;
+    for (const TrialStats& t : trials) {
+        housed += static_cast<double>(t.housedDays) / measuredDays;
+        peaks.push_back(t.peak);
+        arrivals += t.arrivals;
+        rejections += t.rejections;
+        overflowDays += t.overflowDays;
+        fullDays += t.fullDays;
+        if (t.rejections > 0) overflowed++;
+    }
+    double n = trials.size();
+    sort(peaks.begin(), peaks.end());
+    auto percentile = [&peaks](double q) { return peaks[min(peaks.size() - 1, static_cast<size_t>(q * peaks.size()))]; };
+
+    result.meanOccupancy = housed / n;
+    double peakSum = 0;
+    for (int p : peaks) peakSum += p;
+    result.meanPeakOccupancy = peakSum / n;
+    result.peakP50 = percentile(0.50);
+    result.peakP95 = percentile(0.95);
+    result.peakP99 = percentile(0.99);
+    result.peakMax = peaks.back();
+    result.meanArrivals = arrivals / n;
+    result.meanRejections = rejections / n;
+    result.rejectionRate = arrivals > 0 ? rejections / arrivals : 0.0;
+    result.overflowProbability = overflowed / n;
+    result.meanOverflowDays = overflowDays / n;
+    result.meanFullDays = fullDays / n;
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void printSimulationResult(const SimulationResult& result, ostream& os) {
+    os << "\n=== Occupancy Simulation ===\n";
+    os << "Trials:            " << result.trials << "\n";
+    os << "Capacity:          " << result.capacity << " places\n";
+    os << fixed << setprecision(1);
+    os << "Mean occupancy:    " << result.meanOccupancy << " ("
+       << (result.capacity > 0 ? 100.0 * result.meanOccupancy / result.capacity : 0.0) << "%)\n";
+    os << "Peak occupancy:    mean " << result.meanPeakOccupancy << ", p50 " << result.peakP50
+       << ", p95 " << result.peakP95 << ", p99 " << result.peakP99 << ", max " << result.peakMax << "\n";
+    os << "Arrivals/trial:    " << result.meanArrivals << "\n";
+    os << "Rejections/trial:  " << result.meanRejections << " (" << 100.0 * result.rejectionRate << "% of arrivals)\n";
+    os << "Overflow risk:     " << 100.0 * result.overflowProbability << "% of trials turn someone away\n";
+    os << "Overflow days:     " << result.meanOverflowDays << " per trial\n";
+    os << "Full days:         " << result.meanFullDays << " per trial\n";
+    os << setprecision(3);
+    os << "Time:              " << result.seconds << " s\n";
+    os.unsetf(ios::floatfield);
+    os << setprecision(6);
+}
+
+int runSimulationMode(const SimulationConfig& config, int highSecCells, int highSecCapacity, int cells, int cellCapacity) {
+    FacilityLayout layout = FacilityLayout::uniform(highSecCells, highSecCapacity, cells, cellCapacity);
+    cout << "\nSimulating " << config.trials << " trial(s) of " << config.days << " day(s) over "
+         << highSecCells << " high security cell(s) of " << highSecCapacity << " and "
+         << cells << " standard cell(s) of " << cellCapacity << "\n";
+    cout << "Arrivals: " << arrivalProcessName(config.arrivals) << ", " << config.arrivalsPerDay << " per day";
+    if (config.arrivals == ArrivalProcess::Bursty) {
+        cout << " (" << config.burstFactor << "x on " << 100.0 * config.burstProbability << "% of days)";
+    }
+    cout << ", " << 100.0 * config.highSecurityShare << "% high security\n";
+    cout << "Sentences: " << sentenceDistributionName(config.sentences) << ", mean " << config.meanSentenceDays << " days";
+    if (config.sentences == SentenceDistribution::Lognormal) cout << " (sigma " << config.sentenceSigma << ")";
+    cout << "\n";
+    printSimulationResult(simulateOccupancy(layout, config), cout);
+    return 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <iostream>
+using namespace std;
+
+class Jail;
+
+// Cells of the facility being planned, and who is in them on day 0
+struct FacilityLayout {
+    struct SimCell {
+        int capacity;
+        bool highSecurity;
+    };
+    struct Occupant {
+        int cell;      // Index into cells
+        int daysLeft;  // Released at the start of this day
+    };
+
+    vector<SimCell> cells;
+    vector<Occupant> occupants;
+
+    int totalCapacity() const;
+    // highSecCells cells of highSecCapacity, then standardCells of standardCapacity, all empty
+    static FacilityLayout uniform(int highSecCells, int highSecCapacity, int standardCells, int standardCapacity);
+    // The jail's cells, with its housed prisoners staying until their release dates
+    static FacilityLayout of(const Jail& jail);
+};
+
+enum class ArrivalProcess {
+    Poisson,   // Independent arrivals at arrivalsPerDay on average
+    Constant,  // Exactly arrivalsPerDay every day (fractions carried over)
+    Bursty     // Poisson, but burstProbability of days get burstFactor times the rate
+};
+
+enum class SentenceDistribution {
+    Fixed,        // Always meanSentenceDays
+    Exponential,  // Mean meanSentenceDays
+    Lognormal,    // Mean meanSentenceDays, log-space spread sentenceSigma
+    Uniform       // 1 .. 2 * meanSentenceDays
+};
+
+// Names as given on the command line, lower case; false for an unknown name
+bool arrivalProcessFromName(const string& name, ArrivalProcess& out);          // poisson, constant, bursty
+bool sentenceDistributionFromName(const string& name, SentenceDistribution& out);  // fixed, exponential, lognormal, uniform
+const char* arrivalProcessName(ArrivalProcess process);
+const char* sentenceDistributionName(SentenceDistribution distribution);
+
+struct SimulationConfig {
+    int days = 365;           // Measured days per trial
+    int warmupDays = 0;       // Simulated first, left out of the statistics
+    double arrivalsPerDay = 10.0;
+    ArrivalProcess arrivals = ArrivalProcess::Poisson;
+    double burstProbability = 0.05;
+    double burstFactor = 3.0;
+    double meanSentenceDays = 180.0;
+    SentenceDistribution sentences = SentenceDistribution::Exponential;
+    double sentenceSigma = 0.8;
+    double highSecurityShare = 0.2;  // Arrivals that need a high security cell
+    size_t trials = 1000;
+    size_t threads = 0;              // 0: one per core
+    uint64_t seed = 42;              // Trial i always gets the same stream, whatever the thread count
+};
+
+struct SimulationResult {
+    size_t trials = 0;
+    int capacity = 0;
+    double seconds = 0.0;
+    double meanOccupancy = 0.0;      // Prisoners housed per day, over all trials
+    double meanPeakOccupancy = 0.0;
+    int peakP50 = 0, peakP95 = 0, peakP99 = 0, peakMax = 0;  // Of each trial's peak
+    double meanArrivals = 0.0;       // Per trial
+    double meanRejections = 0.0;     // Arrivals turned away because no suitable cell had room
+    double rejectionRate = 0.0;      // Rejections / arrivals
+    double overflowProbability = 0.0;  // Share of trials with at least one rejection
+    double meanOverflowDays = 0.0;   // Days per trial with at least one rejection
+    double meanFullDays = 0.0;       // Days per trial ending with every place taken
+};
+
+// Monte Carlo capacity planning. Each trial replays `days` of arrivals and
+// releases against the layout: an arrival goes to any cell of its kind with
+// room, or is rejected. Trials run in parallel on a thread pool; each worker
+// allocates its state once and reuses it, so the daily loop never allocates.
+SimulationResult simulateOccupancy(const FacilityLayout& layout, const SimulationConfig& config);
+void printSimulationResult(const SimulationResult& result, ostream& os);
+
+// A planned facility of highSecCells + cells empty cells
+int runSimulationMode(const SimulationConfig& config, int highSecCells, int highSecCapacity, int cells, int cellCapacity);
@@ -1,12 +1,15 @@
 #include "OfficerModule.h"
+#include "DataLoader.h"
+#include "PersistenceCoordinator.h"
 #include <fstream>
+#include <mutex>
 using json = nlohmann::json;
 using namespace std;
 
 OfficerRegistry* OfficerRegistry::instance = nullptr;
 
 // Initialize static member
-int Officer::nextId = 1;  // Start IDs from 1
+atomic<int> Officer::nextId(1);  // Start IDs from 1
 
 // Officer class implementations
 Officer* Officer::fromJson(const json& j) {
@@ -33,6 +36,15 @@ Officer* Officer::fromJson(const json& j) {
     return officer;
 }
 
+Officer* Officer::create(const string& role, const string& name) {
+    if (role == "SHO") return new SHO(name);
+    if (role == "CO") return new CO(name);
+    if (role == "Prosecutor") return new Prosecutor(name);
+    if (role == "Head Constable") return new HeadConstable(name);
+    if (role == "Constable") return new Constable(name);
+    return nullptr;
+}
+
 // SHO implementations
 void SHO::performDuty() const {
     cout << "Station House Officer " << name << " is managing the police station.\n";
@@ -114,20 +126,49 @@ vector<string> Constable::getResponsibilities() const {
     };
 }
 
-// OfficerManager implementations
-OfficerManager::~OfficerManager() {
-    for (auto* officer : officers) {
-        delete officer;
+// RosterSnapshot implementations
+void RosterSnapshot::add(shared_ptr<const Officer> officer) {
+    int id = officer->getId();
+    auto it = byId.find(id);
+    if (it != byId.end()) {  // Same ID again: the newer entry replaces the old one in place
+        for (auto& o : officers) {
+            if (o == it->second) o = officer;
+        }
+        it->second = officer;
+        return;
     }
+    officers.push_back(officer);
+    byId[id] = officer;
+}
+
+shared_ptr<const Officer> RosterSnapshot::find(int id) const {
+    auto it = byId.find(id);
+    return it != byId.end() ? it->second : nullptr;
+}
+
+// OfficerManager implementations
+OfficerManager::OfficerManager() : roster(make_shared<RosterSnapshot>()) {}
+
+shared_ptr<const RosterSnapshot> OfficerManager::snapshot() const {
+    return atomic_load(&roster);
+}
+
+// Callers hold writeMutex, so no other writer built on the version being replaced
+void OfficerManager::publish(shared_ptr<const RosterSnapshot> next) {
+    atomic_store(&roster, move(next));
+    state.markDirty();
 }
 
 void OfficerManager::addOfficer(Officer* o) {
-    officers.push_back(o);
-    officerMap[o->getId()] = o;
+    lock_guard<mutex> lock(writeMutex);
+    auto next = make_shared<RosterSnapshot>(*snapshot());
+    next->add(shared_ptr<const Officer>(o));
+    publish(move(next));
 }
 
 void OfficerManager::listOfficers() {
-    for (const auto* officer : officers) {
+    shared_ptr<const RosterSnapshot> current = snapshot();  // Keeps this version alive while iterating
+    for (const auto& officer : current->officers) {
         cout << *officer << endl;
         cout << "Responsibilities:\n";
         for (const auto& resp : officer->getResponsibilities()) {
@@ -141,7 +182,8 @@ json OfficerManager::toJson() const {
     json j;
     json officersArray = json::array();
     
-    for (const auto* officer : officers) {
+    shared_ptr<const RosterSnapshot> current = snapshot();
+    for (const auto& officer : current->officers) {
         officersArray.push_back(officer->toJson());
     }
     
@@ -150,12 +192,8 @@ json OfficerManager::toJson() const {
 }
 
 void OfficerManager::fromJson(const json& j) {
-    // Clear existing officers
-    for (auto* officer : officers) {
-        delete officer;
-    }
-    officers.clear();
-    officerMap.clear();
+    // Build the whole roster aside; readers see the old one until it is swapped in
+    auto next = make_shared<RosterSnapshot>();
     
     // First pass: find the highest ID
     int highestId = 0;
@@ -175,27 +213,65 @@ void OfficerManager::fromJson(const json& j) {
     for (const auto& officerJson : j["officers"]) {
         Officer* officer = Officer::fromJson(officerJson);
         if (officer) {
-            addOfficer(officer);
+            next->add(shared_ptr<const Officer>(officer));
         }
     }
+
+    lock_guard<mutex> lock(writeMutex);
+    publish(move(next));
+}
+
+size_t OfficerManager::getOfficerCount() const {
+    return snapshot()->officers.size();
+}
+
+shared_ptr<const Officer> OfficerManager::findOfficer(int id) const {
+    return snapshot()->find(id);
+}
+
+json OfficerManager::getOfficerJson(int id) const {
+    shared_ptr<const Officer> officer = findOfficer(id);
+    return officer ? officer->toJson() : json();
+}
+
+bool OfficerManager::readOfficer(int id, const function<void(const Officer&)>& visit) const {
+    shared_ptr<const Officer> officer = findOfficer(id);
+    if (!officer) return false;
+    visit(*officer);
+    return true;
+}
+
+bool OfficerManager::updateOfficer(int id, const function<void(Officer&)>& change) {
+    lock_guard<mutex> lock(writeMutex);
+    shared_ptr<const RosterSnapshot> current = snapshot();
+    shared_ptr<const Officer> officer = current->find(id);
+    if (!officer) return false;
+    shared_ptr<Officer> changed(officer->clone());
+    change(*changed);
+    auto next = make_shared<RosterSnapshot>(*current);
+    next->add(changed);
+    atomic_store(&roster, shared_ptr<const RosterSnapshot>(move(next)));  // Callers decide whether it's dirty
+    return true;
 }
 
 void OfficerManager::saveToJson(const string& filename) {
-    ofstream file(filename);
-    if (file.is_open()) {
-        json j = toJson();
-        file << j.dump(4); // Pretty print with 4 spaces
-        file.close();
+    unsigned long long version = state.getVersion();
+    json j = toJson();
+    if (!state.writeFile(filename, j.dump(4), version)) { // Pretty print with 4 spaces
+        cout << "Error saving officers to " << filename << endl;
     }
 }
 
 void OfficerManager::loadFromJson(const string& filename) {
+    FileStamp stamp = FileStamp::of(filename);
     ifstream file(filename);
     if (file.is_open()) {
         json j;
         file >> j;
         fromJson(j);
         file.close();
+        state.markLoaded(filename, stamp);
+        state.clearDirty();
     }
 }
 
@@ -205,13 +281,12 @@ void OfficerManager::save() {
 
 void OfficerManager::load() {
     loadFromJson("officers.json");
-    cout << "Loaded " << officers.size() << " officers from file." << endl;
+    cout << "Loaded " << getOfficerCount() << " officers from file." << endl;
 }
 
 OfficerRegistry* OfficerRegistry::getInstance() {
-    if (instance == nullptr) {
-        instance = new OfficerRegistry();
-    }
+    static once_flag created;
+    call_once(created, []() { instance = new OfficerRegistry(); });
     return instance;
 }
 
@@ -219,9 +294,9 @@ OfficerManager& OfficerRegistry::getManager() {
     return manager;
 }
 
-void displayOfficerTasks(const Officer* officer) {
-    cout << "\nTasks for " << officer->getName() << " (" << officer->getRank() << "):\n";
-    const auto& tasks = officer->getTasks();
+void displayOfficerTasks(const Officer& officer) {
+    cout << "\nTasks for " << officer.getName() << " (" << officer.getRank() << "):\n";
+    const auto& tasks = officer.getTasks();
     if (tasks.empty()) {
         cout << "No tasks assigned.\n";
         return;
@@ -231,9 +306,17 @@ void displayOfficerTasks(const Officer* officer) {
     }
 }
 
-void taskMenu(Officer* officer) {
+// Reads see the current roster snapshot; changes go through updateOfficer()
+void taskMenu(int officerId) {
+    OfficerManager& manager = OfficerRegistry::getInstance()->getManager();
     while (true) {
-        cout << "\nTask Management for " << officer->getName() << "\n";
+        persistChanges();
+        string name;
+        if (!manager.readOfficer(officerId, [&name](const Officer& o) { name = o.getName(); })) {
+            cout << "Officer no longer exists.\n";
+            return;
+        }
+        cout << "\nTask Management for " << name << "\n";
         cout << "1. View Tasks\n";
         cout << "2. Add Task\n";
         cout << "3. Remove Task\n";
@@ -248,25 +331,38 @@ void taskMenu(Officer* officer) {
         
         switch (choice) {
             case 1:
-                displayOfficerTasks(officer);
+                manager.readOfficer(officerId, displayOfficerTasks);
                 break;
             case 2: {
                 string task;
                 cout << "Enter task description: ";
                 cin.ignore();
                 getline(cin, task);
-                officer->addTask(task);
+                manager.updateOfficer(officerId, [&task](Officer& o) { o.addTask(task); });
+                manager.getState().markDirty();
                 cout << "Task added.\n";
                 break;
             }
             case 3: {
-                displayOfficerTasks(officer);
-                if (!officer->getTasks().empty()) {
+                size_t taskCount = 0;
+                manager.readOfficer(officerId, [&](const Officer& o) {
+                    displayOfficerTasks(o);
+                    taskCount = o.getTasks().size();
+                });
+                if (taskCount > 0) {
                     cout << "Enter task number to remove: ";
                     size_t index;
                     cin >> index;
-                    if (index > 0 && index <= officer->getTasks().size()) {
-                        officer->removeTask(index - 1);
+                    bool removed = false;
+                    // Checked again under the lock; the list may have changed meanwhile
+                    manager.updateOfficer(officerId, [&](Officer& o) {
+                        if (index > 0 && index <= o.getTasks().size()) {
+                            o.removeTask(index - 1);
+                            removed = true;
+                        }
+                    });
+                    if (removed) {
+                        manager.getState().markDirty();
                         cout << "Task removed.\n";
                     } else {
                         cout << "Invalid task number.\n";
@@ -275,18 +371,21 @@ void taskMenu(Officer* officer) {
                 break;
             }
             case 4:
-                officer->clearTasks();
+                manager.updateOfficer(officerId, [](Officer& o) { o.clearTasks(); });
+                manager.getState().markDirty();
                 cout << "All tasks cleared.\n";
                 break;
             case 5: {
-                cout << "\nResponsibilities:\n";
-                for (const auto& resp : officer->getResponsibilities()) {
-                    cout << "- " << resp << "\n";
-                }
+                manager.readOfficer(officerId, [](const Officer& o) {
+                    cout << "\nResponsibilities:\n";
+                    for (const auto& resp : o.getResponsibilities()) {
+                        cout << "- " << resp << "\n";
+                    }
+                });
                 break;
             }
             case 6:
-                officer->performDuty();
+                manager.readOfficer(officerId, [](const Officer& o) { o.performDuty(); });
                 break;
             case 7:
                 return;
@@ -299,8 +398,10 @@ void taskMenu(Officer* officer) {
 void officerMenu() {
     OfficerRegistry* registry = OfficerRegistry::getInstance();
     OfficerManager& manager = registry->getManager();
+    refreshChangedData();
     
     while (true) {
+        persistChanges();
         cout << "\nOfficer Management System\n";
         cout << "1. Add Officer\n";
         cout << "2. List Officers\n";
@@ -342,7 +443,6 @@ void officerMenu() {
                 if (officer) {
                     manager.addOfficer(officer);
                     cout << "Officer added with ID: " << officer->getId() << endl;
-                    manager.saveToJson("officers.json");
                 }
                 break;
             }
@@ -355,27 +455,20 @@ void officerMenu() {
                 int id;
                 cin >> id;
                 
-                // Find officer by ID
-                bool found = false;
-                for (const auto* officer : manager.getOfficers()) {
-                    if (officer->getId() == id) {
-                        taskMenu(const_cast<Officer*>(officer));
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
+                if (manager.findOfficer(id)) {
+                    taskMenu(id);
+                } else {
                     cout << "Officer not found.\n";
                 }
                 break;
             }
             case 4:
-                manager.saveToJson("officers.json");
-                cout << "Saved to officers.json\n";
+                persistChanges(true);
+                cout << "Saving to officers.json\n";
                 break;
             case 5:
-                manager.loadFromJson("officers.json");
-                cout << "Loaded from officers.json\n";
+                // Goes through the loader so cases, cells and field agents are relinked
+                reloadModuleData("Officers");
                 break;
             case 6:
                 return;
@@ -388,9 +481,10 @@ void officerMenu() {
 //the vector to go for patrols
 vector<Constable> OfficerManager::getAvailableConstables() const {
     vector<Constable> result;
-    for (const auto* officer : officers) {
+    shared_ptr<const RosterSnapshot> current = snapshot();
+    for (const auto& officer : current->officers) {
         if (officer->getRole() == "Constable") {
-            const Constable* c = static_cast<const Constable*>(officer);
+            const Constable* c = static_cast<const Constable*>(officer.get());
             if (!c->isAssigned()) {
                 result.push_back(*c);
             }
@@ -399,23 +493,27 @@ vector<Constable> OfficerManager::getAvailableConstables() const {
     return result;
 }
 
-//the vector to go for prosecutors in case assign
-vector<Prosecutor*> OfficerManager::getProsecutors() const {
-    vector<Prosecutor*> result;
-    for (const auto* officer : officers) {
-        if (officer->getRole() == "Prosecutor") {
-            result.push_back(const_cast<Prosecutor*>(static_cast<const Prosecutor*>(officer)));
+template <typename T>
+vector<shared_ptr<const T>> OfficerManager::officersWithRole(const string& role) const {
+    vector<shared_ptr<const T>> result;
+    shared_ptr<const RosterSnapshot> current = snapshot();
+    for (const auto& officer : current->officers) {
+        if (officer->getRole() == role) {
+            result.push_back(static_pointer_cast<const T>(officer));
         }
     }
     return result;
 }
 
-vector<HeadConstable*> OfficerManager::getHeadConstables() const {
-    vector<HeadConstable*> result;
-    for (const auto* officer : officers) {
-        if (officer->getRole() == "Head Constable") {
-            result.push_back(const_cast<HeadConstable*>(static_cast<const HeadConstable*>(officer)));
-        }
-    }
-    return result;
-} 
\ No newline at end of file
+//the vector to go for prosecutors in case assign
+vector<shared_ptr<const Prosecutor>> OfficerManager::getProsecutors() const {
+    return officersWithRole<Prosecutor>("Prosecutor");
+}
+
+vector<shared_ptr<const HeadConstable>> OfficerManager::getHeadConstables() const {
+    return officersWithRole<HeadConstable>("Head Constable");
+}
+
+vector<shared_ptr<const CO>> OfficerManager::getCOs() const {
+    return officersWithRole<CO>("CO");
+}
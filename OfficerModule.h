@@ -4,7 +4,13 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
 #include "nlohmann/json.hpp"
+#include "ModuleState.h"
+#include "FlatHashMap.h"
 
 using json = nlohmann::json;
 using namespace std;
@@ -24,7 +30,7 @@ protected:
     vector<string> tasks;
 
 public:
-    static int nextId;  // Static counter for unique IDs
+    static atomic<int> nextId;  // Static counter for unique IDs; officers can be created on any thread
     Officer(string n = "", int i = -1, string r = "") : name(n), rank(r) {
         id = (i == -1) ? nextId++ : i;
     }
@@ -48,6 +54,7 @@ public:
     virtual string getRole() const = 0;
     virtual void performDuty() const = 0;
     virtual vector<string> getResponsibilities() const = 0;
+    virtual Officer* clone() const = 0;  // Roster updates change a copy, never the published officer
     
     // JSON serialization
     virtual json toJson() const {
@@ -62,6 +69,8 @@ public:
     
     // JSON deserialization
     static Officer* fromJson(const json& j);
+    // A new officer with the next ID; nullptr if the role isn't one of the five
+    static Officer* create(const string& role, const string& name);
     
     // Operator Overloading
     bool operator==(const Officer& other) const { return id == other.id; }
@@ -78,6 +87,7 @@ public:
     string getRole() const override { return "SHO"; }
     void performDuty() const override;
     vector<string> getResponsibilities() const override;
+    Officer* clone() const override { return new SHO(*this); }
 };
 
 class CO : public Officer {
@@ -87,6 +97,7 @@ public:
     string getRole() const override { return "CO"; }
     void performDuty() const override;
     vector<string> getResponsibilities() const override;
+    Officer* clone() const override { return new CO(*this); }
 };
 
 class Prosecutor : public Officer {
@@ -96,6 +107,7 @@ public:
     string getRole() const override { return "Prosecutor"; }
     void performDuty() const override;
     vector<string> getResponsibilities() const override;
+    Officer* clone() const override { return new Prosecutor(*this); }
 };
 
 class HeadConstable : public Officer {
@@ -105,6 +117,7 @@ public:
     string getRole() const override { return "Head Constable"; }
     void performDuty() const override;
     vector<string> getResponsibilities() const override;
+    Officer* clone() const override { return new HeadConstable(*this); }
 };
 
 class Constable : public Officer {
@@ -114,6 +127,7 @@ public:
     string getRole() const override { return "Constable"; }
     void performDuty() const override;
     vector<string> getResponsibilities() const override;
+    Officer* clone() const override { return new Constable(*this); }
     bool isAssigned() const { return assignedToPatrol; }
     void setAssigned(bool val) { assignedToPatrol = val; }
     json toJson() const override {
@@ -127,13 +141,37 @@ public:
     }
 };
 
+// One published version of the roster. Nothing in it changes after it is
+// published, so a reader can use it for as long as it holds the pointer.
+struct RosterSnapshot {
+    vector<shared_ptr<const Officer>> officers;  // Roster order
+    FlatHashMap<int, shared_ptr<const Officer>> byId;
+
+    void add(shared_ptr<const Officer> officer);
+    shared_ptr<const Officer> find(int id) const;
+};
+
 // Composition: OfficerManager "has" officers
+// Copy-on-write: readers copy the current snapshot pointer with atomic_load
+// and then work on it unlocked. Writers take writeMutex, build the next
+// snapshot (changing a clone of the officer, not the published one) and swap
+// it in with atomic_store. The load and store are not lock-free: libstdc++
+// guards them with a mutex from a small shared pool, held only for the
+// pointer copy. A reader can wait for that copy, but never for a writer
+// building a snapshot. Cases, cells and field agents keep shared_ptrs to the version they
+// were linked to, so those stay valid across changes and reloads.
+// Other modules call in while holding their own lock, so writeMutex is always
+// taken last and never held while calling into another module.
 class OfficerManager {
-    vector<Officer*> officers;  // Changed to store pointers
-    map<int, Officer*> officerMap;  // Changed to store pointers
+    shared_ptr<const RosterSnapshot> roster;  // Only through atomic_load/atomic_store (short-lock, not lock-free)
+    mutex writeMutex;
+    ModuleState state;  // Loaded/dirty tracking for officers.json
+
+    void publish(shared_ptr<const RosterSnapshot> next);
+    template <typename T> vector<shared_ptr<const T>> officersWithRole(const string& role) const;
 public:
-    ~OfficerManager();
-    void addOfficer(Officer* o);
+    OfficerManager();
+    void addOfficer(Officer* o);  // The roster takes ownership
     void listOfficers();
     void save();
     void load();
@@ -144,21 +182,30 @@ public:
     void saveToJson(const string& filename);
     void loadFromJson(const string& filename);
     
-    // Getter for officers
-    const vector<Officer*>& getOfficers() const { return officers; }
+    // Lookups against the current snapshot: a short lock for the pointer copy, never a wait for a writer
+    shared_ptr<const RosterSnapshot> snapshot() const;
+    size_t getOfficerCount() const;
+    shared_ptr<const Officer> findOfficer(int id) const;
+    json getOfficerJson(int id) const;  // null when there is no such officer
+
+    // Runs `visit` on one officer of the current snapshot; false if the ID is unknown.
+    // updateOfficer() publishes a changed copy (tasks, patrol flag) - callers mark the state dirty.
+    bool readOfficer(int id, const function<void(const Officer&)>& visit) const;
+    bool updateOfficer(int id, const function<void(Officer&)>& change);
 
     // Get all available constables
     vector<Constable> getAvailableConstables() const;
 
     // Get all prosecutors
-    vector<Prosecutor*> getProsecutors() const;
+    vector<shared_ptr<const Prosecutor>> getProsecutors() const;
 
     // Get all head constables
-    vector<HeadConstable*> getHeadConstables() const;
+    vector<shared_ptr<const HeadConstable>> getHeadConstables() const;
+
+    // Get all correctional officers
+    vector<shared_ptr<const CO>> getCOs() const;
 
-    // Public getter for officerMap
-    const map<int, Officer*>& getOfficerMap() const { return officerMap; }
-    map<int, Officer*>& getOfficerMap() { return officerMap; }
+    ModuleState& getState() { return state; }
 };
 
 // Singleton
@@ -1,11 +1,28 @@
 #include "PatrolVehiclesModule.h"
+#include "DataLoader.h"
+#include "PersistenceCoordinator.h"
+#include "SearchIndex.h"
+#include <mutex>
+#include <cctype>
 
-int Vehicle::nextId = 0;
+atomic<int> Vehicle::nextId(0);
 int Patrol::nextPatrolId = 0;
-map<string, Patrol*> Patrol::patrolRegistry;  // Add static member definition
 
 FleetRegistry* FleetRegistry::instance = nullptr;
 
+// Patrol logs are indexed as one document per patrol, keyed by the number in
+// "P12". This builds it when patrols are loaded; new entries are appended.
+static void indexPatrolLogs(const Patrol& p) {
+    int id = Patrol::idNumber(p.getPatrolId());
+    if (id < 0) return;
+    string text;
+    for (const auto& log : p.getLogs()) {
+        text += log;
+        text += '\n';
+    }
+    SearchRegistry::getInstance()->getIndex().indexDocument(DocKind::PatrolLog, id, text);
+}
+
 // Vehicle constructors
 Vehicle::Vehicle() : type(""), year(0), mileage(0.0), engineSize(0.0), numSeats(0), 
     availabilityStatus(true), price(0.0), fuelType("Petrol"), transmissionType("Automatic"), 
@@ -13,14 +30,20 @@ Vehicle::Vehicle() : type(""), year(0), mileage(0.0), engineSize(0.0), numSeats(
     vehicleId = "V" + to_string(++nextId);
 }
 
-Vehicle::Vehicle(string t) : type(t), mileage(0.0), engineSize(0.0), 
-    fuelType("Petrol"), transmissionType("Automatic"), vehicleClass("Standard") {
+Vehicle::Vehicle(string t) : type(t), year(0), mileage(0.0), engineSize(0.0), numSeats(0),
+    price(0.0), fuelType("Petrol"), transmissionType("Automatic"), vehicleClass("Standard") {
     vehicleId = "V" + to_string(++nextId);
     availabilityStatus = true;
 }
 
+Vehicle::Vehicle(const string& t, const string& id) : type(t), vehicleId(id), year(0), mileage(0.0),
+    fuelType("Petrol"), engineSize(0.0), transmissionType("Automatic"), numSeats(0),
+    vehicleClass("Standard"), availabilityStatus(true), price(0.0) {}
+
 Car::Car() : Vehicle("Car") {}
+Car::Car(const string& id) : Vehicle("Car", id) {}
 Bike::Bike() : Vehicle("Bike") {}
+Bike::Bike(const string& id) : Vehicle("Bike", id) {}
 
 // Vehicle operator implementation
 ostream& operator<<(ostream& os, const Vehicle& v) {
@@ -127,6 +150,153 @@ void Bike::fromJson(const json& j) {
     }
 }
 
+// FleetStore
+VehicleKind FleetStore::kindOf(const string& type) {
+    if (type == "Car") return KIND_CAR;
+    if (type == "Bike") return KIND_BIKE;
+    return KIND_VEHICLE;
+}
+
+const char* FleetStore::kindName(VehicleKind kind) {
+    switch (kind) {
+    case KIND_CAR: return "Car";
+    case KIND_BIKE: return "Bike";
+    default: return "Vehicle";
+    }
+}
+
+size_t FleetStore::rowOf(int id) const {
+    auto it = lower_bound(hot.begin(), hot.end(), id,
+        [](const VehicleHot& h, int value) { return h.id < value; });
+    return it != hot.end() && it->id == id ? static_cast<size_t>(it - hot.begin()) : hot.size();
+}
+
+uint16_t FleetStore::internClass(const string& vehicleClass) {
+    auto it = classCodes.find(vehicleClass);
+    if (it != classCodes.end()) return it->second;
+    uint16_t code = static_cast<uint16_t>(classNames.size());
+    classNames.push_back(vehicleClass);
+    classCodes[vehicleClass] = code;
+    return code;
+}
+
+void FleetStore::put(const Vehicle& v) {
+    VehicleKind kind = KIND_VEHICLE;
+    if (dynamic_cast<const Car*>(&v)) kind = KIND_CAR;
+    else if (dynamic_cast<const Bike*>(&v)) kind = KIND_BIKE;
+    else kind = kindOf(v.getType());
+
+    VehicleHot h;
+    h.id = v.getIdNumber();
+    h.kind = kind;
+    h.available = v.getAvailabilityStatus();
+    h.classCode = internClass(v.getVehicleClass());
+    h.mileage = v.getMileage();
+
+    VehicleCold c;
+    c.type = v.getType();
+    c.model = v.getModel();
+    c.color = v.getColor();
+    c.licensePlate = v.getLicensePlate();
+    c.fuelType = v.getFuelType();
+    c.transmissionType = v.getTransmissionType();
+    c.maintenanceHistory = v.getMaintenanceHistory();
+    c.year = v.getYear();
+    c.engineSize = v.getEngineSize();
+    c.numSeats = v.getNumSeats();
+    c.price = v.getPrice();
+
+    // New vehicles get the next ID, so this is almost always an append
+    auto it = lower_bound(hot.begin(), hot.end(), h.id,
+        [](const VehicleHot& x, int value) { return x.id < value; });
+    size_t row = it - hot.begin();
+    if (it != hot.end() && it->id == h.id) {
+        hot[row] = h;
+        cold[row] = move(c);
+    } else {
+        hot.insert(it, h);
+        cold.insert(cold.begin() + row, move(c));
+    }
+}
+
+unique_ptr<Vehicle> FleetStore::vehicleAt(size_t row) const {
+    const VehicleHot& h = hot[row];
+    const VehicleCold& c = cold[row];
+    string id = "V" + to_string(h.id);
+    unique_ptr<Vehicle> v;
+    if (h.kind == KIND_CAR) v.reset(new Car(id));
+    else if (h.kind == KIND_BIKE) v.reset(new Bike(id));
+    else v.reset(new Vehicle(c.type, id));
+    v->setModel(c.model);
+    v->setYear(c.year);
+    v->setColor(c.color);
+    v->setLicensePlate(c.licensePlate);
+    v->setMileage(h.mileage);
+    v->setFuelType(c.fuelType);
+    v->setEngineSize(c.engineSize);
+    v->setTransmissionType(c.transmissionType);
+    v->setNumSeats(c.numSeats);
+    v->setVehicleClass(classNames[h.classCode]);
+    v->setMaintenanceHistory(c.maintenanceHistory);
+    v->setAvailabilityStatus(h.available);
+    v->setPrice(c.price);
+    return v;
+}
+
+unique_ptr<Vehicle> FleetStore::get(int id) const {
+    size_t row = rowOf(id);
+    return row < hot.size() ? vehicleAt(row) : nullptr;
+}
+
+bool FleetStore::isAvailable(int id) const {
+    size_t row = rowOf(id);
+    return row < hot.size() && hot[row].available;
+}
+
+bool FleetStore::setAvailable(int id, bool available) {
+    size_t row = rowOf(id);
+    if (row == hot.size()) return false;
+    hot[row].available = available;
+    return true;
+}
+
+bool FleetStore::setMaintenanceHistory(int id, const string& history) {
+    size_t row = rowOf(id);
+    if (row == hot.size()) return false;
+    cold[row].maintenanceHistory = history;
+    return true;
+}
+
+vector<int> FleetStore::findAvailable(int kind, const string& vehicleClass) const {
+    int classCode = -1;
+    if (!vehicleClass.empty()) {
+        auto it = classCodes.find(vehicleClass);
+        if (it == classCodes.end()) return vector<int>();
+        classCode = it->second;
+    }
+    // Only the hot array is touched
+    vector<const VehicleHot*> matches;
+    for (const VehicleHot& h : hot) {
+        if (!h.available) continue;
+        if (kind >= 0 && h.kind != kind) continue;
+        if (classCode >= 0 && h.classCode != classCode) continue;
+        matches.push_back(&h);
+    }
+    stable_sort(matches.begin(), matches.end(),
+        [](const VehicleHot* a, const VehicleHot* b) { return a->mileage < b->mileage; });
+    vector<int> ids;
+    ids.reserve(matches.size());
+    for (const VehicleHot* h : matches) ids.push_back(h->id);
+    return ids;
+}
+
+void FleetStore::clear() {
+    hot.clear();
+    cold.clear();
+    classNames.clear();
+    classCodes.clear();
+}
+
 // Patrol constructors
 Patrol::Patrol() : vehicleId(0), status("Inactive"), startTime(""), endTime("") {
     patrolId = "P" + to_string(++nextPatrolId);
@@ -177,7 +347,8 @@ void Patrol::fromJson(const json& j) {
         assignedConstables.clear();
         if (j.contains("assignedConstables")) {
             for (const auto& jc : j["assignedConstables"]) {
-                Constable c;
+                // Pass the stored ID so the copy doesn't consume Officer::nextId
+                Constable c("", jc.value("id", 0));
                 c.fromJson(jc);
                 assignedConstables.push_back(c);
             }
@@ -246,26 +417,57 @@ ostream& operator<<(ostream& os, const Patrol& p) {
 }
 
 // PatrolFleet constructors
-// PatrolFleet::PatrolFleet() {}
-const vector<Vehicle>& PatrolFleet::getVehicles() const { return vehicles; }
-vector<Vehicle>& PatrolFleet::getVehicles() { return vehicles; }
+// Flags a constable in the officer roster as on/off patrol.
+// find() rather than operator[] so unknown IDs don't add null officers.
+static void setConstableAssigned(int officerId, bool assigned) {
+    auto& manager = OfficerRegistry::getInstance()->getManager();
+    bool changed = false;
+    manager.updateOfficer(officerId, [&](Officer& o) {
+        if (o.getRole() == "Constable") {
+            static_cast<Constable&>(o).setAssigned(assigned);
+            changed = true;
+        }
+    });
+    if (changed) {
+        manager.getState().markDirty();  // assignedToPatrol is saved in officers.json
+    }
+}
+
+string startPatrol(int vehicleId, const string& area, const vector<Constable>& constables) {
+    // Mark selected constables as assigned
+    for (const auto& c : constables) {
+        setConstableAssigned(c.getId(), true);
+    }
+    string patrolId = FleetRegistry::getInstance()->getFleet().createPatrol(vehicleId, area, constables);
+    if (patrolId.empty()) {
+        // Unassign if patrol creation failed
+        for (const auto& c : constables) {
+            setConstableAssigned(c.getId(), false);
+        }
+    }
+    return patrolId;
+}
 
 // PatrolFleet implementations
 void PatrolFleet::addVehicle(const Vehicle& v) {
-    vehicles.push_back(v);
-    vehicleMap[v.getIdNumber()] = v;
+    unique_lock<shared_mutex> lock(fleetMutex);
+    vehicles.put(v);
+    vehicleState.markDirty();
 }
 
 void PatrolFleet::listVehicles() {
+    shared_lock<shared_mutex> lock(fleetMutex);
     cout << "\n"
          << "╔════════════════════════════════════════════════════════════╗\n"
          << "║                      VEHICLE LIST                          ║\n"
          << "╠════════════════════════════════════════════════════════════╣\n";
-    if (vehicleMap.empty()) {
+    if (vehicles.empty()) {
         cout << "║ No vehicles available" << setw(41) << right << "║\n";
     } else {
-        for (const auto& pair : vehicleMap) {
-            string vehicleInfo = pair.second.getType() + " (ID: " + pair.second.getId() + ")";
+        for (size_t row = 0; row < vehicles.size(); row++) {
+            const VehicleHot& h = vehicles.hotAt(row);
+            string type = h.kind == KIND_VEHICLE ? vehicles.vehicleAt(row)->getType() : FleetStore::kindName(static_cast<VehicleKind>(h.kind));
+            string vehicleInfo = type + " (ID: V" + to_string(h.id) + ")";
             cout << "║ • " << setw(47) << left << vehicleInfo << "║\n";
         }
     }
@@ -273,78 +475,117 @@ void PatrolFleet::listVehicles() {
 }
 
 bool PatrolFleet::searchVehicle(int id) const {
-    return vehicleMap.find(id) != vehicleMap.end();
+    shared_lock<shared_mutex> lock(fleetMutex);
+    return vehicles.contains(id);
 }
 
-const Vehicle& PatrolFleet::getVehicle(int id) const {
-    return vehicleMap.at(id);
+bool PatrolFleet::showVehicle(int id) const {
+    shared_lock<shared_mutex> lock(fleetMutex);
+    unique_ptr<Vehicle> v = vehicles.get(id);
+    if (!v) return false;
+    v->displayInfo();  // Car/Bike version, now that the kind survives storage
+    return true;
 }
 
 bool PatrolFleet::updateVehicleStatus(int id, const string& status) {
-    if (vehicleMap.find(id) != vehicleMap.end()) {
+    unique_lock<shared_mutex> lock(fleetMutex);
+    if (vehicles.contains(id)) {
         if(status == "Available" || status == "available"){
-            vehicleMap[id].setAvailabilityStatus(true);
+            vehicles.setAvailable(id, true);
         }
         else if(status == "Unavailable" || status == "unavailable"){
-            vehicleMap[id].setAvailabilityStatus(false);
+            vehicles.setAvailable(id, false);
         }
         else{
             cout << "Invalid status. Please enter 'Available' or 'Unavailable'." << endl;
             return false;
         }
+        vehicleState.markDirty();
         return true;
     }
     return false;
 }
 
 bool PatrolFleet::updateMaintenanceHistory(int id, const string& history) {
-    if (vehicleMap.find(id) != vehicleMap.end()) {
-        vehicleMap[id].setMaintenanceHistory(history);
+    unique_lock<shared_mutex> lock(fleetMutex);
+    if (vehicles.setMaintenanceHistory(id, history)) {
+        vehicleState.markDirty();
         return true;
     }
     return false;
 }
 
-string PatrolFleet::createPatrol(int vehicleId, const string& area, const vector<Constable>& constables) {
-    if (!searchVehicle(vehicleId)) {
-        return "";
+vector<int> PatrolFleet::findAvailableVehicles(const string& type, const string& vehicleClass) const {
+    shared_lock<shared_mutex> lock(fleetMutex);
+    return vehicles.findAvailable(type.empty() ? -1 : FleetStore::kindOf(type), vehicleClass);
+}
+
+void PatrolFleet::listAvailableVehicles() const {
+    shared_lock<shared_mutex> lock(fleetMutex);
+    vector<int> ids = vehicles.findAvailable();
+    if (ids.empty()) {
+        cout << "No vehicles are available.\n";
+        return;
+    }
+    cout << "Available vehicles (lowest mileage first):\n";
+    for (int id : ids) {
+        unique_ptr<Vehicle> v = vehicles.get(id);
+        cout << "  " << v->getId() << " - " << v->getType() << ", " << v->getModel()
+             << ", " << v->getVehicleClass() << ", " << v->getMileage() << " km\n";
     }
-    if (!vehicleMap[vehicleId].getAvailabilityStatus()) {
-        return "";
+}
+
+string PatrolFleet::createPatrol(int vehicleId, const string& area, const vector<Constable>& constables) {
+    unique_lock<shared_mutex> lock(fleetMutex);
+    if (!vehicles.isAvailable(vehicleId)) {
+        return "";  // Unknown or busy
     }
     string patrolId = "P" + to_string(Patrol::nextPatrolId++);
-    patrols[patrolId] = Patrol(patrolId, area, vehicleId, constables);
-    vehicleMap[vehicleId].setAvailabilityStatus(false);
+    patrols.insert_or_assign(Patrol::idNumber(patrolId), Patrol(patrolId, area, vehicleId, constables));
+    vehicles.setAvailable(vehicleId, false);
+    vehicleState.markDirty();
+    patrolState.markDirty();
     return patrolId;
 }
 
 bool PatrolFleet::endPatrol(const string& patrolId) {
-    if (patrols.find(patrolId) == patrols.end()) {
+    unique_lock<shared_mutex> lock(fleetMutex);
+    auto it = patrols.find(Patrol::idNumber(patrolId));
+    if (it == patrols.end()) {
         return false;
     }
-    Patrol& patrol = patrols[patrolId];
+    Patrol& patrol = it->second;
     patrol.setStatus("Completed");
-    vehicleMap[patrol.getVehicleId()].setAvailabilityStatus(true);
+    vehicles.setAvailable(patrol.getVehicleId(), true);
+    vehicleState.markDirty();
+    patrolState.markDirty();
     return true;
 }
 
 bool PatrolFleet::addPatrolLog(const string& patrolId, const string& logEntry) {
-    if (patrols.find(patrolId) == patrols.end()) {
+    unique_lock<shared_mutex> lock(fleetMutex);
+    auto it = patrols.find(Patrol::idNumber(patrolId));
+    if (it == patrols.end()) {
         return false;
     }
-    patrols[patrolId].addLog(logEntry);
+    it->second.addLog(logEntry);
+    int id = Patrol::idNumber(patrolId);
+    if (id >= 0) SearchRegistry::getInstance()->getIndex().appendToDocument(DocKind::PatrolLog, id, logEntry);
+    patrolState.markDirty();
     return true;
 }
 
 void PatrolFleet::listPatrols() const {
+    shared_lock<shared_mutex> lock(fleetMutex);
     cout << "\n"
          << "╔════════════════════════════════════════════════════════════╗\n"
          << "║                    ACTIVE PATROLS                          ║\n"
          << "╠════════════════════════════════════════════════════════════╣\n";
     bool found = false;
-    for (const auto& pair : patrols) {
-        if (pair.second.getStatus() == "Active") {
-            cout << "║ • " << setw(49) << left << (pair.second.getPatrolId() + " - " + pair.second.getArea()) << "║\n";
+    for (int id : patrols.sortedKeys()) {
+        const Patrol& patrol = patrols.at(id);
+        if (patrol.getStatus() == "Active") {
+            cout << "║ • " << setw(49) << left << (patrol.getPatrolId() + " - " + patrol.getArea()) << "║\n";
             found = true;
         }
     }
@@ -355,22 +596,46 @@ void PatrolFleet::listPatrols() const {
 }
 
 bool PatrolFleet::searchPatrol(const string& patrolId) const {
-    return patrols.find(patrolId) != patrols.end();
+    shared_lock<shared_mutex> lock(fleetMutex);
+    return patrols.count(Patrol::idNumber(patrolId)) > 0;
+}
+
+bool PatrolFleet::showPatrol(const string& patrolId) const {
+    shared_lock<shared_mutex> lock(fleetMutex);
+    auto it = patrols.find(Patrol::idNumber(patrolId));
+    if (it == patrols.end()) return false;
+    it->second.displayInfo();
+    return true;
+}
+
+json PatrolFleet::getPatrolJson(const string& patrolId) const {
+    shared_lock<shared_mutex> lock(fleetMutex);
+    auto it = patrols.find(Patrol::idNumber(patrolId));
+    return it != patrols.end() ? it->second.toJson() : json();
 }
 
-const Patrol& PatrolFleet::getPatrol(const string& patrolId) const {
-    return patrols.at(patrolId);
+vector<Constable> PatrolFleet::getPatrolConstables(const string& patrolId) const {
+    shared_lock<shared_mutex> lock(fleetMutex);
+    auto it = patrols.find(Patrol::idNumber(patrolId));
+    return it != patrols.end() ? it->second.getAssignedConstables() : vector<Constable>();
 }
 
 // PatrolFleet JSON persistence
+json PatrolFleet::vehiclesToJson() const {
+    shared_lock<shared_mutex> lock(fleetMutex);
+    json jArr = json::array();
+    for (size_t row = 0; row < vehicles.size(); row++) {
+        jArr.push_back(vehicles.vehicleAt(row)->toJson());
+    }
+    return jArr;
+}
+
 void PatrolFleet::saveVehiclesToFile(const string& filename) const {
     try {
-        json jArr = json::array();
-        for (const auto& pair : vehicleMap) {
-            jArr.push_back(pair.second.toJson());
+        unsigned long long version = vehicleState.getVersion();
+        if (!vehicleState.writeFile(filename, vehiclesToJson().dump(4), version)) {
+            cout << "Error saving vehicles to " << filename << endl;
         }
-        std::ofstream file(filename);
-        if (file) file << jArr.dump(4);
     } catch (const exception& e) {
         cout << "Error saving vehicles to file: " << e.what() << endl;
     }
@@ -378,37 +643,54 @@ void PatrolFleet::saveVehiclesToFile(const string& filename) const {
 
 void PatrolFleet::loadVehiclesFromFile(const string& filename) {
     try {
+        FileStamp stamp = FileStamp::of(filename);
         ifstream file(filename);
         if (!file) return;
         json jArr;
         file >> jArr;
-        vehicles.clear();
-        vehicleMap.clear();
-        Vehicle::nextId = 0;  // Reset counter
-        for (const auto& jv : jArr) {
-            string type = jv.value("type", "");
-            Vehicle* v = nullptr;
-            if (type == "Car") v = new Car();
-            else if (type == "Bike") v = new Bike();
-            else v = new Vehicle(type);
-            v->fromJson(jv);
-            vehicles.push_back(*v);
-            vehicleMap[v->getIdNumber()] = *v;
-            delete v;
-        }
+        loadVehiclesFromJson(jArr);
+        vehicleState.markLoaded(filename, stamp);
+        vehicleState.clearDirty();
     } catch (const exception& e) {
         cout << "Error loading vehicles from file: " << e.what() << endl;
     }
 }
 
+void PatrolFleet::loadVehiclesFromJson(const json& jArr) {
+    unique_lock<shared_mutex> lock(fleetMutex);
+    vehicles.clear();
+    Vehicle::nextId = 0;  // Reset counter
+    for (const auto& jv : jArr) {
+        string type = jv.value("type", "");
+        Vehicle* v = nullptr;
+        if (type == "Car") v = new Car();
+        else if (type == "Bike") v = new Bike();
+        else v = new Vehicle(type);
+        v->fromJson(jv);
+        vehicles.put(*v);
+        // IDs can have gaps; new vehicles must not reuse a loaded one
+        if (v->getIdNumber() > Vehicle::nextId) {
+            Vehicle::nextId = v->getIdNumber();
+        }
+        delete v;
+    }
+}
+
+json PatrolFleet::patrolsToJson() const {
+    shared_lock<shared_mutex> lock(fleetMutex);
+    json jArr = json::array();
+    for (int id : patrols.sortedKeys()) {
+        jArr.push_back(patrols.at(id).toJson());
+    }
+    return jArr;
+}
+
 void PatrolFleet::savePatrolsToFile(const string& filename) const {
     try {
-        json jArr = json::array();
-        for (const auto& pair : patrols) {
-            jArr.push_back(pair.second.toJson());
+        unsigned long long version = patrolState.getVersion();
+        if (!patrolState.writeFile(filename, patrolsToJson().dump(4), version)) {
+            cout << "Error saving patrols to " << filename << endl;
         }
-        std::ofstream file(filename);
-        if (file) file << jArr.dump(4);
     } catch (const exception& e) {
         cout << "Error saving patrols to file: " << e.what() << endl;
     }
@@ -416,26 +698,68 @@ void PatrolFleet::savePatrolsToFile(const string& filename) const {
 
 void PatrolFleet::loadPatrolsFromFile(const string& filename) {
     try {
+        FileStamp stamp = FileStamp::of(filename);
         std::ifstream file(filename);
         if (!file) return;
         json jArr;
         file >> jArr;
-        patrols.clear();
-        Patrol::clearRegistry();  // Use Patrol's static clear method
-        for (const auto& jp : jArr) {
-            Patrol p;
-            p.fromJson(jp);
-            patrols[p.getPatrolId()] = p;
-            if (p.getPatrolId() != "") {
-                int numId = stoi(p.getPatrolId().substr(1));
-                if (numId >= Patrol::nextPatrolId) {
-                    Patrol::nextPatrolId = numId + 1;
+        loadPatrolsFromJson(jArr);
+        resolvePatrolConstables();
+        patrolState.markLoaded(filename, stamp);
+        patrolState.clearDirty();
+    } catch (const exception& e) {
+        cout << "Error loading patrols from file: " << e.what() << endl;
+    }
+}
+
+void PatrolFleet::loadPatrolsFromJson(const json& jArr) {
+    unique_lock<shared_mutex> lock(fleetMutex);
+    patrols.clear();
+    Patrol::resetIds();
+    SearchRegistry::getInstance()->getIndex().clearKind(DocKind::PatrolLog);
+    for (const auto& jp : jArr) {
+        Patrol p;
+        p.fromJson(jp);
+        patrols.insert_or_assign(Patrol::idNumber(p.getPatrolId()), p);
+        indexPatrolLogs(p);
+        if (p.getPatrolId() != "") {
+            int numId = stoi(p.getPatrolId().substr(1));
+            if (numId >= Patrol::nextPatrolId) {
+                Patrol::nextPatrolId = numId + 1;
+            }
+        }
+    }
+}
+
+// Patrols store constable copies; refresh them from the officer roster and mark
+// constables on active patrols as assigned. Returns how many weren't found.
+size_t PatrolFleet::resolvePatrolConstables() {
+    unique_lock<shared_mutex> lock(fleetMutex);
+    auto& officers = OfficerRegistry::getInstance()->getManager();
+    size_t missing = 0;
+    for (auto& pair : patrols) {
+        Patrol& patrol = pair.second;
+        bool active = patrol.getStatus() == "Active";
+        vector<Constable> linked;
+        for (const auto& c : patrol.getAssignedConstables()) {
+            bool found = false;
+            officers.updateOfficer(c.getId(), [&](Officer& o) {
+                if (o.getRole() != "Constable") return;
+                Constable& rosterConstable = static_cast<Constable&>(o);
+                if (active) {
+                    rosterConstable.setAssigned(true);
                 }
+                linked.push_back(rosterConstable);
+                found = true;
+            });
+            if (!found) {
+                linked.push_back(c);
+                missing++;
             }
         }
-    } catch (const exception& e) {
-        cout << "Error loading patrols from file: " << e.what() << endl;
+        patrol.setAssignedConstables(linked);
     }
+    return missing;
 }
 
 // FleetRegistry constructors
@@ -443,7 +767,8 @@ FleetRegistry::FleetRegistry() {}
 
 // FleetRegistry implementations
 FleetRegistry* FleetRegistry::getInstance() {
-    if (!instance) instance = new FleetRegistry();
+    static once_flag created;
+    call_once(created, []() { instance = new FleetRegistry(); });
     return instance;
 }
 
@@ -453,6 +778,7 @@ PatrolFleet& FleetRegistry::getFleet() { return fleet; }
 void vehicleMenu(PatrolFleet& fleet) {
     int choice;
     do {
+        persistChanges();
         cout << "\n"
              << "╔════════════════════════════════════════════════════════════╗\n"
              << "║                    VEHICLE MANAGEMENT                      ║\n"
@@ -559,9 +885,7 @@ void vehicleMenu(PatrolFleet& fleet) {
             int searchId;
             cout << "Enter vehicle ID to search (e.g., 1, 2, 3): ";
             cin >> searchId;
-            if (fleet.searchVehicle(searchId)) {
-                cout << fleet.getVehicle(searchId) << endl;
-            } else {
+            if (!fleet.showVehicle(searchId)) {
                 cout << "Vehicle not found.\n";
             }
         }
@@ -590,12 +914,11 @@ void vehicleMenu(PatrolFleet& fleet) {
             } else cout << "Vehicle not found.\n";
         }
         else if (choice == 7) {
-            fleet.saveVehiclesToFile("vehicles.json");
-            cout << "Vehicles saved to vehicles.json\n";
+            persistChanges(true);
+            cout << "Saving vehicles to vehicles.json\n";
         }
         else if (choice == 8) {
-            fleet.loadVehiclesFromFile("vehicles.json");
-            cout << "Vehicles loaded from vehicles.json\n";
+            reloadModuleData("Vehicles");
         }
         else if (choice == 9) {
             char confirm;
@@ -611,6 +934,7 @@ void vehicleMenu(PatrolFleet& fleet) {
 void patrolMenu(PatrolFleet& fleet) {
     int choice;
     do {
+        persistChanges();
         cout << "\n"
              << "╔═══════════════════════════════════════════════════════╗\n"
              << "║                    PATROL MANAGEMENT                  ║\n"
@@ -632,6 +956,7 @@ void patrolMenu(PatrolFleet& fleet) {
         if (choice == 1) {
             string vehicleIdStr;
             int vehicleId;
+            fleet.listAvailableVehicles();
             cout << "Enter vehicle ID for patrol (e.g., V1, V2): ";
             cin >> vehicleIdStr;
             
@@ -682,39 +1007,20 @@ void patrolMenu(PatrolFleet& fleet) {
                 continue;
             }
 
-            // Mark selected constables as assigned
-            for (auto& c : selected) {
-                Officer* ptr = officerManager.getOfficerMap()[c.getId()];
-                if (ptr && ptr->getRole() == "Constable")
-                    static_cast<Constable*>(ptr)->setAssigned(true);
-            }
-
-            string patrolId = fleet.createPatrol(vehicleId, area, selected);
+            string patrolId = startPatrol(vehicleId, area, selected);
             if (!patrolId.empty()) {
                 cout << "Patrol created with ID: " << patrolId << endl;
             } else {
                 cout << "Failed to create patrol. Vehicle might not be available or not found.\n";
-                // Unassign if patrol creation failed
-                for (auto& c : selected) {
-                    Officer* ptr = officerManager.getOfficerMap()[c.getId()];
-                    if (ptr && ptr->getRole() == "Constable")
-                        static_cast<Constable*>(ptr)->setAssigned(false);
-                }
             }
         }
         else if (choice == 2) {
-        string patrolId;
-        cout << "Enter patrol ID to end (e.g., P1, P2): ";
-        cin >> patrolId;
-        if (fleet.searchPatrol(patrolId)) {
-                // Unassign all constables in this patrol
-            const Patrol& patrol = fleet.getPatrol(patrolId);
-            auto& officerManager = OfficerRegistry::getInstance()->getManager();
-            for (const auto& c : patrol.getAssignedConstables()) {
-                Officer* ptr = officerManager.getOfficerMap()[c.getId()];
-                if (ptr && ptr->getRole() == "Constable")
-                    static_cast<Constable*>(ptr)->setAssigned(false);
-                }
+            string patrolId;
+            cout << "Enter patrol ID to end (e.g., P1, P2): ";
+            cin >> patrolId;
+            // Unassign all constables in this patrol
+            for (const auto& c : fleet.getPatrolConstables(patrolId)) {
+                setConstableAssigned(c.getId(), false);
             }
             if (fleet.endPatrol(patrolId)) {
                 cout << "Patrol ended successfully.\n";
@@ -742,19 +1048,16 @@ void patrolMenu(PatrolFleet& fleet) {
             string patrolId;
             cout << "Enter patrol ID to search (e.g., P1, P2): ";
             cin >> patrolId;
-            if (fleet.searchPatrol(patrolId)) {
-                fleet.getPatrol(patrolId).displayInfo();
-            } else {
+            if (!fleet.showPatrol(patrolId)) {
                 cout << "Patrol not found.\n";
             }
         }
         else if (choice == 6) {
-            fleet.savePatrolsToFile("patrolling.json");
-            cout << "Patrols saved to patrolling.json\n";
+            persistChanges(true);
+            cout << "Saving patrols to patrolling.json\n";
         }
         else if (choice == 7) {
-            fleet.loadPatrolsFromFile("patrolling.json");
-            cout << "Patrols loaded from patrolling.json\n";
+            reloadModuleData("Patrols");  // Also relinks constables
         }
         else if (choice == 8) {
             char confirm;
@@ -770,14 +1073,12 @@ void patrolMenu(PatrolFleet& fleet) {
 void patrolVehiclesMenu() {
     PatrolFleet& fleet = FleetRegistry::getInstance()->getFleet();
     
-    // Load all data on startup
-    cout << "Loading saved data...\n";
-    fleet.loadVehiclesFromFile("vehicles.json");
-    fleet.loadPatrolsFromFile("patrolling.json");
-    cout << "Data loaded successfully.\n";
+    // Data is loaded at startup; only pick up edits made to the files since then
+    refreshChangedData();
     
     int choice;
     do {
+        persistChanges();
         cout << "\n"
              << "╔══════════════════════════════════════════════════════════╗\n"
              << "║                 PATROL VEHICLES SYSTEM                   ║\n"
@@ -818,9 +1119,7 @@ void patrolVehiclesMenu() {
 
     // Save all data before exiting
     cout << "\nSaving data before exit...\n";
-    fleet.saveVehiclesToFile("vehicles.json");
-    fleet.savePatrolsToFile("patrolling.json");
-    cout << "Data saved successfully.\n";
+    persistChanges(true);
 }
 
 void Vehicle::displayInfo() const {
@@ -838,40 +1137,51 @@ void Bike::displayInfo() const {
     cout << *this << endl;
 }
 
-void PatrolFleet::clearVehicles() {
+void PatrolFleet::clearVehiclesLocked() {
     vehicles.clear();
-    vehicleMap.clear();
     Vehicle::nextId = 0;  // Reset counter
+    vehicleState.markDirty();
     cout << "All vehicles cleared from memory.\n";
 }
 
-void PatrolFleet::clearPatrols() {
+void PatrolFleet::clearVehicles() {
+    unique_lock<shared_mutex> lock(fleetMutex);
+    clearVehiclesLocked();
+}
+
+void PatrolFleet::clearPatrolsLocked() {
     patrols.clear();
-    Patrol::clearRegistry();  // Use Patrol's static clear method
+    Patrol::resetIds();
+    SearchRegistry::getInstance()->getIndex().clearKind(DocKind::PatrolLog);
+    patrolState.markDirty();
     cout << "All patrols cleared from memory.\n";
 }
 
+void PatrolFleet::clearPatrols() {
+    unique_lock<shared_mutex> lock(fleetMutex);
+    clearPatrolsLocked();
+}
+
 void PatrolFleet::clearAllData() {
-    clearVehicles();
-    clearPatrols();
+    unique_lock<shared_mutex> lock(fleetMutex);
+    clearVehiclesLocked();
+    clearPatrolsLocked();
     cout << "All data cleared from memory.\n";
 }
 
 void PatrolFleet::clearFiles(const string& vehiclesFile, const string& patrolsFile) {
     try {
         // Clear vehicles file
-        ofstream vFile(vehiclesFile, ios::trunc);
-        if (vFile.is_open()) {
-            vFile << "[]";  // Write empty JSON array
-            vFile.close();
+        if (writeFileAtomically(vehiclesFile, "[]")) {  // Write empty JSON array
+            vehicleState.markSaved(vehiclesFile);
+            vehicleState.markDirty();  // Memory still holds the vehicles
             cout << "Vehicles file cleared: " << vehiclesFile << "\n";
         }
 
         // Clear patrols file
-        ofstream pFile(patrolsFile, ios::trunc);
-        if (pFile.is_open()) {
-            pFile << "[]";  // Write empty JSON array
-            pFile.close();
+        if (writeFileAtomically(patrolsFile, "[]")) {  // Write empty JSON array
+            patrolState.markSaved(patrolsFile);
+            patrolState.markDirty();  // Memory still holds the patrols
             cout << "Patrols file cleared: " << patrolsFile << "\n";
         }
     } catch (const exception& e) {
@@ -880,12 +1190,14 @@ void PatrolFleet::clearFiles(const string& vehiclesFile, const string& patrolsFi
 }
 
 // Static Patrol methods
-Patrol* Patrol::getPatrolById(const string& id) {
-    auto it = patrolRegistry.find(id);
-    return (it != patrolRegistry.end()) ? it->second : nullptr;
+int Patrol::idNumber(const string& id) {
+    if (id.size() < 2 || id.size() > 10 || id[0] != 'P') return -1;
+    for (size_t i = 1; i < id.size(); i++) {
+        if (!isdigit(static_cast<unsigned char>(id[i]))) return -1;
+    }
+    return stoi(id.substr(1));
 }
 
-void Patrol::clearRegistry() {
-    patrolRegistry.clear();
+void Patrol::resetIds() {
     nextPatrolId = 0;
 } 
@@ -6,7 +6,14 @@
 #include "nlohmann/json.hpp"
 #include <fstream>
 #include <sstream>
+#include <atomic>
+#include <shared_mutex>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
 #include "OfficerModule.h"
+#include "ModuleState.h"
+#include "FlatHashMap.h"
 
 using json = nlohmann::json;
 using namespace std;
@@ -36,10 +43,11 @@ protected:
     double price;
 
 public:
-    static int nextId;  // Static counter for IDs
+    static atomic<int> nextId;  // Static counter for IDs; vehicles are built outside the fleet lock
 
     Vehicle();
     Vehicle(string t);
+    Vehicle(const string& t, const string& id);  // Keeps an existing ID; nextId is left alone
     virtual ~Vehicle() = default;
 
     // Getters
@@ -84,6 +92,7 @@ public:
 class Car : public Vehicle {
 public:
     Car();  // No ID parameter needed
+    explicit Car(const string& id);  // Rebuilt from storage
     json toJson() const override;
     void fromJson(const json& j) override;
     void displayInfo() const override;
@@ -92,11 +101,72 @@ public:
 class Bike : public Vehicle {
 public:
     Bike();  // No ID parameter needed
+    explicit Bike(const string& id);  // Rebuilt from storage
     json toJson() const override;
     void fromJson(const json& j) override;
     void displayInfo() const override;
 };
 
+enum VehicleKind : uint8_t { KIND_VEHICLE = 0, KIND_CAR = 1, KIND_BIKE = 2 };
+
+// The fields dispatch looks at; 16 bytes per vehicle
+struct VehicleHot {
+    int32_t id;          // Number in "V12"
+    uint8_t kind;        // VehicleKind
+    bool available;
+    uint16_t classCode;  // Index into FleetStore's class names
+    double mileage;
+};
+
+// Descriptive fields, only read to show or save a vehicle
+struct VehicleCold {
+    string type;         // Type name for KIND_VEHICLE; "Car"/"Bike" otherwise
+    string model;
+    string color;
+    string licensePlate;
+    string fuelType;
+    string transmissionType;
+    string maintenanceHistory;
+    int year;
+    double engineSize;
+    int numSeats;
+    double price;
+};
+
+// Vehicles split into two parallel arrays sorted by ID: a dense hot one that
+// availability scans walk, and a cold one with the strings. The concrete kind
+// is kept as a tag, and get() rebuilds a Car, Bike or Vehicle from it, so the
+// overridden toJson() and displayInfo() run for stored vehicles.
+class FleetStore {
+private:
+    vector<VehicleHot> hot;
+    vector<VehicleCold> cold;  // Same rows as hot
+    vector<string> classNames;
+    unordered_map<string, uint16_t> classCodes;
+
+    size_t rowOf(int id) const;  // hot.size() if there is no such vehicle
+    uint16_t internClass(const string& vehicleClass);
+
+public:
+    void put(const Vehicle& v);  // Adds the vehicle or replaces the one with its ID
+    bool contains(int id) const { return rowOf(id) < hot.size(); }
+    unique_ptr<Vehicle> get(int id) const;  // nullptr if not found
+    unique_ptr<Vehicle> vehicleAt(size_t row) const;
+    const VehicleHot& hotAt(size_t row) const { return hot[row]; }
+    const string& className(uint16_t code) const { return classNames[code]; }
+    bool isAvailable(int id) const;  // False for unknown IDs too
+    bool setAvailable(int id, bool available);
+    bool setMaintenanceHistory(int id, const string& history);
+    // Available vehicles, lowest mileage first; kind -1 and class "" match any
+    vector<int> findAvailable(int kind = -1, const string& vehicleClass = "") const;
+    size_t size() const { return hot.size(); }
+    bool empty() const { return hot.empty(); }
+    void clear();
+
+    static VehicleKind kindOf(const string& type);
+    static const char* kindName(VehicleKind kind);
+};
+
 class Patrol : public DisplayVehicleInfo {
 private:
     string patrolId;
@@ -109,19 +179,13 @@ private:
     vector<Constable> assignedConstables;
 
 public:
+    // Only changes inside PatrolFleet, under its lock
     static int nextPatrolId;
-    static map<string, Patrol*> patrolRegistry;  // Static registry for all patrols
-    static Patrol* getPatrolById(const string& id);  // Static method to get patrol by ID
-    static void clearRegistry();                     // Static method to clear registry
+    static int idNumber(const string& id);  // 12 for "P12", -1 if it isn't a patrol ID
+    static void resetIds();                 // Numbering starts again from P0
 
     Patrol();
     Patrol(string id, string area, int vehicleId, const vector<Constable>& constables);
-    ~Patrol() {
-        // Remove from registry when destroyed
-        if (!patrolId.empty()) {
-            patrolRegistry.erase(patrolId);
-        }
-    }
     
     // Getters
     string getPatrolId() const { return patrolId; }
@@ -144,23 +208,34 @@ public:
     friend ostream& operator<<(ostream& os, const Patrol& p);
 };
 
+// Thread-safe: queries take fleetMutex shared, changes take it exclusive. The
+// officer roster and the search index are locked after it, never before.
+// Patrols are not handed out by reference (copies would touch the static
+// registry), so callers get JSON, the constables or a printout instead.
 class PatrolFleet {
-    vector<Vehicle> vehicles;
-    map<int, Vehicle> vehicleMap;
-    map<string, Patrol> patrols;  // patrolId -> Patrol
+    FleetStore vehicles;
+    FlatHashMap<int, Patrol> patrols;  // Patrol::idNumber(patrolId) -> Patrol
     static int nextPatrolId;
+    // Loaded/dirty tracking per data file; mutable because the save functions are const
+    mutable ModuleState vehicleState;
+    mutable ModuleState patrolState;
+    mutable shared_mutex fleetMutex;
+
+    void clearVehiclesLocked();
+    void clearPatrolsLocked();
 public:
     PatrolFleet() = default;
     
     // Vehicle management
     void addVehicle(const Vehicle& v);
     void listVehicles();
-    const vector<Vehicle>& getVehicles() const;
-    vector<Vehicle>& getVehicles();
     bool searchVehicle(int id) const;
-    const Vehicle& getVehicle(int id) const;
+    bool showVehicle(int id) const;  // Prints the vehicle; false if not found
     bool updateVehicleStatus(int id, const string& status);
     bool updateMaintenanceHistory(int id, const string& history);
+    // Available vehicles for dispatch, lowest mileage first; "" matches any type or class
+    vector<int> findAvailableVehicles(const string& type = "", const string& vehicleClass = "") const;
+    void listAvailableVehicles() const;
 
     // Patrol management
     string createPatrol(int vehicleId, const string& area, const vector<Constable>& constables);
@@ -168,13 +243,22 @@ public:
     bool addPatrolLog(const string& patrolId, const string& logEntry);
     void listPatrols() const;
     bool searchPatrol(const string& patrolId) const;
-    const Patrol& getPatrol(const string& patrolId) const;
+    bool showPatrol(const string& patrolId) const;  // Prints the patrol; false if not found
+    json getPatrolJson(const string& patrolId) const;  // null when there is no such patrol
+    vector<Constable> getPatrolConstables(const string& patrolId) const;
+    json vehiclesToJson() const;  // As saved in vehicles.json
+    json patrolsToJson() const;   // As saved in patrolling.json
     void saveToFile(const string& filename) const;
     void loadFromFile(const string& filename);
     void saveVehiclesToFile(const string& filename) const;
     void loadVehiclesFromFile(const string& filename);
     void savePatrolsToFile(const string& filename) const;
     void loadPatrolsFromFile(const string& filename);
+    void loadVehiclesFromJson(const json& jArr);
+    void loadPatrolsFromJson(const json& jArr);
+    size_t resolvePatrolConstables();  // Links constables to the officer roster
+    ModuleState& getVehicleState() { return vehicleState; }
+    ModuleState& getPatrolState() { return patrolState; }
 
     // Clear functions
     void clearAllData();
@@ -192,4 +276,8 @@ public:
     PatrolFleet& getFleet();
 };
 
+// Flags the constables as on patrol and creates it; undoes the flags and
+// returns "" if the vehicle is unknown or busy
+string startPatrol(int vehicleId, const string& area, const vector<Constable>& constables);
+
 void patrolVehiclesMenu(); 
\ No newline at end of file
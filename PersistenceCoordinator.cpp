@@ -0,0 +1,154 @@
+#include "PersistenceCoordinator.h"
+#include <iostream>
+using namespace std;
+
+PersistenceCoordinator* PersistenceCoordinator::instance = nullptr;
+const int PersistenceCoordinator::DEFAULT_INTERVAL_SECONDS;
+
+PersistenceCoordinator::PersistenceCoordinator()
+    : interval(chrono::seconds(DEFAULT_INTERVAL_SECONDS)), running(false), stopping(false),
+      flushRequested(false), filesWritten(0), writeErrors(0) {}
+
+PersistenceCoordinator* PersistenceCoordinator::getInstance() {
+    static once_flag created;
+    call_once(created, []() { instance = new PersistenceCoordinator(); });
+    return instance;
+}
+
+void PersistenceCoordinator::start(chrono::milliseconds flushInterval) {
+    if (running) return;
+    targets = DataLoader::sources();
+    interval = flushInterval.count() > 0 ? flushInterval : chrono::milliseconds(1);
+    stopping = false;
+    running = true;
+    flusher = thread(&PersistenceCoordinator::run, this);
+}
+
+void PersistenceCoordinator::capture() {
+    lock_guard<mutex> lock(queueMutex);
+    if (targets.empty()) targets = DataLoader::sources();
+    for (const auto& target : targets) {
+        if (!target.state->isDirty() || pending.count(target.filename)) continue;
+        auto bad = unsavable.find(target.filename);
+        if (bad != unsavable.end() && bad->second == target.state->getVersion()) continue;  // Until it changes again
+        pending[target.filename] = PendingWrite{ target.state, target.snapshot };
+    }
+}
+
+void PersistenceCoordinator::requestFlush() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        flushRequested = true;
+    }
+    wake.notify_one();
+}
+
+void PersistenceCoordinator::discard(const string& filename) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        pending.erase(filename);
+    }
+    lock_guard<mutex> wait(writeMutex);
+}
+
+// Snapshots, serializing and writing all happen here, off the menu and event
+// loop threads; the managers' toJson() holds their shared lock while copying
+void PersistenceCoordinator::writeAll(map<string, PendingWrite>& batch) {
+    lock_guard<mutex> lock(writeMutex);
+    for (auto& entry : batch) {
+        const string& filename = entry.first;
+        PendingWrite& write = entry.second;
+        if (!write.state->isDirty()) continue;  // Written already, or reloaded
+        bool ok = false;
+        bool retry = true;
+        // Read the version first: a change racing the snapshot stays dirty
+        unsigned long long version = write.state->getVersion();
+        try {
+            ok = write.state->writeFile(filename, write.snapshot().dump(4), version);
+        } catch (const exception& e) {
+            cerr << "\nAutosave of " << filename << " failed: " << e.what() << endl;
+            retry = false;  // The data itself can't be saved; trying again won't help
+        }
+
+        lock_guard<mutex> queueLock(queueMutex);
+        if (ok) {
+            filesWritten++;
+        } else {
+            writeErrors++;
+            if (!retry) {
+                unsavable[filename] = version;
+            } else {
+                // Try again next round; a capture since may have queued it already
+                pending.insert(make_pair(filename, write));
+            }
+        }
+    }
+}
+
+void PersistenceCoordinator::run() {
+    unique_lock<mutex> lock(queueMutex);
+    while (true) {
+        wake.wait_for(lock, interval, [this]() { return stopping || flushRequested; });
+        bool last = stopping;
+        flushRequested = false;
+
+        map<string, PendingWrite> batch;
+        batch.swap(pending);
+        if (!batch.empty()) {
+            lock.unlock();
+            writeAll(batch);
+            lock.lock();
+        }
+        if (last) break;
+    }
+}
+
+void PersistenceCoordinator::shutdown() {
+    capture();
+    if (running) {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        flusher.join();
+        running = false;
+    } else {
+        // Never started; write on this thread
+        map<string, PendingWrite> batch;
+        {
+            lock_guard<mutex> lock(queueMutex);
+            batch.swap(pending);
+        }
+        writeAll(batch);
+    }
+}
+
+size_t PersistenceCoordinator::getFilesWritten() {
+    lock_guard<mutex> lock(queueMutex);
+    return filesWritten;
+}
+
+size_t PersistenceCoordinator::getWriteErrors() {
+    lock_guard<mutex> lock(queueMutex);
+    return writeErrors;
+}
+
+void persistChanges(bool flushNow) {
+    PersistenceCoordinator* coordinator = PersistenceCoordinator::getInstance();
+    coordinator->capture();
+    if (flushNow) {
+        coordinator->requestFlush();
+    }
+}
+
+void shutdownPersistence() {
+    cout << "\nSaving changes...\n";
+    PersistenceCoordinator* coordinator = PersistenceCoordinator::getInstance();
+    coordinator->shutdown();
+    cout << coordinator->getFilesWritten() << " file(s) written this session";
+    if (coordinator->getWriteErrors() > 0) {
+        cout << ", " << coordinator->getWriteErrors() << " failed write(s)";
+    }
+    cout << ".\n";
+}
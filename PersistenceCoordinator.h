@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include "DataLoader.h"
+using namespace std;
+
+// Saves module data in the background so menus never wait on the disk.
+// After each operation the caller's capture() queues every dirty module; that
+// is a flag check, not a copy. A flusher thread takes the JSON snapshot of each
+// queued module under the manager's shared lock and writes it every `interval`,
+// or straight away on request and at shutdown, using a temp file and rename().
+// Modules that didn't change are never rewritten, and several changes between
+// flushes cost one snapshot.
+class PersistenceCoordinator {
+    struct PendingWrite {
+        ModuleState* state;
+        function<json()> snapshot;
+    };
+
+    static PersistenceCoordinator* instance;
+    vector<ModuleSource> targets;
+    map<string, PendingWrite> pending;  // filename -> module with changes not written yet
+    map<string, unsigned long long> unsavable;  // filename -> version whose data couldn't be serialized
+    mutex queueMutex;
+    mutex writeMutex;  // Held while the flusher is writing
+    condition_variable wake;
+    thread flusher;
+    chrono::milliseconds interval;
+    bool running;
+    bool stopping;
+    bool flushRequested;
+    size_t filesWritten;
+    size_t writeErrors;
+
+    PersistenceCoordinator();
+    void run();
+    void writeAll(map<string, PendingWrite>& batch);
+
+public:
+    static const int DEFAULT_INTERVAL_SECONDS = 5;
+
+    static PersistenceCoordinator* getInstance();
+
+    void start(chrono::milliseconds flushInterval = chrono::seconds(DEFAULT_INTERVAL_SECONDS));
+    void capture();
+    void requestFlush();
+    // Drops the queued write for `filename` and waits out a write in
+    // progress, so a reload isn't overwritten by the data it replaced
+    void discard(const string& filename);
+    void shutdown();  // Captures and writes everything still dirty, then stops the flusher
+
+    bool isRunning() const { return running; }
+    size_t getFilesWritten();
+    size_t getWriteErrors();
+};
+
+void persistChanges(bool flushNow = false);  // Call from the menus after an operation
+void shutdownPersistence();
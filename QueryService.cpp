@@ -0,0 +1,416 @@
+#include "QueryService.h"
+#include "OfficerModule.h"
+#include "CrimeModule.h"
+#include "ForensicsModule.h"
+#include "PatrolVehiclesModule.h"
+#include "JailModule.h"
+#include "PersistenceCoordinator.h"
+#include <csignal>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+using namespace std;
+
+static json prisonerToJson(const Prisoner& p) {
+    return json{
+        {"id", p.getId()},
+        {"name", p.getName()},
+        {"crime", p.getCrime()},
+        {"sentenceYears", p.getSentenceYears()},
+        {"currentCellId", p.getCurrentCellId()},
+        {"intakeDate", p.getIntakeDate()},
+        {"releaseDate", p.getReleaseDate()},
+        {"caseIds", p.getCaseIds()}
+    };
+}
+
+static json parseBody(const HttpRequest& req) {
+    json body = json::parse(req.body.empty() ? "{}" : req.body);
+    if (!body.is_object()) {
+        throw invalid_argument("request body must be a JSON object");
+    }
+    return body;
+}
+
+static void registerOfficerRoutes(HttpServer& server) {
+    server.route("GET", "/officers", [](const HttpRequest&) {
+        return HttpResponse(200, OfficerRegistry::getInstance()->getManager().toJson()["officers"]);
+    });
+    server.route("GET", "/officers/:id", [](const HttpRequest& req) {
+        json officer = OfficerRegistry::getInstance()->getManager().getOfficerJson(req.intParam("id"));
+        if (officer.is_null()) return HttpResponse::error(404, "officer not found");
+        return HttpResponse(200, officer);
+    });
+    server.route("POST", "/officers", [](const HttpRequest& req) {
+        json body = parseBody(req);
+        string name = body.at("name").get<string>();
+        Officer* officer = Officer::create(body.at("role").get<string>(), name);
+        if (!officer) {
+            return HttpResponse::error(400, "role must be SHO, CO, Prosecutor, Head Constable or Constable");
+        }
+        json added = officer->toJson();  // Before the roster owns it
+        OfficerRegistry::getInstance()->getManager().addOfficer(officer);
+        return HttpResponse(201, added);
+    });
+}
+
+static void registerCaseRoutes(HttpServer& server) {
+    server.route("GET", "/cases", [](const HttpRequest& req) {
+        string type = req.query.count("type") ? req.query.at("type") : "";
+        string city = req.query.count("city") ? req.query.at("city") : "";
+        return HttpResponse(200, CrimeRegistry::getInstance()->getManager().findCasesJson(type, city));
+    });
+    server.route("GET", "/cases/statistics", [](const HttpRequest&) {
+        return HttpResponse(200, CrimeRegistry::getInstance()->getManager().getStatistics().toJson());
+    });
+    server.route("GET", "/cases/:id/prisoners", [](const HttpRequest& req) {
+        int id = req.intParam("id");
+        if (!CrimeRegistry::getInstance()->getManager().hasCase(id)) return HttpResponse::error(404, "case not found");
+        JailRegistry* jails = JailRegistry::getInstance();
+        vector<int> prisonerIds = jails->getPrisonersOf(id);
+        sort(prisonerIds.begin(), prisonerIds.end());
+        json list = json::array();
+        for (int prisonerId : prisonerIds) {
+            Prisoner p;
+            int facility;
+            if (!jails->findPrisoner(prisonerId, p, facility)) continue;
+            json entry = prisonerToJson(p);
+            entry["facility"] = jails->getJail(facility).getName();
+            list.push_back(entry);
+        }
+        return HttpResponse(200, list);
+    });
+    server.route("GET", "/cases/:id", [](const HttpRequest& req) {
+        json c = CrimeRegistry::getInstance()->getManager().getCaseJson(req.intParam("id"));
+        if (c.is_null()) return HttpResponse::error(404, "case not found");
+        return HttpResponse(200, c);
+    });
+    server.route("POST", "/cases", [](const HttpRequest& req) {
+        CrimeManager& crimes = CrimeRegistry::getInstance()->getManager();
+        json body = parseBody(req);
+        // Same shape as a crimes.json entry; a malformed one throws invalid_argument (400)
+        if (!crimes.addCaseFromJson(body)) {
+            return HttpResponse::error(409, "a case with that ID already exists");
+        }
+        crimes.resolveProsecutors();
+        return HttpResponse(201, crimes.getCaseJson(body["id"].get<int>()));
+    });
+    server.route("DELETE", "/cases/:id", [](const HttpRequest& req) {
+        CrimeManager& crimes = CrimeRegistry::getInstance()->getManager();
+        int id = req.intParam("id");
+        if (!crimes.deleteCase(id)) return HttpResponse::error(404, "case not found");
+        return HttpResponse(200, json{ {"deleted", id} });
+    });
+}
+
+static void registerForensicsRoutes(HttpServer& server) {
+    server.route("GET", "/forensics/evidence", [](const HttpRequest&) {
+        json data = ForensicLabRegistry::getInstance()->getLab().toJson();
+        return HttpResponse(200, data.contains("evidences") ? data["evidences"] : json::array());
+    });
+    server.route("GET", "/forensics/evidence/:id", [](const HttpRequest& req) {
+        Evidence ev;
+        if (!ForensicLabRegistry::getInstance()->getLab().findEvidence(req.intParam("id"), ev)) {
+            return HttpResponse::error(404, "evidence not found");
+        }
+        return HttpResponse(200, ev.toJson());
+    });
+    server.route("POST", "/forensics/evidence/:id/processed", [](const HttpRequest& req) {
+        ForensicLab& lab = ForensicLabRegistry::getInstance()->getLab();
+        Evidence ev;
+        if (!lab.findEvidence(req.intParam("id"), ev)) return HttpResponse::error(404, "evidence not found");
+        json body = parseBody(req);
+        if (body.contains("findings")) {
+            ev.addFinding(body["findings"].get<string>());
+        }
+        ev.markProcessed();
+        lab.applyAnalysisResult(ev);
+        return HttpResponse(200, ev.toJson());
+    });
+}
+
+static void registerFleetRoutes(HttpServer& server) {
+    server.route("GET", "/vehicles", [](const HttpRequest&) {
+        return HttpResponse(200, FleetRegistry::getInstance()->getFleet().vehiclesToJson());
+    });
+    server.route("GET", "/vehicles/available", [](const HttpRequest& req) {
+        string type = req.query.count("type") ? req.query.at("type") : "";
+        string vehicleClass = req.query.count("class") ? req.query.at("class") : "";
+        json ids = json::array();
+        for (int id : FleetRegistry::getInstance()->getFleet().findAvailableVehicles(type, vehicleClass)) {
+            ids.push_back("V" + to_string(id));
+        }
+        return HttpResponse(200, ids);
+    });
+    server.route("GET", "/patrols", [](const HttpRequest&) {
+        return HttpResponse(200, FleetRegistry::getInstance()->getFleet().patrolsToJson());
+    });
+    server.route("GET", "/patrols/:id", [](const HttpRequest& req) {
+        json patrol = FleetRegistry::getInstance()->getFleet().getPatrolJson(req.params.at("id"));
+        if (patrol.is_null()) return HttpResponse::error(404, "patrol not found");
+        return HttpResponse(200, patrol);
+    });
+    server.route("POST", "/patrols/:id/logs", [](const HttpRequest& req) {
+        PatrolFleet& fleet = FleetRegistry::getInstance()->getFleet();
+        string entry = parseBody(req).at("entry").get<string>();
+        if (!fleet.addPatrolLog(req.params.at("id"), entry)) return HttpResponse::error(404, "patrol not found");
+        return HttpResponse(200, fleet.getPatrolJson(req.params.at("id")));
+    });
+    server.route("POST", "/patrols/:id/end", [](const HttpRequest& req) {
+        PatrolFleet& fleet = FleetRegistry::getInstance()->getFleet();
+        if (!fleet.endPatrol(req.params.at("id"))) return HttpResponse::error(404, "patrol not found");
+        return HttpResponse(200, fleet.getPatrolJson(req.params.at("id")));
+    });
+}
+
+// Cell IDs repeat across facilities, so cell routes name one: ?facility=<name>,
+// or the first facility. nullptr for an unknown name.
+static Jail* facilityOf(const HttpRequest& req) {
+    JailRegistry* jails = JailRegistry::getInstance();
+    if (!req.query.count("facility")) return &jails->getJail();
+    int facility = jails->findFacility(req.query.at("facility"));
+    return facility >= 0 ? &jails->getJail(facility) : nullptr;
+}
+
+static void registerJailRoutes(HttpServer& server) {
+    server.route("GET", "/jail/cells", [](const HttpRequest& req) {
+        Jail* jail = facilityOf(req);
+        if (!jail) return HttpResponse::error(404, "facility not found");
+        return HttpResponse(200, jail->cellsToJson());
+    });
+    server.route("GET", "/jail/occupancy", [](const HttpRequest& req) {
+        Jail* jail = facilityOf(req);
+        if (!jail) return HttpResponse::error(404, "facility not found");
+        return HttpResponse(200, jail->occupancyToJson());
+    });
+    server.route("GET", "/jail/releases", [](const HttpRequest& req) {
+        // Up to a century ahead; beyond that today + days would overflow
+        int days;
+        if (!req.intQuery("days", 7, days) || days < 1 || days > 36500) {
+            return HttpResponse::error(400, "days must be 1 to 36500");
+        }
+        int today = currentDay();
+        JailRegistry* jails = JailRegistry::getInstance();
+        vector<pair<Prisoner, size_t>> due;  // (prisoner, facility)
+        for (size_t f = 0; f < jails->getFacilityCount(); f++) {
+            for (const Prisoner& p : jails->getJail(f).getReleasesBetween(today, today + days - 1)) {
+                due.push_back(make_pair(p, f));
+            }
+        }
+        // Each facility's list is by date already; merge them into one
+        stable_sort(due.begin(), due.end(), [](const pair<Prisoner, size_t>& a, const pair<Prisoner, size_t>& b) {
+            return a.first.getReleaseDay() < b.first.getReleaseDay();
+        });
+        json list = json::array();
+        for (const auto& entry : due) {
+            json p = prisonerToJson(entry.first);
+            p["facility"] = jails->getJail(entry.second).getName();
+            list.push_back(p);
+        }
+        return HttpResponse(200, list);
+    });
+    server.route("POST", "/jail/releases/process", [](const HttpRequest&) {
+        size_t released = JailRegistry::getInstance()->processReleases(currentDay());
+        return HttpResponse(200, json{ {"released", released} });
+    });
+    server.route("GET", "/jail/prisoners", [](const HttpRequest&) {
+        JailRegistry* jails = JailRegistry::getInstance();
+        json list = json::array();
+        for (size_t f = 0; f < jails->getFacilityCount(); f++) {
+            Jail& jail = jails->getJail(f);
+            json saved = jail.toJson();
+            for (json& p : saved["prisoners"]) {
+                p["facility"] = jail.getName();
+                list.push_back(std::move(p));
+            }
+        }
+        return HttpResponse(200, list);
+    });
+    server.route("GET", "/jail/prisoners/:id", [](const HttpRequest& req) {
+        JailRegistry* jails = JailRegistry::getInstance();
+        Prisoner p;
+        int facility;
+        if (!jails->findPrisoner(req.intParam("id"), p, facility)) {
+            return HttpResponse::error(404, "prisoner not found");
+        }
+        json result = prisonerToJson(p);
+        result["facility"] = jails->getJail(facility).getName();
+        return HttpResponse(200, result);
+    });
+    server.route("GET", "/jail/search", [](const HttpRequest& req) {
+        if (!req.query.count("q")) return HttpResponse::error(400, "q is required");
+        int limit;
+        if (!req.intQuery("limit", 10, limit) || limit < 1) return HttpResponse::error(400, "limit must be 1 or more");
+        JailRegistry* jails = JailRegistry::getInstance();
+        json list = json::array();
+        for (const PrisonerMatch& m : jails->searchPrisoners(req.query.at("q"), static_cast<size_t>(limit))) {
+            json entry = prisonerToJson(m.prisoner);
+            entry["facility"] = jails->getJail(m.facility).getName();
+            entry["score"] = m.score;
+            entry["matchedField"] = m.field;
+            list.push_back(entry);
+        }
+        return HttpResponse(200, list);
+    });
+    server.route("GET", "/jail/prisoners/:id/cases", [](const HttpRequest& req) {
+        int id = req.intParam("id");
+        if (JailRegistry::getInstance()->locatePrisoner(id) < 0) return HttpResponse::error(404, "prisoner not found");
+        vector<int> caseIds = JailRegistry::getInstance()->getCasesOf(id);
+        sort(caseIds.begin(), caseIds.end());
+        json list = json::array();
+        for (int caseId : caseIds) {
+            json c = CrimeRegistry::getInstance()->getManager().getCaseJson(caseId);
+            if (!c.is_null()) list.push_back(c);
+        }
+        return HttpResponse(200, list);
+    });
+    server.route("POST", "/jail/prisoners/:id/cases", [](const HttpRequest& req) {
+        JailRegistry* jails = JailRegistry::getInstance();
+        int id = req.intParam("id");
+        int caseId = parseBody(req).at("caseId").get<int>();
+        if (jails->locatePrisoner(id) < 0) return HttpResponse::error(404, "prisoner not found");
+        if (!CrimeRegistry::getInstance()->getManager().hasCase(caseId)) return HttpResponse::error(404, "case not found");
+        if (!jails->linkCase(id, caseId)) return HttpResponse::error(409, "already linked");
+        return HttpResponse(200, json{ {"prisonerId", id}, {"caseIds", jails->getCasesOf(id)} });
+    });
+    server.route("DELETE", "/jail/prisoners/:id/cases/:caseId", [](const HttpRequest& req) {
+        int id = req.intParam("id");
+        int caseId = req.intParam("caseId");
+        if (!JailRegistry::getInstance()->unlinkCase(id, caseId)) return HttpResponse::error(404, "link not found");
+        return HttpResponse(200, json{ {"prisonerId", id}, {"unlinkedCaseId", caseId} });
+    });
+    server.route("GET", "/jail/facilities", [](const HttpRequest&) {
+        return HttpResponse(200, JailRegistry::getInstance()->facilitiesToJson());
+    });
+    server.route("POST", "/jail/prisoners/:id/transfer", [](const HttpRequest& req) {
+        JailRegistry* jails = JailRegistry::getInstance();
+        int id = req.intParam("id");
+        json body = parseBody(req);
+        int to = jails->findFacility(body.at("facility").get<string>());
+        if (to < 0) return HttpResponse::error(404, "facility not found");
+        if (jails->locatePrisoner(id) < 0) return HttpResponse::error(404, "prisoner not found");
+        if (!jails->transferPrisoner(id, to, body.value("cellId", -1))) {
+            return HttpResponse::error(409, "the prisoner is already there, or the cell is full or doesn't exist");
+        }
+        Prisoner p;
+        jails->getJail(to).findPrisoner(id, p);
+        json result = prisonerToJson(p);
+        result["facility"] = jails->getJail(to).getName();
+        return HttpResponse(200, result);
+    });
+    server.route("POST", "/jail/prisoners", [](const HttpRequest& req) {
+        JailRegistry* jails = JailRegistry::getInstance();
+        json body = parseBody(req);
+        int facility = body.contains("facility") ? jails->findFacility(body["facility"].get<string>()) : 0;
+        if (facility < 0) return HttpResponse::error(404, "facility not found");
+        Jail& jail = jails->getJail(facility);
+        Prisoner prisoner(body.at("id").get<int>(), body.at("name").get<string>(),
+                          body.at("crime").get<string>(), body.at("sentenceYears").get<int>());
+        prisoner.setDates(dayFromDate(body.value("intakeDate", "")), dayFromDate(body.value("releaseDate", "")));
+        prisoner.setCaseIds(body.value("caseIds", vector<int>()));
+        for (int caseId : prisoner.getCaseIds()) {
+            if (!CrimeRegistry::getInstance()->getManager().hasCase(caseId)) {
+                return HttpResponse::error(404, "case " + to_string(caseId) + " not found");
+            }
+        }
+        if (!jail.addPrisoner(prisoner)) return HttpResponse::error(409, "a prisoner with that ID already exists");
+        bool placed = !body.contains("cellId") || jail.assignPrisonerToCell(prisoner.getId(), body["cellId"].get<int>());
+        jail.findPrisoner(prisoner.getId(), prisoner);
+        json result = prisonerToJson(prisoner);
+        result["facility"] = jail.getName();
+        if (!placed) {
+            result["warning"] = "added, but the cell is full or doesn't exist";
+        }
+        return HttpResponse(201, result);
+    });
+    server.route("POST", "/jail/prisoners/:id/cell", [](const HttpRequest& req) {
+        JailRegistry* jails = JailRegistry::getInstance();
+        int id = req.intParam("id");
+        int cellId = parseBody(req).at("cellId").get<int>();
+        if (jails->locatePrisoner(id) < 0) return HttpResponse::error(404, "prisoner not found");
+        if (!jails->changePrisonerCell(id, cellId)) {
+            return HttpResponse::error(409, "the cell is full or doesn't exist");
+        }
+        Prisoner p;
+        int facility;
+        if (!jails->findPrisoner(id, p, facility)) return HttpResponse::error(404, "prisoner not found");
+        json result = prisonerToJson(p);
+        result["facility"] = jails->getJail(facility).getName();
+        return HttpResponse(200, result);
+    });
+    server.route("DELETE", "/jail/prisoners/:id", [](const HttpRequest& req) {
+        int id = req.intParam("id");
+        if (!JailRegistry::getInstance()->removePrisoner(id)) {
+            return HttpResponse::error(404, "prisoner not found");
+        }
+        return HttpResponse(200, json{ {"deleted", id} });
+    });
+}
+
+void registerQueryRoutes(HttpServer& server) {
+    auto started = chrono::steady_clock::now();
+    server.route("GET", "/health", [started](const HttpRequest&) {
+        double uptime = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        return HttpResponse(200, json{ {"status", "ok"}, {"uptimeSeconds", uptime} });
+    });
+    registerOfficerRoutes(server);
+    registerCaseRoutes(server);
+    registerForensicsRoutes(server);
+    registerFleetRoutes(server);
+    registerJailRoutes(server);
+
+    // Same as after a menu operation: queue changed modules for the flusher
+    server.setAfterBatch([]() { persistChanges(); });
+}
+
+static HttpServer* activeServer = nullptr;
+
+static void handleStopSignal(int) {
+    if (activeServer) activeServer->stop();
+}
+
+int runServeMode(const string& host, int port) {
+    HttpServer server;
+    registerQueryRoutes(server);
+    if (!server.listenOn(host, port)) {
+        return 1;
+    }
+    cout << "Serving on http://" << host << ":" << server.getPort() << " (Ctrl+C to stop)\n";
+
+    activeServer = &server;
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+    server.run();
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    activeServer = nullptr;
+
+    cout << "\nServed " << server.getRequestsServed() << " request(s).\n";
+    return 0;
+}
+
+int runLoadTestMode(size_t connections, size_t requests) {
+    HttpServer server;
+    registerQueryRoutes(server);
+    if (!server.listenOn("127.0.0.1", 0)) {
+        return 1;
+    }
+
+    // Read-only mix across the modules, so the data files are left alone
+    vector<string> paths = { "/health", "/cases", "/officers", "/jail/cells", "/vehicles",
+                             "/patrols", "/cases/statistics", "/forensics/evidence" };
+    vector<int> caseIds = CrimeRegistry::getInstance()->getManager().getCaseIds();
+    if (!caseIds.empty()) {
+        paths.push_back("/cases/" + to_string(caseIds.front()));
+    }
+
+    thread serverThread([&server]() { server.run(); });
+    cout << "\nLoad test: " << requests << " GET request(s) over " << connections
+         << " keep-alive connection(s) to 127.0.0.1:" << server.getPort() << "\n";
+    LoadTestResult result = runLoadTest("127.0.0.1", server.getPort(), connections, requests, paths);
+    server.stop();
+    serverThread.join();
+
+    printLoadTestResult(result, cout);
+    return result.errors == 0 ? 0 : 1;
+}
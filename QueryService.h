@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include "HttpServer.h"
+using namespace std;
+
+// JSON endpoints over the registries:
+//   GET    /health
+//   GET    /officers                 GET /officers/:id          POST /officers {name, role}
+//   GET    /cases[?type=&city=]      GET /cases/:id             POST /cases (crimes.json entry)
+//   DELETE /cases/:id                GET /cases/statistics      GET /cases/:id/prisoners
+//   GET    /forensics/evidence       GET /forensics/evidence/:id
+//   POST   /forensics/evidence/:id/processed
+//   GET    /vehicles                 GET /vehicles/available[?type=&class=]
+//   GET    /patrols                  GET /patrols/:id
+//   POST   /patrols/:id/logs {entry} POST /patrols/:id/end
+//   GET    /jail/cells[?facility=]   GET /jail/prisoners        GET /jail/prisoners/:id
+//   GET    /jail/occupancy[?facility=]  GET /jail/releases[?days=7, at most 36500]  POST /jail/releases/process
+//   GET    /jail/facilities          POST /jail/prisoners/:id/transfer {facility[, cellId]}
+//   POST   /jail/prisoners {id, name, crime, sentenceYears[, facility, cellId, intakeDate, releaseDate, caseIds]}
+//   GET    /jail/prisoners/:id/cases POST /jail/prisoners/:id/cases {caseId}
+//   DELETE /jail/prisoners/:id/cases/:caseId
+//   POST   /jail/prisoners/:id/cell {cellId}                    DELETE /jail/prisoners/:id
+//   GET    /jail/search?q=[&limit=10, at least 1]  (fuzzy, over prisoner names and crimes)
+// Prisoner routes, releases and /jail/search cover every facility, and
+// prisoners in the results carry their facility's name. Cell IDs repeat across
+// facilities, so /jail/cells, /jail/occupancy and new prisoners take a facility
+// name and default to the first one.
+// Writes go through the same manager methods as the menus and are saved by
+// the background flusher.
+void registerQueryRoutes(HttpServer& server);
+
+int runServeMode(const string& host, int port);  // Until Ctrl+C
+int runLoadTestMode(size_t connections, size_t requests);
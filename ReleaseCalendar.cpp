@@ -0,0 +1,166 @@
+#include "ReleaseCalendar.h"
+#include <cstdio>
+#include <cctype>
+#include <ctime>
+#include <algorithm>
+using namespace std;
+
+// Days between 1970-01-01 and the given civil date (proleptic Gregorian)
+static int daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void civilFromDays(int z, int& y, int& m, int& d) {
+    z += 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = z - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp + (mp < 10 ? 3 : -9);
+    y = yoe + era * 400 + (m <= 2);
+}
+
+static bool isLeapYear(int y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+int dayFromDate(const string& date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') return NO_DAY;
+    for (size_t i = 0; i < date.size(); i++) {
+        if (i == 4 || i == 7) continue;
+        if (!isdigit(static_cast<unsigned char>(date[i]))) return NO_DAY;
+    }
+    int y = stoi(date.substr(0, 4));
+    int m = stoi(date.substr(5, 2));
+    int d = stoi(date.substr(8, 2));
+    static const int DAYS_IN_MONTH[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (m < 1 || m > 12 || d < 1) return NO_DAY;
+    if (d > DAYS_IN_MONTH[m - 1] + (m == 2 && isLeapYear(y) ? 1 : 0)) return NO_DAY;
+    return daysFromCivil(y, m, d);
+}
+
+string dateFromDay(int day) {
+    if (day == NO_DAY) return "";
+    int y, m, d;
+    civilFromDays(day, y, m, d);
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02d", y, m, d);
+    return buf;
+}
+
+int currentDay() {
+    time_t now = time(nullptr);
+    tm local = *localtime(&now);
+    return daysFromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+int addYears(int day, int years) {
+    int y, m, d;
+    civilFromDays(day, y, m, d);
+    y += years;
+    if (m == 2 && d == 29 && !isLeapYear(y)) d = 28;
+    return daysFromCivil(y, m, d);
+}
+
+void ReleaseCalendar::schedule(int prisonerId, int day) {
+    cancel(prisonerId);
+    if (day == NO_DAY) return;
+    vector<int>& bucket = byDay[day];
+    entries[prisonerId] = Entry{day, static_cast<uint32_t>(bucket.size())};
+    bucket.push_back(prisonerId);
+    if (day < cursor) cursor = day;
+}
+
+bool ReleaseCalendar::cancel(int prisonerId) {
+    auto it = entries.find(prisonerId);
+    if (it == entries.end()) return false;
+    Entry entry = it->second;
+    entries.erase(it);
+
+    // The last prisoner in the bucket takes the cancelled one's place
+    auto bucketIt = byDay.find(entry.day);
+    vector<int>& bucket = bucketIt->second;
+    if (entry.slot + 1 < bucket.size()) {
+        bucket[entry.slot] = bucket.back();
+        entries.at(bucket[entry.slot]).slot = entry.slot;
+    }
+    bucket.pop_back();
+    if (bucket.empty()) byDay.erase(bucketIt);
+    if (entries.empty()) cursor = INT_MAX;
+    return true;
+}
+
+int ReleaseCalendar::dayOf(int prisonerId) const {
+    auto it = entries.find(prisonerId);
+    return it != entries.end() ? it->second.day : NO_DAY;
+}
+
+vector<int> ReleaseCalendar::releasedBetween(int firstDay, int lastDay) const {
+    vector<int> ids;
+    if (firstDay < cursor) firstDay = cursor;
+    if (byDay.empty() || lastDay < firstDay) return ids;
+
+    // A range longer than the number of release days walks the buckets instead
+    if (static_cast<long long>(lastDay) - firstDay >= static_cast<long long>(byDay.size())) {
+        vector<int> days;
+        for (const auto& bucket : byDay) {
+            if (bucket.first >= firstDay && bucket.first <= lastDay) days.push_back(bucket.first);
+        }
+        sort(days.begin(), days.end());
+        for (int day : days) {
+            const vector<int>& bucket = byDay.at(day);
+            ids.insert(ids.end(), bucket.begin(), bucket.end());
+        }
+        return ids;
+    }
+    for (long long day = firstDay; day <= lastDay; day++) {
+        auto it = byDay.find(static_cast<int>(day));
+        if (it != byDay.end()) ids.insert(ids.end(), it->second.begin(), it->second.end());
+    }
+    return ids;
+}
+
+size_t ReleaseCalendar::countDue(int today) const {
+    size_t due = 0;
+    if (today < cursor) return due;
+    for (const auto& bucket : byDay) {
+        if (bucket.first <= today) due += bucket.second.size();
+    }
+    return due;
+}
+
+vector<int> ReleaseCalendar::takeDue(int today, size_t limit) {
+    vector<int> ids;
+    while (ids.size() < limit && !entries.empty() && cursor <= today) {
+        auto it = byDay.find(cursor);
+        if (it == byDay.end()) {
+            cursor++;
+            continue;
+        }
+        vector<int>& bucket = it->second;
+        while (ids.size() < limit && !bucket.empty()) {
+            ids.push_back(bucket.back());
+            entries.erase(bucket.back());
+            bucket.pop_back();
+        }
+        if (bucket.empty()) {
+            byDay.erase(it);
+            cursor++;
+        }
+    }
+    if (entries.empty()) cursor = INT_MAX;
+    return ids;
+}
+
+void ReleaseCalendar::clear() {
+    byDay.clear();
+    entries.clear();
+    cursor = INT_MAX;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "FlatHashMap.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <climits>
+using namespace std;
+
+// Dates are kept as day numbers (days since 1970-01-01) and shown as "YYYY-MM-DD"
+const int NO_DAY = INT_MIN;
+int dayFromDate(const string& date);  // NO_DAY unless it's a valid "YYYY-MM-DD"
+string dateFromDay(int day);          // "" for NO_DAY
+int currentDay();                     // Today, local time
+int addYears(int day, int years);     // Same month and day; Feb 29 becomes Feb 28
+
+// Release dates bucketed by day, one bucket per day that has releases. Like a
+// timing wheel it only ever looks at the days asked about: a range query costs
+// O(min(days, buckets) + results), and takeDue() advances a cursor day by day from the
+// earliest pending release. Buckets live in a hash map rather than a fixed
+// ring, so sentences of any length fit without overflow levels. Each prisoner
+// remembers its bucket and position, so rescheduling and cancelling are O(1).
+class ReleaseCalendar {
+    struct Entry {
+        int day;
+        uint32_t slot;  // Position in byDay[day]
+    };
+
+    FlatHashMap<int, vector<int>> byDay;  // day -> prisoner IDs
+    FlatHashMap<int, Entry> entries;      // prisoner ID -> where it is scheduled
+    int cursor;                           // No releases are pending before this day
+
+public:
+    ReleaseCalendar() : cursor(INT_MAX) {}
+
+    void schedule(int prisonerId, int day);  // Replaces any earlier date; NO_DAY leaves it unscheduled
+    bool cancel(int prisonerId);             // False if the prisoner wasn't scheduled
+    int dayOf(int prisonerId) const;         // NO_DAY if not scheduled
+
+    // Prisoners released on firstDay..lastDay inclusive, by day
+    vector<int> releasedBetween(int firstDay, int lastDay) const;
+    size_t countDue(int today) const;  // Scheduled on or before `today`
+    // Unschedules and returns up to `limit` prisoners due on or before `today`, earliest first
+    vector<int> takeDue(int today, size_t limit);
+
+    size_t size() const { return entries.size(); }
+    void clear();
+};
@@ -0,0 +1,326 @@
+#include "SearchIndex.h"
+#include "CrimeModule.h"
+#include "ForensicsModule.h"
+#include "PatrolVehiclesModule.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+using namespace std;
+
+SearchRegistry* SearchRegistry::instance = nullptr;
+
+string docKindName(DocKind kind) {
+    switch (kind) {
+        case DocKind::Case: return "Case";
+        case DocKind::Evidence: return "Evidence";
+        case DocKind::PatrolLog: return "Patrol Log";
+    }
+    return "Unknown";
+}
+
+vector<string> InvertedIndex::tokenize(const string& text) {
+    vector<string> tokens;
+    string current;
+    for (char ch : text) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (isalnum(c)) {
+            current += static_cast<char>(tolower(c));
+        } else if (!current.empty()) {
+            if (current.size() >= 2) tokens.push_back(current);
+            current.clear();
+        }
+    }
+    if (current.size() >= 2) tokens.push_back(current);
+    return tokens;
+}
+
+void InvertedIndex::removeLocked(DocKind kind, int id) {
+    auto it = liveDocs.find(docKey(kind, id));
+    if (it == liveDocs.end()) return;
+    docs[it->second].live = false;
+    deadDocs++;
+    liveDocs.erase(it);
+}
+
+vector<string> InvertedIndex::documentTerms(const string& text) {
+    vector<string> tokens = tokenize(text);
+    sort(tokens.begin(), tokens.end());
+    tokens.erase(unique(tokens.begin(), tokens.end()), tokens.end());
+    return tokens;
+}
+
+void InvertedIndex::indexDocument(DocKind kind, int id, const string& text) {
+    vector<string> tokens = documentTerms(text);
+
+    lock_guard<mutex> lock(indexMutex);
+    addLocked(kind, id, tokens);
+    if (deadDocs > 1024 && deadDocs * 2 > docs.size()) compactLocked();
+}
+
+void InvertedIndex::indexDocuments(DocKind kind, const vector<pair<int, vector<string>>>& newDocs) {
+    lock_guard<mutex> lock(indexMutex);
+    docs.reserve(docs.size() + newDocs.size());
+    for (const auto& doc : newDocs) {
+        addLocked(kind, doc.first, doc.second);
+    }
+    if (deadDocs > 1024 && deadDocs * 2 > docs.size()) compactLocked();
+}
+
+void InvertedIndex::appendToDocument(DocKind kind, int id, const string& text) {
+    vector<string> tokens = documentTerms(text);
+    if (tokens.empty()) return;
+
+    lock_guard<mutex> lock(indexMutex);
+    auto it = liveDocs.find(docKey(kind, id));
+    if (it == liveDocs.end()) {
+        addLocked(kind, id, tokens);
+        return;
+    }
+    uint32_t docNumber = it->second;
+    for (const auto& token : tokens) {
+        auto termIt = termIds.find(token);
+        if (termIt == termIds.end()) {
+            termIds[token] = static_cast<uint32_t>(postings.size());
+            postings.push_back(vector<uint32_t>(1, docNumber));
+            continue;
+        }
+        // Later documents may already be on the list; keep it sorted
+        vector<uint32_t>& list = postings[termIt->second];
+        auto pos = lower_bound(list.begin(), list.end(), docNumber);
+        if (pos == list.end() || *pos != docNumber) list.insert(pos, docNumber);
+    }
+}
+
+// Replaces whatever (kind, id) had with `tokens`; documentTerms() order
+void InvertedIndex::addLocked(DocKind kind, int id, const vector<string>& tokens) {
+    removeLocked(kind, id);
+    if (tokens.empty()) {
+        return;
+    }
+
+    uint32_t docNumber = static_cast<uint32_t>(docs.size());
+    DocInfo info;
+    info.id = id;
+    info.kind = kind;
+    info.live = true;
+    docs.push_back(info);
+    liveDocs[docKey(kind, id)] = docNumber;
+
+    for (const auto& token : tokens) {
+        auto termIt = termIds.find(token);
+        uint32_t termId;
+        if (termIt == termIds.end()) {
+            termId = static_cast<uint32_t>(postings.size());
+            termIds[token] = termId;
+            postings.push_back(vector<uint32_t>());
+        } else {
+            termId = termIt->second;
+        }
+        postings[termId].push_back(docNumber);
+    }
+}
+
+void InvertedIndex::removeDocument(DocKind kind, int id) {
+    lock_guard<mutex> lock(indexMutex);
+    removeLocked(kind, id);
+}
+
+void InvertedIndex::clearKind(DocKind kind) {
+    lock_guard<mutex> lock(indexMutex);
+    for (auto it = liveDocs.begin(); it != liveDocs.end();) {
+        if (docs[it->second].kind == kind) {
+            docs[it->second].live = false;
+            deadDocs++;
+            it = liveDocs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (deadDocs * 2 > docs.size()) compactLocked();
+}
+
+void InvertedIndex::clear() {
+    lock_guard<mutex> lock(indexMutex);
+    docs.clear();
+    termIds.clear();
+    postings.clear();
+    liveDocs.clear();
+    deadDocs = 0;
+}
+
+// Renumbers the live documents and rebuilds posting lists without dead entries
+void InvertedIndex::compactLocked() {
+    vector<uint32_t> remap(docs.size(), UINT32_MAX);
+    vector<DocInfo> liveList;
+    liveList.reserve(docs.size() - deadDocs);
+    for (size_t i = 0; i < docs.size(); i++) {
+        if (docs[i].live) {
+            remap[i] = static_cast<uint32_t>(liveList.size());
+            liveList.push_back(docs[i]);
+        }
+    }
+
+    for (auto& list : postings) {
+        size_t out = 0;
+        for (uint32_t doc : list) {
+            if (remap[doc] != UINT32_MAX) list[out++] = remap[doc];
+        }
+        list.resize(out);
+        list.shrink_to_fit();
+    }
+    for (auto& pair : liveDocs) {
+        pair.second = remap[pair.second];
+    }
+    docs.swap(liveList);
+    deadDocs = 0;
+}
+
+void InvertedIndex::compact() {
+    lock_guard<mutex> lock(indexMutex);
+    compactLocked();
+}
+
+vector<SearchHit> InvertedIndex::toHits(const vector<uint32_t>& docNumbers, size_t limit) const {
+    vector<SearchHit> hits;
+    for (uint32_t doc : docNumbers) {
+        if (!docs[doc].live) continue;
+        SearchHit hit;
+        hit.kind = docs[doc].kind;
+        hit.id = docs[doc].id;
+        hits.push_back(hit);
+        if (limit > 0 && hits.size() >= limit) break;
+    }
+    return hits;
+}
+
+vector<SearchHit> InvertedIndex::searchAll(const vector<string>& terms, size_t limit) const {
+    lock_guard<mutex> lock(indexMutex);
+    vector<const vector<uint32_t>*> lists;
+    for (const auto& term : terms) {
+        auto it = termIds.find(term);
+        if (it == termIds.end()) return vector<SearchHit>();  // One missing term empties an AND
+        lists.push_back(&postings[it->second]);
+    }
+    if (lists.empty()) return vector<SearchHit>();
+
+    // Start from the shortest list and binary-search the others
+    sort(lists.begin(), lists.end(),
+        [](const vector<uint32_t>* a, const vector<uint32_t>* b) { return a->size() < b->size(); });
+
+    vector<uint32_t> result;
+    vector<size_t> cursor(lists.size(), 0);
+    for (uint32_t doc : *lists[0]) {
+        if (!docs[doc].live) continue;
+        bool inAll = true;
+        for (size_t i = 1; i < lists.size() && inAll; i++) {
+            const vector<uint32_t>& list = *lists[i];
+            auto pos = lower_bound(list.begin() + cursor[i], list.end(), doc);
+            cursor[i] = pos - list.begin();
+            inAll = pos != list.end() && *pos == doc;
+        }
+        if (inAll) {
+            result.push_back(doc);
+            if (limit > 0 && result.size() >= limit) break;
+        }
+    }
+    return toHits(result, limit);
+}
+
+vector<SearchHit> InvertedIndex::searchAny(const vector<string>& terms, size_t limit) const {
+    lock_guard<mutex> lock(indexMutex);
+    vector<uint32_t> merged;
+    for (const auto& term : terms) {
+        auto it = termIds.find(term);
+        if (it == termIds.end()) continue;
+        const vector<uint32_t>& list = postings[it->second];
+        vector<uint32_t> next;
+        next.reserve(merged.size() + list.size());
+        set_union(merged.begin(), merged.end(), list.begin(), list.end(), back_inserter(next));
+        merged.swap(next);
+    }
+    return toHits(merged, limit);
+}
+
+vector<SearchHit> InvertedIndex::query(const string& text, bool matchAll, size_t limit) const {
+    vector<string> terms = tokenize(text);
+    sort(terms.begin(), terms.end());
+    terms.erase(unique(terms.begin(), terms.end()), terms.end());
+    return matchAll ? searchAll(terms, limit) : searchAny(terms, limit);
+}
+
+size_t InvertedIndex::getDocumentCount() const {
+    lock_guard<mutex> lock(indexMutex);
+    return liveDocs.size();
+}
+
+size_t InvertedIndex::getTermCount() const {
+    lock_guard<mutex> lock(indexMutex);
+    return termIds.size();
+}
+
+SearchRegistry* SearchRegistry::getInstance() {
+    static once_flag created;
+    call_once(created, []() { instance = new SearchRegistry(); });
+    return instance;
+}
+
+InvertedIndex& SearchRegistry::getIndex() { return index; }
+
+static void printHit(const SearchHit& hit) {
+    cout << "[" << docKindName(hit.kind) << "] ";
+    if (hit.kind == DocKind::Case) {
+        json c = CrimeRegistry::getInstance()->getManager().getCaseJson(hit.id);
+        if (!c.is_null()) cout << c["type"].get<string>() << " (ID: " << hit.id << ") - " << c.value("description", "") << "\n";
+        else cout << "Case " << hit.id << "\n";
+    } else if (hit.kind == DocKind::Evidence) {
+        Evidence ev;
+        if (ForensicLabRegistry::getInstance()->getLab().findEvidence(hit.id, ev)) cout << ev << "\n";
+        else cout << "Evidence " << hit.id << "\n";
+    } else {
+        string patrolId = "P" + to_string(hit.id);
+        json p = FleetRegistry::getInstance()->getFleet().getPatrolJson(patrolId);
+        cout << patrolId;
+        if (!p.is_null()) {
+            cout << " - " << p["area"].get<string>() << " (" << p["logs"].size() << " log entries)";
+        }
+        cout << "\n";
+    }
+}
+
+void searchMenu() {
+    InvertedIndex& index = SearchRegistry::getInstance()->getIndex();
+    int choice;
+    do {
+        cout << "\n=== Full-Text Search ===\n";
+        cout << "Indexed documents: " << index.getDocumentCount()
+             << " | Distinct terms: " << index.getTermCount() << "\n";
+        cout << "1. Search (all words must match)\n";
+        cout << "2. Search (any word may match)\n";
+        cout << "0. Back\n";
+        cout << "Choice: ";
+        cin >> choice;
+
+        if (choice == 1 || choice == 2) {
+            string text;
+            cout << "Enter keywords: ";
+            cin.ignore();
+            getline(cin, text);
+
+            auto start = chrono::steady_clock::now();
+            vector<SearchHit> hits = index.query(text, choice == 1);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+            cout << "\n" << hits.size() << " result(s) in " << fixed << setprecision(3) << ms << " ms\n";
+            cout.unsetf(ios::floatfield);
+            const size_t shown = 50;
+            for (size_t i = 0; i < hits.size() && i < shown; i++) {
+                printHit(hits[i]);
+            }
+            if (hits.size() > shown) {
+                cout << "... " << hits.size() - shown << " more\n";
+            }
+        }
+    } while (choice != 0);
+}
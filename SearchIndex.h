@@ -0,0 +1,88 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+using namespace std;
+
+// What a search hit points back to
+enum class DocKind { Case = 0, Evidence = 1, PatrolLog = 2 };
+
+struct SearchHit {
+    DocKind kind;
+    int id;  // caseId, evidenceId or numeric part of the patrol ID
+};
+
+string docKindName(DocKind kind);
+
+// In-memory inverted index over free-text fields of the other modules.
+// Documents get an increasing internal number, so every posting list stays
+// sorted just by appending. Updates re-add the document under a new number and
+// mark the old one dead; dead entries are skipped at query time and swept out by
+// compact() once they make up half the index.
+class InvertedIndex {
+private:
+    struct DocInfo {
+        int id;
+        DocKind kind;
+        bool live;
+    };
+
+    vector<DocInfo> docs;                       // internal doc number -> source record
+    unordered_map<string, uint32_t> termIds;
+    vector<vector<uint32_t>> postings;          // termId -> sorted internal doc numbers
+    unordered_map<uint64_t, uint32_t> liveDocs; // (kind, id) -> current doc number
+    size_t deadDocs;
+    mutable mutex indexMutex;
+
+    static uint64_t docKey(DocKind kind, int id) {
+        return (static_cast<uint64_t>(kind) << 32) | static_cast<uint32_t>(id);
+    }
+    void removeLocked(DocKind kind, int id);
+    void addLocked(DocKind kind, int id, const vector<string>& terms);
+    void compactLocked();
+    vector<SearchHit> toHits(const vector<uint32_t>& docNumbers, size_t limit) const;
+
+public:
+    InvertedIndex() : deadDocs(0) {}
+
+    // Lowercased alphanumeric words of two or more characters
+    static vector<string> tokenize(const string& text);
+
+    // Sorted, de-duplicated tokens of a document; callers can prepare these
+    // on their own threads and hand many over with indexDocuments()
+    static vector<string> documentTerms(const string& text);
+
+    // Adds or replaces the document for (kind, id)
+    void indexDocument(DocKind kind, int id, const string& text);
+    void indexDocuments(DocKind kind, const vector<pair<int, vector<string>>>& docs);  // One lock for all
+    // Adds text's terms to the document for (kind, id), creating it if
+    // needed. The document keeps its number, so nothing is left dead and only
+    // the new text is tokenized; for logs that only ever grow.
+    void appendToDocument(DocKind kind, int id, const string& text);
+    void removeDocument(DocKind kind, int id);
+    void clearKind(DocKind kind);
+    void clear();
+
+    // AND: documents containing every term. OR: documents containing any term.
+    vector<SearchHit> searchAll(const vector<string>& terms, size_t limit = 0) const;
+    vector<SearchHit> searchAny(const vector<string>& terms, size_t limit = 0) const;
+    vector<SearchHit> query(const string& text, bool matchAll = true, size_t limit = 0) const;
+
+    void compact();
+    size_t getDocumentCount() const;
+    size_t getTermCount() const;
+};
+
+// Singleton
+class SearchRegistry {
+    static SearchRegistry* instance;
+    InvertedIndex index;  // Composition
+    SearchRegistry() {}
+public:
+    static SearchRegistry* getInstance();
+    InvertedIndex& getIndex();
+};
+
+void searchMenu();
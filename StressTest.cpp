@@ -0,0 +1,326 @@
+#include "StressTest.h"
+#include "OfficerModule.h"
+#include "CrimeModule.h"
+#include "ForensicsModule.h"
+#include "PatrolVehiclesModule.h"
+#include "JailModule.h"
+#include "SearchIndex.h"
+#include "NullStream.h"
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <random>
+#include <chrono>
+#include <iomanip>
+using namespace std;
+
+// Stress cases and prisoners get IDs from here up, one block per thread
+static const int STRESS_ID_BASE = 900000000;
+static const int STRESS_ID_BLOCK = 1000000;
+static const char* const STRESS_TASK = "stress-test task";
+
+// Existing records the readers and writers pick from
+struct StressIds {
+    vector<int> cases;
+    vector<int> officers;
+    vector<int> evidence;
+    vector<int> vehicles;
+    vector<string> patrols;
+    vector<int> prisoners;
+};
+
+static StressIds collectIds() {
+    StressIds ids;
+    ids.cases = CrimeRegistry::getInstance()->getManager().getCaseIds();
+    json roster = OfficerRegistry::getInstance()->getManager().toJson();
+    for (const auto& o : roster["officers"]) {
+        ids.officers.push_back(o["id"]);
+    }
+    json lab = ForensicLabRegistry::getInstance()->getLab().toJson();
+    if (lab.contains("evidences")) {
+        for (const auto& ev : lab["evidences"]) ids.evidence.push_back(ev["id"]);
+    }
+    PatrolFleet& fleet = FleetRegistry::getInstance()->getFleet();
+    for (const auto& v : fleet.vehiclesToJson()) {
+        string id = v.value("vehicleId", "");
+        if (id.size() > 1) ids.vehicles.push_back(stoi(id.substr(1)));
+    }
+    for (const auto& p : fleet.patrolsToJson()) {
+        ids.patrols.push_back(p.value("patrolId", ""));
+    }
+    JailRegistry* jails = JailRegistry::getInstance();
+    for (size_t f = 0; f < jails->getFacilityCount(); f++) {
+        for (const Prisoner& p : jails->getJail(f).getPrisoners()) {
+            ids.prisoners.push_back(p.getId());
+        }
+    }
+    return ids;
+}
+
+template <typename T>
+static const T* pick(const vector<T>& from, mt19937& rng) {
+    return from.empty() ? nullptr : &from[rng() % from.size()];
+}
+
+static void stressRead(const StressIds& ids, mt19937& rng) {
+    static const char* const TYPES[] = { "Theft", "Assault", "Vandalism" };
+    CrimeManager& crimes = CrimeRegistry::getInstance()->getManager();
+    switch (rng() % 8) {
+    case 0:
+        crimes.findCasesJson(TYPES[rng() % 3]);
+        break;
+    case 1:
+        if (const int* id = pick(ids.cases, rng)) crimes.getCaseJson(*id);
+        break;
+    case 2:
+        crimes.getStatistics().toJson();
+        break;
+    case 3: {
+        OfficerManager& officers = OfficerRegistry::getInstance()->getManager();
+        if (const int* id = pick(ids.officers, rng)) officers.getOfficerJson(*id);
+        officers.getAvailableConstables();
+        break;
+    }
+    case 4: {
+        Evidence ev;
+        if (const int* id = pick(ids.evidence, rng)) ForensicLabRegistry::getInstance()->getLab().findEvidence(*id, ev);
+        break;
+    }
+    case 5: {
+        PatrolFleet& fleet = FleetRegistry::getInstance()->getFleet();
+        if (const string* id = pick(ids.patrols, rng)) fleet.getPatrolJson(*id);
+        if (const int* id = pick(ids.vehicles, rng)) fleet.searchVehicle(*id);
+        break;
+    }
+    case 6: {
+        JailRegistry* jails = JailRegistry::getInstance();
+        Prisoner p;
+        int facility;
+        if (const int* id = pick(ids.prisoners, rng)) jails->findPrisoner(*id, p, facility);
+        jails->getJail(rng() % jails->getFacilityCount()).cellsToJson();
+        break;
+    }
+    default:
+        SearchRegistry::getInstance()->getIndex().query("stress report", true, 20);
+        break;
+    }
+}
+
+// Changes that keep the data bounded: stress cases and prisoners come and go,
+// officer tasks are added and taken off again
+static void stressWrite(const StressIds& ids, mt19937& rng, int& nextId, deque<int>& liveCases, deque<int>& livePrisoners) {
+    static const char* const TYPES[] = { "Theft", "Assault", "Vandalism", "Fraud" };
+    static const char* const CITIES[] = { "Lahore", "Karachi", "Islamabad" };
+    JailRegistry* jails = JailRegistry::getInstance();
+    Jail& jail = jails->getJail(rng() % jails->getFacilityCount());  // Where new prisoners go
+    int numCells = jail.getNumHighSecCells() + jail.getNumStandardCells();
+
+    switch (rng() % 6) {
+    case 0: {
+        CrimeManager& crimes = CrimeRegistry::getInstance()->getManager();
+        if (liveCases.size() < 16) {
+            int id = nextId++;
+            json c = {
+                {"id", id},
+                {"type", TYPES[rng() % 4]},
+                {"severity", 1.0 + rng() % 9},
+                {"description", "stress report " + to_string(id)},
+                {"location", { {"address", "1 Test Road"}, {"city", CITIES[rng() % 3]}, {"state", "Punjab"} }}
+            };
+            if (crimes.addCaseFromJson(c)) liveCases.push_back(id);
+        } else {
+            crimes.deleteCase(liveCases.front());
+            liveCases.pop_front();
+        }
+        break;
+    }
+    case 1:
+        if (livePrisoners.size() < 4) {
+            int id = nextId++;
+            Prisoner prisoner(id, "Stress Inmate", "theft", 1);
+            if (!liveCases.empty()) prisoner.setCaseIds(vector<int>(1, liveCases.back()));  // Dropped when the case goes
+            if (jail.addPrisoner(prisoner)) {
+                livePrisoners.push_back(id);
+                jail.assignPrisonerToCell(id, 1 + rng() % numCells);  // May be full
+            }
+        } else {
+            jails->removePrisoner(livePrisoners.front());
+            livePrisoners.pop_front();
+        }
+        break;
+    case 2:
+        // Moves within whichever facility holds the prisoner, or to another one
+        if (!livePrisoners.empty()) {
+            int id = livePrisoners[rng() % livePrisoners.size()];
+            if (jails->getFacilityCount() > 1 && rng() % 4 == 0) {
+                jails->transferPrisoner(id, rng() % jails->getFacilityCount(), rng() % 2 ? -1 : 1 + rng() % numCells);
+            } else {
+                jails->changePrisonerCell(id, 1 + rng() % numCells);
+            }
+        }
+        break;
+    case 3:
+        if (const int* id = pick(ids.officers, rng)) {
+            OfficerManager& officers = OfficerRegistry::getInstance()->getManager();
+            officers.updateOfficer(*id, [](Officer& o) { o.addTask(STRESS_TASK); });
+            officers.updateOfficer(*id, [](Officer& o) {
+                const vector<string>& tasks = o.getTasks();
+                for (size_t i = 0; i < tasks.size(); i++) {
+                    if (tasks[i] == STRESS_TASK) {
+                        o.removeTask(i);
+                        break;
+                    }
+                }
+            });
+        }
+        break;
+    case 4: {
+        PatrolFleet& fleet = FleetRegistry::getInstance()->getFleet();
+        if (const int* id = pick(ids.vehicles, rng)) {
+            fleet.updateVehicleStatus(*id, rng() % 2 ? "Available" : "Unavailable");
+        }
+        if (rng() % 8 == 0) {
+            if (const string* id = pick(ids.patrols, rng)) fleet.addPatrolLog(*id, "stress log entry");
+        }
+        break;
+    }
+    default: {
+        ForensicLab& lab = ForensicLabRegistry::getInstance()->getLab();
+        Evidence ev;
+        const int* id = pick(ids.evidence, rng);
+        if (id && lab.findEvidence(*id, ev)) {
+            ev.setFindings("stress check " + to_string(rng() % 100));
+            lab.applyAnalysisResult(ev);
+        }
+        break;
+    }
+    }
+}
+
+// Counters and indexes maintained on every change must still match the data
+static bool checkConsistency() {
+    bool ok = true;
+    CrimeManager& crimes = CrimeRegistry::getInstance()->getManager();
+    if (crimes.getStatistics().getTotalCases() != static_cast<int>(crimes.getCaseCount())) {
+        cerr << "Statistics count " << crimes.getStatistics().getTotalCases()
+             << " != case count " << crimes.getCaseCount() << "\n";
+        ok = false;
+    }
+    for (const SearchHit& hit : SearchRegistry::getInstance()->getIndex().query("stress report")) {
+        if (hit.kind == DocKind::Case) {
+            cerr << "Deleted stress case " << hit.id << " is still in the search index\n";
+            ok = false;
+        }
+    }
+
+    JailRegistry* jails = JailRegistry::getInstance();
+    for (size_t f = 0; f < jails->getFacilityCount(); f++) {
+        Jail& jail = jails->getJail(f);
+        int seated = 0;
+        json saved = jail.toJson();
+        for (const auto& p : saved["prisoners"]) {
+            if (p["id"].get<int>() >= STRESS_ID_BASE) {
+                cerr << jail.getName() << ": stress prisoner " << p["id"] << " was left behind\n";
+                ok = false;
+            }
+            if (p["currentCellId"].get<int>() != -1) seated++;
+        }
+        int occupancy = 0;
+        for (const auto& cell : jail.cellsToJson()) {
+            occupancy += cell["occupancy"].get<int>();
+            if (cell["occupancy"].get<int>() > cell["capacity"].get<int>()) {
+                cerr << jail.getName() << ": cell " << cell["id"] << " is over capacity\n";
+                ok = false;
+            }
+        }
+        if (occupancy != seated) {
+            cerr << jail.getName() << ": cells hold " << occupancy << " prisoner(s) but " << seated << " have a cell\n";
+            ok = false;
+        }
+        if (jail.getHousedPrisonerCount() != occupancy) {
+            cerr << jail.getName() << ": occupancy counters say " << jail.getHousedPrisonerCount()
+                 << " housed, cells hold " << occupancy << "\n";
+            ok = false;
+        }
+    }
+    size_t held = 0;
+    size_t linked = 0;
+    for (size_t i = 0; i < jails->getFacilityCount(); i++) {
+        for (const Prisoner& p : jails->getJail(i).getPrisoners()) {
+            held++;
+            linked += p.getCaseIds().size();
+        }
+    }
+    if (jails->getPrisonerCount() != held) {
+        cerr << "Prisoner directory lists " << jails->getPrisonerCount() << " prisoner(s), facilities hold " << held << "\n";
+        ok = false;
+    }
+    if (jails->getCaseLinkCount() != linked) {
+        cerr << "Case link index has " << jails->getCaseLinkCount() << " link(s), prisoners carry " << linked << "\n";
+        ok = false;
+    }
+    return ok;
+}
+
+StressResult runStressTest(size_t threads, size_t opsPerThread) {
+    StressResult result;
+    result.threads = threads;
+    StressIds ids = collectIds();
+    mutex totalsMutex;
+
+    NullBuffer sink;
+    streambuf* console = cout.rdbuf(&sink);
+    auto start = chrono::steady_clock::now();
+
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.push_back(thread([&, t]() {
+            mt19937 rng(static_cast<unsigned>(t * 7919 + 17));
+            int nextId = STRESS_ID_BASE + static_cast<int>(t) * STRESS_ID_BLOCK;
+            deque<int> liveCases, livePrisoners;
+            size_t reads = 0, writes = 0;
+            for (size_t i = 0; i < opsPerThread; i++) {
+                if (rng() % 100 < 80) {
+                    stressRead(ids, rng);
+                    reads++;
+                } else {
+                    stressWrite(ids, rng, nextId, liveCases, livePrisoners);
+                    writes++;
+                }
+            }
+            for (int id : liveCases) CrimeRegistry::getInstance()->getManager().deleteCase(id);
+            for (int id : livePrisoners) JailRegistry::getInstance()->removePrisoner(id);
+
+            lock_guard<mutex> lock(totalsMutex);
+            result.reads += reads;
+            result.writes += writes;
+        }));
+    }
+    for (auto& w : workers) w.join();
+
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.rdbuf(console);
+    result.consistent = checkConsistency();
+    return result;
+}
+
+void printStressResult(const StressResult& result, ostream& os) {
+    size_t total = result.reads + result.writes;
+    os << "\n=== Registry Stress Test ===\n";
+    os << "Threads:     " << result.threads << "\n";
+    os << "Operations:  " << total << " (" << result.reads << " reads, " << result.writes << " writes)\n";
+    os << fixed << setprecision(3);
+    os << "Time:        " << result.seconds << " s\n";
+    os << setprecision(0);
+    os << "Throughput:  " << (result.seconds > 0 ? total / result.seconds : 0.0) << " ops/s\n";
+    os.unsetf(ios::floatfield);
+    os << "Consistency: " << (result.consistent ? "OK" : "FAILED") << "\n";
+}
+
+int runStressMode(size_t threads, size_t opsPerThread) {
+    cout << "\nStress test: " << threads << " thread(s) x " << opsPerThread
+         << " operation(s), about 80% reads. Nothing is saved.\n";
+    StressResult result = runStressTest(threads, opsPerThread);
+    printStressResult(result, cout);
+    return result.consistent ? 0 : 1;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <iostream>
+using namespace std;
+
+struct StressResult {
+    size_t threads;
+    size_t reads;
+    size_t writes;
+    double seconds;
+    bool consistent;  // Cross-checks between the managers' own structures held afterwards
+
+    StressResult() : threads(0), reads(0), writes(0), seconds(0.0), consistent(false) {}
+};
+
+// Hammers every registry with a random mix of queries (~80%) and changes
+// (~20%) from `threads` threads at once, then checks that counters and indexes
+// still agree with the data. Meant to be run under -fsanitize=thread as well.
+// Changes use IDs far above the real ones and nothing is saved to disk.
+StressResult runStressTest(size_t threads, size_t opsPerThread);
+void printStressResult(const StressResult& result, ostream& os);
+
+int runStressMode(size_t threads, size_t opsPerThread);
@@ -0,0 +1,117 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+using namespace std;
+
+// Blocking FIFO with a fixed capacity. push() waits while the queue is full and
+// pop() waits while it is empty, so a fast producer can never run away from a
+// slow consumer. close() wakes everybody up; pop() then drains what is left.
+template<typename T>
+class BoundedQueue {
+private:
+    queue<T> items;
+    size_t capacity;
+    bool closed;
+    mutable mutex queueMutex;
+    condition_variable notFull;
+    condition_variable notEmpty;
+
+public:
+    explicit BoundedQueue(size_t cap = 64) : capacity(cap > 0 ? cap : 1), closed(false) {}
+
+    bool push(T item) {
+        unique_lock<mutex> lock(queueMutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Returns false once the queue is closed and fully drained
+    bool pop(T& out) {
+        unique_lock<mutex> lock(queueMutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        out = std::move(items.front());
+        items.pop();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        lock_guard<mutex> lock(queueMutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+    size_t size() const {
+        lock_guard<mutex> lock(queueMutex);
+        return items.size();
+    }
+    size_t getCapacity() const { return capacity; }
+};
+
+// Fixed-size pool of worker threads fed from a bounded task queue
+class ThreadPool {
+private:
+    vector<thread> workers;
+    BoundedQueue<function<void()>> tasks;
+
+    void workerLoop() {
+        function<void()> task;
+        while (tasks.pop(task)) {
+            task();
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t numThreads = defaultThreadCount(), size_t queueCapacity = 1024)
+        : tasks(queueCapacity) {
+        if (numThreads == 0) numThreads = 1;
+        for (size_t i = 0; i < numThreads; i++) {
+            workers.push_back(thread(&ThreadPool::workerLoop, this));
+        }
+    }
+
+    ~ThreadPool() { shutdown(); }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Fire-and-forget; blocks while the task queue is full
+    bool submit(function<void()> task) { return tasks.push(std::move(task)); }
+
+    // Submit a task and get a future for its result
+    template<typename F>
+    future<typename result_of<F()>::type> enqueue(F f) {
+        typedef typename result_of<F()>::type R;
+        shared_ptr<packaged_task<R()>> task = make_shared<packaged_task<R()>>(f);
+        future<R> result = task->get_future();
+        tasks.push([task]() { (*task)(); });
+        return result;
+    }
+
+    // Finishes the queued tasks, then joins all workers
+    void shutdown() {
+        tasks.close();
+        for (auto& w : workers) {
+            if (w.joinable()) w.join();
+        }
+        workers.clear();
+    }
+
+    size_t size() const { return workers.size(); }
+
+    static size_t defaultThreadCount() {
+        unsigned int n = thread::hardware_concurrency();
+        return n > 0 ? n : 2;
+    }
+};
@@ -0,0 +1,238 @@
+#include "TrigramIndex.h"
+#include <cctype>
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+static uint32_t packTrigram(unsigned char a, unsigned char b, unsigned char c) {
+    return (static_cast<uint32_t>(a) << 16) | (static_cast<uint32_t>(b) << 8) | c;
+}
+
+vector<string> TrigramIndex::wordsOf(const string& text) {
+    vector<string> words;
+    string word;
+    for (char ch : text) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (isalnum(c)) {
+            word += static_cast<char>(tolower(c));
+        } else if (!word.empty()) {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+    if (!word.empty()) words.push_back(word);
+    sort(words.begin(), words.end());
+    words.erase(unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+vector<uint32_t> TrigramIndex::trigramsOf(const string& text) {
+    vector<uint32_t> trigrams;
+    for (const string& word : wordsOf(text)) {
+        string padded = "  " + word + " ";
+        for (size_t i = 0; i + 2 < padded.size(); i++) {
+            trigrams.push_back(packTrigram(padded[i], padded[i + 1], padded[i + 2]));
+        }
+    }
+    sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+uint32_t TrigramIndex::termIdFor(const string& word) {
+    auto it = termIds.find(word);
+    if (it != termIds.end()) return it->second;
+    uint32_t termId = static_cast<uint32_t>(terms.size());
+    vector<uint32_t> trigrams = trigramsOf(word);
+    terms.push_back(Term{word, static_cast<uint32_t>(trigrams.size()), {}});
+    termIds[word] = termId;
+    for (uint32_t t : trigrams) {
+        termsByTrigram[t].push_back(termId);
+    }
+    return termId;
+}
+
+void TrigramIndex::add(int id, const string& text) {
+    remove(id);
+    uint32_t docNumber = static_cast<uint32_t>(docs.size());
+    Doc doc = {id, static_cast<uint32_t>(docTerms.size()), 0, true};
+    for (const string& word : wordsOf(text)) {
+        uint32_t termId = termIdFor(word);
+        docTerms.push_back(termId);
+        terms[termId].docs.push_back(docNumber);
+        doc.termCount++;
+    }
+    docs.push_back(doc);
+    liveDocs[id] = docNumber;
+}
+
+void TrigramIndex::remove(int id) {
+    auto it = liveDocs.find(id);
+    if (it == liveDocs.end()) return;
+    docs[it->second].live = false;
+    liveDocs.erase(it);
+    deadDocs++;
+    if (deadDocs > 1024 && deadDocs * 2 > docs.size()) {
+        rebuild();
+    }
+}
+
+void TrigramIndex::clear() {
+    docs.clear();
+    docTerms.clear();
+    termIds.clear();
+    terms.clear();
+    termsByTrigram.clear();
+    liveDocs.clear();
+    deadDocs = 0;
+}
+
+// Re-adds the live texts in order, which drops dead docs and unused words
+void TrigramIndex::rebuild() {
+    vector<pair<int, string>> live;
+    live.reserve(liveDocs.size());
+    for (const Doc& doc : docs) {
+        if (!doc.live) continue;
+        string text;
+        for (uint32_t i = 0; i < doc.termCount; i++) {
+            text += terms[docTerms[doc.firstTerm + i]].word;
+            text += ' ';
+        }
+        live.push_back(make_pair(doc.id, text));
+    }
+    clear();
+    for (const auto& entry : live) {
+        add(entry.first, entry.second);
+    }
+}
+
+// Vocabulary words scoring at least minScore against `word`, closest first
+vector<pair<uint32_t, double>> TrigramIndex::closeTerms(const string& word, double minScore) const {
+    vector<pair<uint32_t, double>> close;
+    vector<uint32_t> trigrams = trigramsOf(word);
+    if (trigrams.empty()) return close;
+
+    static const vector<uint32_t> none;
+    vector<const vector<uint32_t>*> lists;
+    lists.reserve(trigrams.size());
+    for (uint32_t t : trigrams) {
+        auto it = termsByTrigram.find(t);
+        lists.push_back(it != termsByTrigram.end() ? &it->second : &none);
+    }
+    sort(lists.begin(), lists.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) {
+        return a->size() < b->size();
+    });
+
+    // Jaccard <= shared / |word|, so a close word shares at least minShared
+    // trigrams and is in at least one of the `prefix` rarest lists
+    size_t q = trigrams.size();
+    size_t minShared = max<size_t>(1, static_cast<size_t>(ceil(minScore * q - 1e-9)));
+    if (minShared > q) return close;
+    size_t prefix = q - minShared + 1;
+
+    FlatHashMap<uint32_t, uint32_t> shared;
+    for (size_t i = 0; i < prefix; i++) {
+        for (uint32_t termId : *lists[i]) shared[termId]++;
+    }
+    for (const auto& candidate : shared) {
+        size_t count = candidate.second;
+        for (size_t i = prefix; i < q && count + (q - i) >= minShared; i++) {
+            if (binary_search(lists[i]->begin(), lists[i]->end(), candidate.first)) count++;
+        }
+        if (count < minShared) continue;
+        double score = static_cast<double>(count) / (q + terms[candidate.first].trigrams - count);
+        if (score >= minScore) close.push_back(make_pair(candidate.first, score));
+    }
+    sort(close.begin(), close.end(), [](const pair<uint32_t, double>& a, const pair<uint32_t, double>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return close;
+}
+
+vector<TrigramIndex::Match> TrigramIndex::search(const string& query, size_t limit, double minScore) const {
+    vector<Match> matches;
+    vector<string> words = wordsOf(query);
+    if (words.empty() || liveDocs.empty()) return matches;
+    if (limit == 0) limit = liveDocs.size();
+
+    struct QueryWord {
+        vector<pair<uint32_t, double>> close;  // Closest first
+        FlatHashMap<uint32_t, double> similarity;
+        size_t docCount;
+    };
+    size_t n = words.size();
+    vector<QueryWord> query_(n);
+    for (size_t i = 0; i < n; i++) {
+        query_[i].close = closeTerms(words[i], minScore);
+        query_[i].docCount = 0;
+        for (const auto& c : query_[i].close) {
+            query_[i].similarity.emplace(c.first, c.second);
+            query_[i].docCount += terms[c.first].docs.size();
+        }
+    }
+    // Rarest first: its texts are the fewest to walk before the bound drops
+    sort(query_.begin(), query_.end(), [](const QueryWord& a, const QueryWord& b) { return a.docCount < b.docCount; });
+
+    auto scoreOf = [&](const Doc& doc) {
+        double total = 0;
+        for (const QueryWord& w : query_) {
+            double best = 0;
+            for (uint32_t i = 0; i < doc.termCount; i++) {
+                auto it = w.similarity.find(docTerms[doc.firstTerm + i]);
+                if (it != w.similarity.end() && it->second > best) best = it->second;
+            }
+            total += best;
+        }
+        return total / n;
+    };
+
+    // Min-heap of the best so far: worst score, then latest doc, on top
+    typedef pair<double, uint32_t> Ranked;  // (score, doc number)
+    auto worse = [](const Ranked& a, const Ranked& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    };
+    vector<Ranked> best;
+    best.reserve(limit + 1);
+    FlatHashMap<uint32_t, bool> seen;
+
+    // laterBest[i]: the most words after i can add to a text's score
+    vector<double> laterBest(n, 0.0);
+    for (size_t i = n - 1; i > 0; i--) {
+        double top = query_[i].close.empty() ? 0.0 : query_[i].close.front().second;
+        laterBest[i - 1] = laterBest[i] + top;
+    }
+
+    bool done = false;
+    for (size_t i = 0; i < n && !done; i++) {
+        for (const auto& c : query_[i].close) {
+            // A text first reached here has none of the words before i and at
+            // most this similarity for word i
+            double bound = (c.second + laterBest[i]) / n;
+            if (bound < minScore || (best.size() == limit && best.front().first >= bound)) {
+                done = true;
+                break;
+            }
+            for (uint32_t d : terms[c.first].docs) {
+                if (best.size() == limit && best.front().first >= bound) break;
+                if (!docs[d].live || !seen.emplace(d, true).second) continue;
+                double score = scoreOf(docs[d]);
+                if (score < minScore) continue;
+                Ranked r(score, d);
+                if (best.size() < limit) {
+                    best.push_back(r);
+                    push_heap(best.begin(), best.end(), worse);
+                } else if (worse(r, best.front())) {
+                    pop_heap(best.begin(), best.end(), worse);
+                    best.back() = r;
+                    push_heap(best.begin(), best.end(), worse);
+                }
+            }
+        }
+    }
+
+    sort_heap(best.begin(), best.end(), worse);
+    for (const Ranked& r : best) {
+        matches.push_back(Match{docs[r.second].id, r.first});
+    }
+    return matches;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "FlatHashMap.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+using namespace std;
+
+// Fuzzy lookup of short texts (names, crimes) by shared trigrams. Each word
+// is padded like "  word " and cut into overlapping three-letter pieces, so a
+// misspelt or partial word still shares most of its trigrams with the real
+// one. Two words score the Jaccard similarity of their trigram sets; a text
+// scores the average, over the query's words, of its best-matching word.
+//
+// Names repeat a lot, so trigrams index the distinct words (the vocabulary)
+// rather than every text, and each word keeps the texts it appears in. A query
+// first finds the close words for each of its own words, then walks their
+// texts starting from its rarest word and closest matches, and stops as soon
+// as nothing left unseen could beat the current top results.
+//
+// Like InvertedIndex, texts get increasing internal numbers so lists stay
+// sorted by appending; replaced and removed texts are marked dead and swept
+// out by a rebuild once they are half the index. Not thread-safe; the owner
+// locks around it.
+class TrigramIndex {
+public:
+    struct Match {
+        int id;
+        double score;  // 0..1; 1 when every query word is in the text
+    };
+
+private:
+    struct Doc {
+        int id;
+        uint32_t firstTerm;  // Into docTerms
+        uint32_t termCount;
+        bool live;
+    };
+    struct Term {
+        string word;
+        uint32_t trigrams;      // Distinct trigrams in the word
+        vector<uint32_t> docs;  // Sorted doc numbers, dead ones included
+    };
+
+    vector<Doc> docs;                 // internal doc number -> record
+    vector<uint32_t> docTerms;        // Each doc's distinct term IDs, back to back
+    unordered_map<string, uint32_t> termIds;
+    vector<Term> terms;
+    FlatHashMap<uint32_t, vector<uint32_t>> termsByTrigram;  // trigram -> sorted term IDs
+    FlatHashMap<int, uint32_t> liveDocs;                     // id -> current doc number
+    size_t deadDocs;
+
+    static vector<string> wordsOf(const string& text);
+    uint32_t termIdFor(const string& word);
+    vector<pair<uint32_t, double>> closeTerms(const string& word, double minScore) const;
+    void rebuild();
+
+public:
+    TrigramIndex() : deadDocs(0) {}
+
+    // Sorted, distinct trigrams of the lowercased alphanumeric words in text
+    static vector<uint32_t> trigramsOf(const string& text);
+
+    void add(int id, const string& text);  // Replaces any earlier text for id
+    void remove(int id);
+    void clear();
+
+    // Best `limit` matches scoring at least minScore, best first. Texts with
+    // the same score come back in the order they were added.
+    vector<Match> search(const string& query, size_t limit = 10, double minScore = 0.3) const;
+
+    size_t size() const { return liveDocs.size(); }
+    size_t vocabularySize() const { return terms.size(); }
+};
@@ -4,138 +4,28 @@
 #include "ForensicsModule.h"
 #include "PatrolVehiclesModule.h"
 #include "JailModule.h"
+#include "SearchIndex.h"
+#include "DataLoader.h"
+#include "PersistenceCoordinator.h"
+#include "QueryService.h"
+#include "StressTest.h"
+#include "BatchMode.h"
+#include "CaseImport.h"
+#include "MapBenchmark.h"
+#include "OccupancySimulator.h"
+#include "CaseLinkBackfill.h"
 #include <string>
 #include <vector>
 #include <map>
 #include <fstream>
 #include <iomanip>
+#include <cstring>
+#include <cstdlib>
 #include "nlohmann/json.hpp"
 
 using json = nlohmann::json;
 using namespace std;
 
-// bool fileExists(const string& filename) {
-//     ifstream file(filename);
-//     return file.good();
-// }
-
-// void loadAllData() {
-//     cout << "\nLoading system data...\n";
-    
-//     try {
-//         cout << "Loading officers... ";
-//         // Load officers
-//         if (fileExists("officers.json")) {
-//             auto& officerManager = OfficerRegistry::getInstance()->getManager();
-//             officerManager.load();
-//             cout << "Done\n";
-//         } else {
-//             cout << "No officers file found\n";
-//         }
-        
-//         cout << "Loading vehicles... ";
-//         // Load vehicles and patrols
-//         auto& fleet = FleetRegistry::getInstance()->getFleet();
-//         if (fileExists("vehicles.json")) {
-//             fleet.loadVehiclesFromFile("vehicles.json");
-//             cout << "Done\n";
-//         } else {
-//             cout << "No vehicles file found\n";
-//         }
-        
-//         cout << "Loading patrols... ";
-//         if (fileExists("patrolling.json")) {
-//             fleet.loadPatrolsFromFile("patrolling.json");
-//             cout << "Done\n";
-//         } else {
-//             cout << "No patrols file found\n";
-//         }
-        
-//         cout << "Loading crime data... ";
-//         // Load crime data
-//         if (fileExists("crimes.json")) {
-//             auto& crimeManager = CrimeRegistry::getInstance()->getManager();
-//             crimeManager.load();
-//             cout << "Done\n";
-//         } else {
-//             cout << "No crime data file found\n";
-//         }
-        
-//         cout << "Loading forensics data... ";
-//         // Load forensics data
-//         if (fileExists("forensics_data.json")) {
-//             auto& forensicsLab = ForensicLabRegistry::getInstance()->getLab();
-//             forensicsLab.load();
-//             cout << "Done\n";
-//         } else {
-//             cout << "No forensics data file found\n";
-//         }
-        
-//         cout << "Loading jail data... ";
-//         // Load jail data
-//         if (fileExists("jail_data.json")) {
-//             auto& jail = JailRegistry::getInstance()->getJail();
-//             jail.load();
-//             cout << "Done\n";
-//         } else {
-//             cout << "No jail data file found\n";
-//         }
-        
-//         cout << "All data loaded successfully.\n";
-//     } catch (const exception& e) {
-//         cout << "\nError loading data: " << e.what() << endl;
-//         cout << "Error occurred during load operation. Some data may not have been loaded.\n";
-//     } catch (...) {
-//         cout << "\nUnknown error occurred during load operation.\n";
-//         cout << "Some data may not have been loaded.\n";
-//     }
-// }
-
-// void saveAllData() {
-//     cout << "\nSaving system data...\n";
-    
-//     try {
-//         cout << "Saving freeloaders... ";
-//         // Save officers
-//         auto& officerManager = OfficerRegistry::getInstance()->getManager();
-//         officerManager.save();
-//         cout << "Done\n";
-        
-//         cout << "Saving vehicles and patrols... ";
-//         // Save vehicles and patrols
-//         auto& fleet = FleetRegistry::getInstance()->getFleet();
-//         fleet.saveVehiclesToFile("vehicles.json");
-//         fleet.savePatrolsToFile("patrolling.json");
-//         cout << "Done\n";
-        
-//         cout << "Saving crime reports to make new spider homes... ";
-//         // Save crime data
-//         auto& crimeManager = CrimeRegistry::getInstance()->getManager();
-//         crimeManager.save();
-//         cout << "Done\n";
-        
-//         cout << "Saving forensics data, cz why not take peoples privacy in name of law and order... ";
-//         // Save forensics data
-//         auto& forensicsLab = ForensicLabRegistry::getInstance()->getLab();
-//         forensicsLab.save();
-//         cout << "Done\n";
-        
-//         cout << "Throw- i mean, saving real indeed criminals in jail... ";
-//         // Save jail data
-//         auto& jail = JailRegistry::getInstance()->getJail();
-//         jail.save();
-//         cout << "Done\n";
-        
-//         cout << "All data saved successfully.\n";
-//     } catch (const exception& e) {
-//         cout << "\nError saving data: " << e.what() << endl;
-//         cout << "Error occurred during save operation. Some data may not have been saved.\n";
-//     } catch (...) {
-//         cout << "\nUnknown error occurred during save operation.\n";
-//         cout << "Some data may not have been saved.\n";
-//     }
-// }
-
 void displayMainMenu() {
     cout << "\n"
          << "╔══════════════════════════════════════════════════════════╗\n"
@@ -146,33 +36,182 @@ void displayMainMenu() {
          << "║ 3. Forensics Management                                  ║\n"
          << "║ 4. Patrol Vehicles Management                            ║\n"
          << "║ 5. Jail Management                                       ║\n"
+         << "║ 6. Full-Text Search                                      ║\n"
          << "║ 0. Exit                                                  ║\n"
          << "╠══════════════════════════════════════════════════════════╣\n"
          << "║ Choice: ";
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Command line options:
+    //   --flush-interval <seconds>  how often changed data is written in the background
+    //   --serve [--host <ip>] [--port <n>]  HTTP/JSON service instead of the menus
+    //   --loadtest [--connections <n>] [--requests <n>]  benchmark the service on localhost
+    //   --stress [--threads <n>] [--ops <n>]  concurrent reads/writes on the registries; saves nothing
+    //   --batch <file|-> [--group <n>]  run JSON-lines operations instead of the menus
+    //   --import <file> [--threads <n>]  bulk-load cases from CSV or JSONL, then exit
+    //   --bench-maps [--entries <n>]  time the ID index maps up to n entries, then exit
+    //   --simulate [--trials <n>] [--cells <n>] [--cell-capacity <n>] [--high-sec-cells <n>]
+    //              [--high-sec-capacity <n>] [--high-sec-share <0-1>] [--days <n>] [--warmup <days>]
+    //              [--arrivals <per day>] [--arrival-process poisson|constant|bursty]
+    //              [--burst-probability <0-1>] [--burst-factor <x>] [--sentence-days <mean>]
+    //              [--sentence-dist fixed|exponential|lognormal|uniform] [--sentence-sigma <s>]
+    //              [--seed <n>] [--threads <n>]
+    //              Monte Carlo occupancy of a planned facility, then exit
+    //   --backfill-case-links [--threads <n>]  link prisoners to cases from their crime text, then exit
+    int flushSeconds = PersistenceCoordinator::DEFAULT_INTERVAL_SECONDS;
+    bool serve = false;
+    bool loadTest = false;
+    string host = "127.0.0.1";
+    int port = 8080;
+    size_t connections = 4;
+    size_t requests = 20000;
+    bool stress = false;
+    size_t threads = 0;  // --stress defaults to 8, --import and --backfill-case-links to one per core
+    size_t stressOps = 5000;
+    string batchFile;
+    size_t batchGroup = 10000;
+    string importFile;
+    bool benchMaps = false;
+    size_t benchEntries = 10000000;
+    bool simulate = false;
+    bool backfillLinks = false;
+    SimulationConfig simConfig;
+    simConfig.trials = 10000;
+    simConfig.arrivalsPerDay = 110.0;
+    int simCells = 5000;
+    int simCellCapacity = 4;
+    int simHighSecCells = 1000;
+    int simHighSecCapacity = 2;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--flush-interval") == 0 && hasValue) {
+            flushSeconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--serve") == 0) {
+            serve = true;
+        } else if (strcmp(argv[i], "--host") == 0 && hasValue) {
+            host = argv[++i];
+        } else if (strcmp(argv[i], "--port") == 0 && hasValue) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--loadtest") == 0) {
+            loadTest = true;
+        } else if (strcmp(argv[i], "--connections") == 0 && hasValue) {
+            connections = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--requests") == 0 && hasValue) {
+            requests = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--stress") == 0) {
+            stress = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threads = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--ops") == 0 && hasValue) {
+            stressOps = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--batch") == 0 && hasValue) {
+            batchFile = argv[++i];
+        } else if (strcmp(argv[i], "--group") == 0 && hasValue) {
+            batchGroup = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--import") == 0 && hasValue) {
+            importFile = argv[++i];
+        } else if (strcmp(argv[i], "--bench-maps") == 0) {
+            benchMaps = true;
+        } else if (strcmp(argv[i], "--entries") == 0 && hasValue) {
+            benchEntries = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--backfill-case-links") == 0) {
+            backfillLinks = true;
+        } else if (strcmp(argv[i], "--simulate") == 0) {
+            simulate = true;
+        } else if (strcmp(argv[i], "--trials") == 0 && hasValue) {
+            simConfig.trials = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--cells") == 0 && hasValue) {
+            simCells = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cell-capacity") == 0 && hasValue) {
+            simCellCapacity = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--days") == 0 && hasValue) {
+            simConfig.days = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && hasValue) {
+            simConfig.warmupDays = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--arrivals") == 0 && hasValue) {
+            simConfig.arrivalsPerDay = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--sentence-days") == 0 && hasValue) {
+            simConfig.meanSentenceDays = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--high-sec-cells") == 0 && hasValue) {
+            simHighSecCells = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--high-sec-capacity") == 0 && hasValue) {
+            simHighSecCapacity = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--high-sec-share") == 0 && hasValue) {
+            simConfig.highSecurityShare = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--arrival-process") == 0 && hasValue) {
+            if (!arrivalProcessFromName(argv[++i], simConfig.arrivals)) {
+                cout << "--arrival-process must be poisson, constant or bursty" << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--burst-probability") == 0 && hasValue) {
+            simConfig.burstProbability = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--burst-factor") == 0 && hasValue) {
+            simConfig.burstFactor = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--sentence-dist") == 0 && hasValue) {
+            if (!sentenceDistributionFromName(argv[++i], simConfig.sentences)) {
+                cout << "--sentence-dist must be fixed, exponential, lognormal or uniform" << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--sentence-sigma") == 0 && hasValue) {
+            simConfig.sentenceSigma = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            simConfig.seed = strtoull(argv[++i], nullptr, 10);
+        } else {
+            cout << "Unknown option: " << argv[i] << endl;
+            return 1;
+        }
+    }
+
+    if (benchMaps) {
+        return runMapBenchmarkMode(benchEntries);  // Synthetic data; nothing to load
+    }
+    if (simulate) {
+        simConfig.threads = threads;
+        return runSimulationMode(simConfig, simHighSecCells, simHighSecCapacity, simCells, simCellCapacity);
+    }
+
+    int status = 0;
     try {
         // Load all data on startup
-        //loadAllData();
+        loadAllData();
+        if (stress) {
+            // Its changes are throwaway, so the flusher never starts
+            return runStressMode(threads > 0 ? threads : 8, stressOps);
+        }
+        PersistenceCoordinator::getInstance()->start(chrono::seconds(flushSeconds > 0 ? flushSeconds : 1));
         
-        int choice;
-        do {
-            displayMainMenu();
-            cin >> choice;
-            cout << "╚══════════════════════════════════════════════════════════╝\n";
-            
-            switch(choice) {
-                case 1: officerMenu(); break;
-                case 2: crimeMenu(); break;
-                case 3: forensicsMenu(); break;
-                case 4: patrolVehiclesMenu(); break;
-                case 5: jailMenu(); break;
-            }
-        } while(choice != 0);
+        if (serve) {
+            status = runServeMode(host, port);
+        } else if (loadTest) {
+            status = runLoadTestMode(connections > 0 ? connections : 1, requests);
+        } else if (!batchFile.empty()) {
+            status = runBatchMode(batchFile, batchGroup > 0 ? batchGroup : 1);
+        } else if (!importFile.empty()) {
+            status = runImportMode(importFile, threads > 0 ? threads : ThreadPool::defaultThreadCount());
+        } else if (backfillLinks) {
+            status = runCaseLinkBackfillMode(threads > 0 ? threads : ThreadPool::defaultThreadCount());
+        } else {
+            int choice;
+            do {
+                persistChanges();
+                displayMainMenu();
+                cin >> choice;
+                cout << "╚══════════════════════════════════════════════════════════╝\n";
+                
+                switch(choice) {
+                    case 1: officerMenu(); break;
+                    case 2: crimeMenu(); break;
+                    case 3: forensicsMenu(); break;
+                    case 4: patrolVehiclesMenu(); break;
+                    case 5: jailMenu(); break;
+                    case 6: searchMenu(); break;
+                }
+            } while(choice != 0);
+        }
         
-        // Save all data before exiting
-        //saveAllData();
+        // Write whatever is still dirty before exiting
+        shutdownPersistence();
         
     } catch (const exception& e) {
         cout << "Error: " << e.what() << endl;
@@ -182,5 +221,5 @@ int main() {
         return 1;
     }
     
-    return 0;
+    return status;
 } 